@@ -35,17 +35,60 @@ extern "C"
     /**
      * @ingroup kra_imp
      *
-     * @brief Sets custom memory allocation and deallocation functions for kra_imp's xml parsing.
+     * @brief Sets custom memory allocation and deallocation functions for kra_imp.
      *
      * @details
      * This function allows the user to provide custom memory allocation and deallocation
-     * functions that will be used by the kra_imp library for xml parsing dynamic memory operations.
+     * functions that will be used by the kra_imp library for its dynamic memory operations: xml parsing,
+     * archive, document and stream handles, and their internal tables and buffers.
      * This setting is global and affects all subsequent allocations performed by the library.
+     * Passing nullptr for either function restores malloc and free. The allocation function may return nullptr,
+     * in which case the failing call returns KRA_IMP_FAIL, or nullptr for functions returning handles.
      *
      * @param[in] allocation_function   Pointer to a function that allocates memory (like malloc).
      * @param[in] deallocation_function Pointer to a function that deallocates memory (like free).
+     *
+     * @note When the zip library is built along with kra_imp, its reader and decompression state use these functions too,
+     * and only its archive handle is allocated with calloc. An installed zip library allocates everything with malloc.
+     * The functions must not be changed while any object created by the library is still alive.
      */
     KRA_IMP_API void kra_imp_set_memory_functions(kra_imp_allocation_function allocation_function, kra_imp_deallocation_function deallocation_function);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Sets custom memory allocation and deallocation functions receiving a user context.
+     *
+     * @details
+     * Works like `kra_imp_set_memory_functions`, but passes `context` to every call, so allocations can be routed
+     * to an arena, e.g. a per-thread one looked up through the context. When every object created by the library
+     * has been closed, an arena can be discarded as a whole.
+     *
+     * @param[in] allocation_function   Pointer to a function that allocates memory.
+     * @param[in] deallocation_function Pointer to a function that deallocates memory.
+     * @param[in] context               User pointer passed to both functions.
+     *
+     * @note Memory must be aligned like memory returned by malloc. The same restrictions as for `kra_imp_set_memory_functions` apply.
+     */
+    KRA_IMP_API void kra_imp_set_memory_functions_with_context(kra_imp_context_allocation_function allocation_function,
+                                                               kra_imp_context_deallocation_function deallocation_function, void* context);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Sets a scratch buffer used for xml parsing on the calling thread.
+     *
+     * @details
+     * Functions which parse an xml buffer and discard it before returning (`kra_imp_read_main_doc`, `kra_imp_read_image_layer`,
+     * `kra_imp_read_image_layers`, `kra_imp_get_image_key_frames_count` and `kra_imp_read_image_key_frame`) bump-allocate
+     * their memory from the scratch buffer, which is rewound at the start of each call. Allocations which do not fit
+     * fall back to the memory functions. A buffer of a few pages of 32 KiB avoids heap allocations for typical documents.
+     * `kra_imp_open_document` never uses the scratch buffer, because the document outlives the call.
+     *
+     * @param[in] scratch_buffer Buffer to allocate from, or nullptr to stop using a scratch buffer.
+     * @param[in] scratch_buffer_size Size of the buffer in bytes.
+     *
+     * @note The setting is per thread. The buffer must stay valid until it is replaced or removed.
+     */
+    KRA_IMP_API void kra_imp_set_scratch_buffer(char* scratch_buffer, const unsigned long long scratch_buffer_size);
     /**
      * @ingroup kra_imp
      *
@@ -61,6 +104,23 @@ extern "C"
      * @return Pointer to the opened KRA archive on success, or nullptr on failure.
      */
     KRA_IMP_API kra_imp_archive_t* kra_imp_open_archive(const char* archive_buffer, const unsigned long long archive_buffer_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Opens a KRA archive directly from a file.
+     *
+     * @details
+     * Maps the file read-only into memory instead of reading it into a buffer. The operating system loads
+     * only the pages that are actually accessed, so opening a large archive to read a single entry touches
+     * just the central directory and that entry. The mapping is released by `kra_imp_close_archive`.
+     *
+     * @param[in] archive_file_path Path to the KRA file.
+     *
+     * @return Pointer to the opened KRA archive on success, or nullptr on failure.
+     *
+     * @note The file must not be truncated while the archive is open.
+     */
+    KRA_IMP_API kra_imp_archive_t* kra_imp_open_archive_file(const char* archive_file_path);
     /**
      * @ingroup kra_imp
      *
@@ -75,7 +135,7 @@ extern "C"
      * @brief Gets the uncompressed size of a file in the archive.
      *
      * @details
-     * Retrieves the size of a specified file in the archive.
+     * Retrieves the size of a specified file in the archive from the index built when the archive was opened.
      *
      * @param[in] archive Pointer to the opened archive.
      * @param[in] file_path Path to the file within the archive's structure.
@@ -99,6 +159,133 @@ extern "C"
      * @return Number of bytes read on success (should match file size). Returns 0 on failure.
      */
     KRA_IMP_API unsigned long long kra_imp_load_file(kra_imp_archive_t* archive, const char* file_path, char* file_buffer, const unsigned long long file_buffer_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Gets the number of files in the archive.
+     *
+     * @details
+     * Files are indexed by name once, when the archive is opened. The returned count bounds the indices accepted
+     * by `kra_imp_get_file_name`, `kra_imp_get_file_size_by_index` and `kra_imp_load_file_by_index`.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     *
+     * @return Number of files in the archive, or 0 on failure.
+     */
+    KRA_IMP_API unsigned long long kra_imp_get_files_count(const kra_imp_archive_t* archive);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Finds the index of a file in the archive.
+     *
+     * @details
+     * Resolves the path with a single hash lookup. Resolving a path once and reusing its index avoids repeated lookups
+     * in the size-then-load pattern. Paths match regardless of case, backslashes and a leading "./".
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_path Path to the file within the archive's structure.
+     * @param[out] file_index Index of the file in the archive.
+     *
+     * @return KRA_IMP_SUCCESS on success, KRA_IMP_FAIL if there is no such file, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_find_file_index(const kra_imp_archive_t* archive, const char* file_path, unsigned long long* file_index);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Gets the path of a file in the archive.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_index Index of the file in the archive.
+     *
+     * @return Path to the file within the archive's structure, or nullptr on failure. The path stays valid until the archive is closed.
+     */
+    KRA_IMP_API const char* kra_imp_get_file_name(const kra_imp_archive_t* archive, const unsigned long long file_index);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Gets the uncompressed size of a file in the archive by its index.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_index Index of the file in the archive.
+     *
+     * @return Size of the file in bytes on success, or 0 on failure.
+     */
+    KRA_IMP_API unsigned long long kra_imp_get_file_size_by_index(const kra_imp_archive_t* archive, const unsigned long long file_index);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Loads a file from the archive into a preallocated buffer by its index.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_index Index of the file in the archive.
+     * @param[out] file_buffer Buffer to store the file data.
+     * @param[in] file_buffer_size Size of the buffer in bytes.
+     *
+     * @return Number of bytes read on success (should match file size). Returns 0 on failure.
+     */
+    KRA_IMP_API unsigned long long kra_imp_load_file_by_index(kra_imp_archive_t* archive, const unsigned long long file_index, char* file_buffer,
+                                                              const unsigned long long file_buffer_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reports the size of a file in the archive and loads it into a preallocated buffer in one call.
+     *
+     * @details
+     * Replaces the `kra_imp_get_file_size` and `kra_imp_load_file` pair, opening the file only once.
+     * The size is reported even if the buffer is too small, so passing a null buffer queries the size alone.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_path Path to the file within the archive's structure.
+     * @param[out] file_buffer Buffer to store the file data. Can be nullptr if `file_buffer_size` is 0.
+     * @param[in] file_buffer_size Size of the buffer in bytes.
+     * @param[out] file_size Uncompressed size of the file in bytes.
+     *
+     * @return KRA_IMP_SUCCESS if the whole file was loaded, KRA_IMP_FAIL if there is no such file or the buffer is too small,
+     * or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_file(kra_imp_archive_t* archive, const char* file_path, char* file_buffer, const unsigned long long file_buffer_size,
+                                                       unsigned long long* file_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Loads a file from the archive into a buffer obtained from an allocation function.
+     *
+     * @details
+     * Calls `allocation_function` once with the uncompressed size of the file and decompresses the file straight
+     * into the returned buffer. The allocation function is not called for empty files.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_path Path to the file within the archive's structure.
+     * @param[in] allocation_function Function allocating the file buffer.
+     * @param[in] user_data User pointer passed to `allocation_function`.
+     * @param[out] file_buffer Buffer holding the file data, or nullptr for an empty file.
+     * @param[out] file_size Uncompressed size of the file in bytes.
+     *
+     * @return KRA_IMP_SUCCESS if the whole file was loaded, KRA_IMP_FAIL if there is no such file or the allocation failed,
+     * or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The buffer is owned by the caller. It is returned in `file_buffer` even if decompression fails, so it can be released.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_file_allocated(kra_imp_archive_t* archive, const char* file_path, kra_imp_file_allocation_function allocation_function,
+                                                                 void* user_data, char** file_buffer, unsigned long long* file_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Streams a file from the archive in chunks.
+     *
+     * @details
+     * Decompresses the specified file through a fixed-size window and passes the decompressed bytes to
+     * `chunk_function` as they become available, so the file never has to fit in memory as a whole.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_path Path to the file within the archive's structure.
+     * @param[in] chunk_function Function receiving consecutive chunks of the file.
+     * @param[in] user_data User pointer passed to `chunk_function`.
+     *
+     * @return KRA_IMP_SUCCESS if the whole file was streamed, the value returned by `chunk_function` if it stopped streaming,
+     * or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_stream_file(kra_imp_archive_t* archive, const char* file_path, kra_imp_file_chunk_function chunk_function, void* user_data);
     /**
      * @ingroup kra_imp
      *
@@ -165,6 +352,28 @@ extern "C"
      */
     KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_layer(const char* xml_buffer, const unsigned long long xml_buffer_size, const unsigned int layer_index,
                                                               kra_imp_image_layer_t* image_layer);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads all layers from the provided XML buffer in a single pass.
+     *
+     * @details
+     * Parses the XML buffer once and fills the caller-provided array with the layers in the same order
+     * as `kra_imp_read_image_layer` uses for its indices. Besides the parent index, every entry holds
+     * the indices of its first child and next sibling, and its depth, so the whole layer tree can be
+     * rebuilt from the array alone.
+     *
+     * @param[in] xml_buffer Pointer to the memory buffer containing the XML data.
+     * @param[in] xml_buffer_size Size of the XML buffer in bytes.
+     * @param[out] layer_nodes Array to store the layers.
+     * @param[in] layers_count Number of layers to read, usually `kra_imp_main_doc_t::_layers_count`.
+     *
+     * @return KRA_IMP_SUCCESS if all requested layers were read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note When fewer layers than available are requested, child and sibling indices may refer to layers beyond the array.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_layers(const char* xml_buffer, const unsigned long long xml_buffer_size, kra_imp_image_layer_node_t* layer_nodes,
+                                                               const unsigned int layers_count);
     /**
      * @ingroup kra_imp
      *
@@ -199,6 +408,114 @@ extern "C"
      */
     KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_key_frame(const char* xml_buffer, const unsigned long long xml_buffer_size, const unsigned int key_frame_index,
                                                                   kra_imp_image_key_frame_t* image_key_frame);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Parses an XML document once and keeps it for repeated queries.
+     *
+     * @details
+     * Parses the given XML buffer (`maindoc.xml` or a keyframes file) and flattens its layers and key frames
+     * into tables, in the same order as used by `kra_imp_read_image_layer` and `kra_imp_read_image_key_frame`.
+     * All `kra_imp_get_document_*` functions answer from these tables without parsing the XML again.
+     * The XML buffer is copied, so it can be released once this function returns.
+     *
+     * @param[in] xml_buffer Pointer to the memory buffer containing the XML data.
+     * @param[in] xml_buffer_size Size of the XML buffer in bytes.
+     *
+     * @return Pointer to the opened document on success, or nullptr on failure.
+     */
+    KRA_IMP_API kra_imp_document_t* kra_imp_open_document(const char* xml_buffer, const unsigned long long xml_buffer_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Closes an opened document and frees allocated memory.
+     *
+     * @param[in] document Pointer to the document to close.
+     */
+    KRA_IMP_API void kra_imp_close_document(kra_imp_document_t* document);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads the main document data from an opened document.
+     *
+     * @details
+     * Equivalent of `kra_imp_read_main_doc` for an already parsed document.
+     *
+     * @param[in] document Pointer to the opened document.
+     * @param[out] main_doc Pointer to the structure where the main document data will be stored.
+     *
+     * @return KRA_IMP_SUCCESS if the main document was successfully read, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_main_doc(const kra_imp_document_t* document, kra_imp_main_doc_t* main_doc);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Retrieves the total number of layers of an opened document.
+     *
+     * @param[in] document Pointer to the opened document.
+     *
+     * @return The number of layers, including layers nested in groups, or 0 on failure.
+     */
+    KRA_IMP_API unsigned int kra_imp_get_document_layers_count(const kra_imp_document_t* document);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads a specific layer from an opened document.
+     *
+     * @details
+     * Equivalent of `kra_imp_read_image_layer` for an already parsed document. The layer is looked up
+     * directly in the flattened layers table.
+     *
+     * @param[in] document Pointer to the opened document.
+     * @param[in] layer_index Index of the layer to read.
+     * @param[out] image_layer Pointer to the structure where the layer data will be stored.
+     *
+     * @return KRA_IMP_SUCCESS if the layer was successfully read, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_image_layer(const kra_imp_document_t* document, const unsigned int layer_index, kra_imp_image_layer_t* image_layer);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads all layers of an opened document.
+     *
+     * @details
+     * Equivalent of `kra_imp_read_image_layers` for an already parsed document.
+     *
+     * @param[in] document Pointer to the opened document.
+     * @param[out] layer_nodes Array to store the layers.
+     * @param[in] layers_count Number of layers to read, usually `kra_imp_get_document_layers_count`.
+     *
+     * @return KRA_IMP_SUCCESS if all requested layers were read, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_image_layers(const kra_imp_document_t* document, kra_imp_image_layer_node_t* layer_nodes,
+                                                                       const unsigned int layers_count);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Retrieves the total number of key frames of an opened document.
+     *
+     * @param[in] document Pointer to the opened document.
+     *
+     * @return The number of key frames, or 0 if no key frames are available or on failure.
+     */
+    KRA_IMP_API unsigned int kra_imp_get_document_key_frames_count(const kra_imp_document_t* document);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads a specific key frame from an opened document.
+     *
+     * @details
+     * Equivalent of `kra_imp_read_image_key_frame` for an already parsed document. The key frame is looked up
+     * directly in the flattened key frames table.
+     *
+     * @param[in] document Pointer to the opened document.
+     * @param[in] key_frame_index Index of the key frame to read.
+     * @param[out] image_key_frame Pointer to the structure where the key frame data will be stored.
+     *
+     * @return KRA_IMP_SUCCESS if the key frame was successfully read, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_image_key_frame(const kra_imp_document_t* document, const unsigned int key_frame_index,
+                                                                          kra_imp_image_key_frame_t* image_key_frame);
     /**
      * @ingroup kra_imp
      *
@@ -259,6 +576,234 @@ extern "C"
      */
     KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data(const char* buffer, const unsigned long long buffer_size, const unsigned int data_index,
                                                              kra_imp_layer_output_data_t* output);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Builds an index of all tiles stored in layer data.
+     *
+     * @details
+     * Walks the layer data buffer once and fills the caller-provided array with the offsets, compression
+     * method and payload location of every tile. Each tile can then be read with `kra_imp_read_indexed_layer_data`
+     * in constant time, instead of calling `kra_imp_read_layer_data`, which parses all tiles preceding the requested one.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[out] tiles Array to store the indexed tiles.
+     * @param[in] tiles_count Number of tiles to index, usually `kra_imp_layer_data_header_t::_layer_datas_count`.
+     *
+     * @return KRA_IMP_SUCCESS if all requested tiles were indexed, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The indexed tiles point into `buffer`, which must outlive them.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_index_layer_data(const char* buffer, const unsigned long long buffer_size, kra_imp_layer_data_tile_t* tiles,
+                                                              const unsigned int tiles_count);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Indexes tiles of layer data using a task executor.
+     *
+     * @details
+     * Works like `kra_imp_index_layer_data`, but splits large buffers into chunks indexed in parallel as tasks submitted
+     * to the provided executor. Every chunk speculatively resynchronizes on the first "x,y,LZF,size" tile line followed
+     * by a valid chain of tiles. The chunks are then stitched in order on the calling thread, and a chunk whose first
+     * tile does not match where the previous chunk ended is walked again from there, so the result is always identical
+     * to `kra_imp_index_layer_data`. Buffers too small to be worth splitting are indexed on the calling thread.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[out] tiles Array receiving the indexed tiles, holding at least `tiles_count` elements.
+     * @param[in] tiles_count Number of tiles to index, usually `kra_imp_layer_data_header_t::_layer_datas_count`.
+     * @param[in] executor Pointer to the executor running the indexing tasks.
+     *
+     * @return KRA_IMP_SUCCESS if all requested tiles were indexed, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The indexed tiles point into `buffer`, which must outlive them.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_index_layer_data_parallel(const char* buffer, const unsigned long long buffer_size, kra_imp_layer_data_tile_t* tiles,
+                                                                       const unsigned int tiles_count, const kra_imp_executor_t* executor);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads layer data of an indexed tile.
+     *
+     * @details
+     * Decompresses (or copies) the payload of a tile previously indexed by `kra_imp_index_layer_data`
+     * into the provided `kra_imp_layer_output_data_t` structure, including its offsets.
+     *
+     * @param[in] tile Pointer to the indexed tile to read.
+     * @param[out] output Pointer to the `kra_imp_layer_output_data_t` structure where the tile data will be stored.
+     *
+     * @return KRA_IMP_SUCCESS if the layer data was successfully read, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data(const kra_imp_layer_data_tile_t* tile, kra_imp_layer_output_data_t* output);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Gets in-place access to the pixels of an uncompressed indexed tile.
+     *
+     * @details
+     * Uncompressed tiles already hold planar pixel data within the layer data buffer, so instead of copying it
+     * like `kra_imp_read_indexed_layer_data`, this function returns a pointer to it. The pixels can be passed
+     * directly to the delinearize functions.
+     *
+     * @param[in] tile Pointer to the indexed tile.
+     * @param[in] layer_data_header Pointer to the header of the layer data the tile belongs to.
+     * @param[out] tile_data Pointer to the tile's pixels within the layer data buffer.
+     * @param[out] tile_data_size Size of the tile's pixels in bytes (tile width * tile height * pixel size).
+     *
+     * @return KRA_IMP_SUCCESS if the tile is uncompressed, KRA_IMP_FAIL if it is compressed and has to be read with
+     * `kra_imp_read_indexed_layer_data`, KRA_IMP_DECOMPRESS_ERROR if its payload is too short, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The returned pointer points into the buffer the tile was indexed from, which must outlive it.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_uncompressed_tile_data(const kra_imp_layer_data_tile_t* tile, const kra_imp_layer_data_header_t* layer_data_header,
+                                                                        const char** tile_data, unsigned long long* tile_data_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Computes the tile-aligned bounds of layer data without decoding any tile.
+     *
+     * @details
+     * Walks the tile lines of the layer data and skips over the payloads, so no tile is decompressed.
+     * Layer data without tiles produces empty bounds.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] bounds Pointer to the `kra_imp_layer_data_bounds_t` structure receiving the bounds.
+     *
+     * @return KRA_IMP_SUCCESS if the bounds were successfully computed, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_layer_data_bounds(const char* buffer, const unsigned long long buffer_size,
+                                                                   const kra_imp_layer_data_header_t* layer_data_header, kra_imp_layer_data_bounds_t* bounds);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Fills a bitmap of the cells of the bounds grid covered by tiles, without decoding any tile.
+     *
+     * @details
+     * Bit `row * _columns + column` of the bitmap, counting from the least significant bit of the first byte, is set
+     * if a tile covers that cell of the grid. Tiles not aligned to the grid set every cell they overlap, and tiles
+     * outside of the bounds are ignored.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[in] bounds Pointer to the bounds previously computed by `kra_imp_get_layer_data_bounds`.
+     * @param[out] occupancy Buffer receiving the bitmap.
+     * @param[in] occupancy_size Size of the buffer in bytes, at least `(_columns * _rows + 7) / 8`.
+     *
+     * @return KRA_IMP_SUCCESS if the bitmap was successfully filled, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_layer_data_occupancy(const char* buffer, const unsigned long long buffer_size,
+                                                                      const kra_imp_layer_data_header_t* layer_data_header, const kra_imp_layer_data_bounds_t* bounds,
+                                                                      unsigned char* occupancy, const unsigned long long occupancy_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Opens an incremental parser of layer data.
+     *
+     * @details
+     * Layer data (including its header) fed with `kra_imp_read_layer_data_stream` is parsed as it arrives,
+     * and every tile is passed to `tile_function` as soon as all of its bytes were read. The tile can be
+     * decoded within the call, for example with `kra_imp_read_indexed_layer_data` or
+     * `kra_imp_read_indexed_layer_data_to_canvas`.
+     *
+     * @param[in] tile_function Function receiving the tiles.
+     * @param[in] user_data User pointer passed to `tile_function`.
+     *
+     * @return Pointer to the opened stream on success, or nullptr on failure.
+     */
+    KRA_IMP_API kra_imp_layer_data_stream_t* kra_imp_open_layer_data_stream(kra_imp_layer_data_tile_function tile_function, void* user_data);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Feeds the next chunk of layer data to a stream.
+     *
+     * @details
+     * Chunks may be split at any byte. Bytes following the last tile are ignored.
+     *
+     * @param[in] stream Pointer to the opened stream.
+     * @param[in] chunk Pointer to the next bytes of the layer data.
+     * @param[in] chunk_size Number of bytes in the chunk.
+     *
+     * @return KRA_IMP_SUCCESS if the chunk was consumed, the value returned by the tile function if it stopped streaming,
+     * or other `kra_imp_error_code_e` on failure. After a failure the stream must be closed.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_stream(kra_imp_layer_data_stream_t* stream, const char* chunk, const unsigned long long chunk_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Closes a layer data stream and frees allocated memory.
+     *
+     * @param[in] stream Pointer to the stream to close.
+     *
+     * @return KRA_IMP_SUCCESS if the header and all tiles were read before closing, KRA_IMP_PARSE_ERROR if the layer data
+     * was incomplete, or KRA_IMP_PARAMS_ERROR for a null stream.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_close_layer_data_stream(kra_imp_layer_data_stream_t* stream);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Streams layer data from the archive tile by tile.
+     *
+     * @details
+     * Combines `kra_imp_stream_file` with a layer data stream. Peak memory usage is one decompression window
+     * plus one tile, instead of the whole decompressed layer data required by `kra_imp_load_file`.
+     *
+     * @param[in] archive Pointer to the opened archive.
+     * @param[in] file_path Path to the layer file within the archive's structure.
+     * @param[in] tile_function Function receiving the tiles.
+     * @param[in] user_data User pointer passed to `tile_function`.
+     *
+     * @return KRA_IMP_SUCCESS if all tiles were streamed, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_stream_layer_data(kra_imp_archive_t* archive, const char* file_path, kra_imp_layer_data_tile_function tile_function,
+                                                               void* user_data);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads all tiles of layer data into a tile atlas.
+     *
+     * @details
+     * Decodes every tile of the layer data in a single pass over the buffer. Tiles are written one after
+     * another into the atlas buffer and their offsets into the atlas offsets array, using the tile geometry
+     * and tiles count from the provided layer data header.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] atlas Pointer to the `kra_imp_layer_data_atlas_t` structure where the decoded tiles will be stored.
+     *
+     * @return KRA_IMP_SUCCESS if all tiles were successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The atlas buffer should be at least (_layer_datas_count * _layer_data_width * _layer_data_height * _layer_data_pixel_size)
+     * bytes and the offsets array should hold at least `_layer_datas_count` elements.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_atlas(const char* buffer, const unsigned long long buffer_size, const kra_imp_layer_data_header_t* layer_data_header,
+                                                                   kra_imp_layer_data_atlas_t* atlas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads all tiles of layer data into a tile atlas using a task executor.
+     *
+     * @details
+     * Works like `kra_imp_read_layer_data_atlas`, but splits the tiles into ranges that are decompressed
+     * in parallel as tasks submitted to the provided executor. Tile headers are still walked serially on
+     * the calling thread to find where each range starts. The function returns after all submitted tasks
+     * have finished.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] atlas Pointer to the `kra_imp_layer_data_atlas_t` structure where the decoded tiles will be stored.
+     * @param[in] executor Pointer to the executor running the decompression tasks.
+     *
+     * @return KRA_IMP_SUCCESS if all tiles were successfully read, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_atlas_parallel(const char* buffer, const unsigned long long buffer_size,
+                                                                            const kra_imp_layer_data_header_t* layer_data_header, kra_imp_layer_data_atlas_t* atlas,
+                                                                            const kra_imp_executor_t* executor);
     /**
      * @ingroup kra_imp
      *
@@ -327,6 +872,318 @@ extern "C"
      */
     KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_with_offset(const char* input, const unsigned long long input_size, const unsigned int input_width,
                                                                      kra_imp_delinerize_output_t* output);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Converts a linear color buffer of any pixel size to interleaved pixels with an offset.
+     *
+     * @details
+     * Works like `kra_imp_delinearize_with_offset`, but takes the pixel size from the layer data header instead of
+     * assuming 4 byte BGRA pixels, so documents using other color models (GRAYA, CMYKA) or channel depths (16-bit
+     * integer, 16 and 32-bit float) can be converted as well. The kernel is selected once per call for the pixel size;
+     * common pixel sizes use vectorized kernels. The bytes of every pixel are written in the order Krita stores them.
+     *
+     * @param[in] input Linear color buffer to convert, usually a tile read by `kra_imp_read_layer_data`.
+     * @param[in] input_size Size of the input buffer in bytes.
+     * @param[in] input_width Width of the input data in pixels.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] output Pointer to the `kra_imp_delinerize_output_t` structure where the converted data will be stored.
+     *
+     * @return KRA_IMP_SUCCESS if the conversion was successful, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note `output->_offset` is given in bytes, and the output buffer has to hold every row of the input at a stride
+     * of `output->_width` pixels of `_layer_data_pixel_size` bytes.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_layer_data(const char* input, const unsigned long long input_size, const unsigned int input_width,
+                                                                    const kra_imp_layer_data_header_t* layer_data_header, kra_imp_delinerize_output_t* output);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Converts a linear BGRA color buffer to interleaved pixels of a chosen format with an offset.
+     *
+     * @details
+     * Works like `kra_imp_delinearize_with_offset`, but writes pixels in the channel order, alpha mode and channel depth
+     * of `pixel_format`. Channels are reordered, premultiplied and widened inside the interleaving kernel, so every
+     * pixel is written once, e.g. premultiplied RGBA ready for a GPU upload needs no second pass over the output.
+     * Premultiplied 16-bit and float channels are computed from the 8-bit values at the output precision.
+     *
+     * @param[in] input Linear color buffer of 8-bit BGRA pixels to convert.
+     * @param[in] input_size Size of the input buffer in bytes.
+     * @param[in] input_width Width of the input data in pixels.
+     * @param[in] pixel_format Pointer to the `kra_imp_pixel_format_t` describing the output pixels.
+     * @param[out] output Pointer to the `kra_imp_delinerize_output_t` structure where the converted data will be stored.
+     *
+     * @return KRA_IMP_SUCCESS if the conversion was successful, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note `output->_offset` is given in bytes, and the output buffer has to hold every row of the input at a stride
+     * of `output->_width` output pixels, which are 4, 8 or 16 bytes large for 8-bit, 16-bit and float channels.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_to_format(const char* input, const unsigned long long input_size, const unsigned int input_width,
+                                                                   const kra_imp_pixel_format_t* pixel_format, kra_imp_delinerize_output_t* output);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Converts interleaved pixels of any supported color format to 8-bit sRGB.
+     *
+     * @details
+     * Converts pixels interleaved by `kra_imp_delinearize_layer_data`, in the color space model and channel depth
+     * of `color_conversion`, to 8-bit pixels in the requested channel order. The conversion kernel is selected once
+     * per call: 8 and 16-bit RGBA and 8-bit GRAYA pixels use vectorized integer kernels, other formats are converted
+     * in batches, with a lookup table encoding linear light to sRGB.
+     *
+     * @param[in] input Interleaved pixels to convert.
+     * @param[in] pixels_count Number of pixels to convert.
+     * @param[in] color_conversion Pointer to the `kra_imp_color_conversion_t` describing the conversion.
+     * @param[out] output Buffer receiving the converted pixels, at least (pixels_count * 4) bytes.
+     *
+     * @return KRA_IMP_SUCCESS if the conversion was successful, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note ICC profiles are not applied. Floating point RGBA and GRAYA, CIELAB and XYZA pixels are treated as linear
+     * light and encoded with the sRGB transfer curve, all other pixels are assumed to be sRGB encoded already.
+     * Only the BGRA and RGBA pixel orders are supported, ARGB output is only written by `kra_imp_delinearize_to_format`.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_convert_pixels(const char* input, const unsigned long long pixels_count, const kra_imp_color_conversion_t* color_conversion,
+                                                            char* output);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads an indexed tile straight into a BGRA canvas.
+     *
+     * @details
+     * Decodes a tile previously indexed by `kra_imp_index_layer_data` and writes its pixels, converted to BGRA,
+     * directly into the canvas at the tile's offsets. This replaces calling `kra_imp_read_indexed_layer_data` followed
+     * by `kra_imp_delinearize_with_offset`, and needs no intermediate tile buffer from the caller. Parts of the tile
+     * outside of the canvas, including negative offsets, are clipped.
+     *
+     * @param[in] tile Pointer to the indexed tile to read.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] canvas Pointer to the `kra_imp_canvas_t` structure describing the output image.
+     *
+     * @return KRA_IMP_SUCCESS if the tile was successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note Only tiles of 4 bytes per pixel and up to 64x64 pixels are supported.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_to_canvas(const kra_imp_layer_data_tile_t* tile, const kra_imp_layer_data_header_t* layer_data_header,
+                                                                               kra_imp_canvas_t* canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads all tiles of layer data straight into a BGRA canvas.
+     *
+     * @details
+     * Decodes every tile of the layer data in a single pass over the buffer and writes its pixels, converted to BGRA,
+     * directly into the canvas at the tile's offsets. Parts of tiles outside of the canvas are clipped.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] canvas Pointer to the `kra_imp_canvas_t` structure describing the output image.
+     *
+     * @return KRA_IMP_SUCCESS if all tiles were successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note Only tiles of 4 bytes per pixel and up to 64x64 pixels are supported.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_to_canvas(const char* buffer, const unsigned long long buffer_size,
+                                                                       const kra_imp_layer_data_header_t* layer_data_header, kra_imp_canvas_t* canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads an indexed tile of any supported color format straight into an 8-bit canvas.
+     *
+     * @details
+     * Works like `kra_imp_read_indexed_layer_data_to_canvas`, but converts the pixels with `kra_imp_convert_pixels`
+     * as they are written. Every row of the tile is decompressed, interleaved and converted while it is still in cache,
+     * without intermediate buffers from the caller. The pixels of the canvas are in the order of `color_conversion`.
+     *
+     * @param[in] tile Pointer to the indexed tile to read.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[in] color_conversion Pointer to the `kra_imp_color_conversion_t` describing the conversion.
+     * @param[out] canvas Pointer to the `kra_imp_canvas_t` structure describing the output image.
+     *
+     * @return KRA_IMP_SUCCESS if the tile was successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The pixel size of the header must match the color format of `color_conversion`. Tiles up to 64x64 pixels are supported.
+     * Only the BGRA and RGBA pixel orders are supported.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_to_canvas_converted(const kra_imp_layer_data_tile_t* tile,
+                                                                                         const kra_imp_layer_data_header_t* layer_data_header,
+                                                                                         const kra_imp_color_conversion_t* color_conversion, kra_imp_canvas_t* canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads all tiles of layer data of any supported color format straight into an 8-bit canvas.
+     *
+     * @details
+     * Works like `kra_imp_read_layer_data_to_canvas`, converting the pixels of every tile with `kra_imp_convert_pixels`
+     * as they are written into the canvas.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[in] color_conversion Pointer to the `kra_imp_color_conversion_t` describing the conversion.
+     * @param[out] canvas Pointer to the `kra_imp_canvas_t` structure describing the output image.
+     *
+     * @return KRA_IMP_SUCCESS if all tiles were successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The pixel size of the header must match the color format of `color_conversion`. Tiles up to 64x64 pixels are supported.
+     * Only the BGRA and RGBA pixel orders are supported.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_to_canvas_converted(const char* buffer, const unsigned long long buffer_size,
+                                                                                 const kra_imp_layer_data_header_t* layer_data_header,
+                                                                                 const kra_imp_color_conversion_t* color_conversion, kra_imp_canvas_t* canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads indexed tiles intersecting a rectangle straight into a BGRA region buffer.
+     *
+     * @details
+     * Treats `region` as a window of the layer whose top-left pixel lies at (`x_offset`, `y_offset`) in layer coordinates,
+     * and `_width` by `_height` pixels large. Only tiles intersecting the window are decoded, and their pixels, converted
+     * to BGRA, are clipped to it. Tiles outside of the window are skipped without being decompressed, so panning over
+     * a large layer indexed once with `kra_imp_index_layer_data` costs only the tiles that are visible.
+     *
+     * @param[in] tiles Array of tiles previously indexed by `kra_imp_index_layer_data`.
+     * @param[in] tiles_count Number of tiles in the array.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[in] x_offset Horizontal position of the region in the layer, in pixels.
+     * @param[in] y_offset Vertical position of the region in the layer, in pixels.
+     * @param[out] region Pointer to the `kra_imp_canvas_t` structure describing the region buffer.
+     *
+     * @return KRA_IMP_SUCCESS if all intersecting tiles were successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note Pixels of the region not covered by any tile are left untouched.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_region(const kra_imp_layer_data_tile_t* tiles, const unsigned int tiles_count,
+                                                                            const kra_imp_layer_data_header_t* layer_data_header, const int x_offset, const int y_offset,
+                                                                            kra_imp_canvas_t* region);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads tiles of layer data intersecting a rectangle straight into a BGRA region buffer.
+     *
+     * @details
+     * Works like `kra_imp_read_indexed_layer_data_region`, but walks the tile lines of the layer data in a single pass.
+     * Payloads of tiles outside of the region are skipped without being decompressed.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[in] x_offset Horizontal position of the region in the layer, in pixels.
+     * @param[in] y_offset Vertical position of the region in the layer, in pixels.
+     * @param[out] region Pointer to the `kra_imp_canvas_t` structure describing the region buffer.
+     *
+     * @return KRA_IMP_SUCCESS if all intersecting tiles were successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note Pixels of the region not covered by any tile are left untouched.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_region(const char* buffer, const unsigned long long buffer_size,
+                                                                    const kra_imp_layer_data_header_t* layer_data_header, const int x_offset, const int y_offset,
+                                                                    kra_imp_canvas_t* region);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Creates an empty sparse canvas for layer data.
+     *
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`, defining the size of the slots.
+     *
+     * @return Pointer to `kra_imp_sparse_canvas_t` on success, or nullptr on failure.
+     *
+     * @note Only tiles of 4 bytes per pixel and up to 64x64 pixels are supported.
+     */
+    KRA_IMP_API kra_imp_sparse_canvas_t* kra_imp_open_sparse_canvas(const kra_imp_layer_data_header_t* layer_data_header);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Releases a sparse canvas and all its slots.
+     *
+     * @param[in] sparse_canvas Pointer to the `kra_imp_sparse_canvas_t` to close.
+     */
+    KRA_IMP_API void kra_imp_close_sparse_canvas(kra_imp_sparse_canvas_t* sparse_canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads an indexed tile into a sparse canvas.
+     *
+     * @details
+     * Decodes a tile previously indexed by `kra_imp_index_layer_data` and writes its pixels, converted to BGRA,
+     * into the slots it covers, creating them as needed. A tile aligned to the slot grid fills exactly one slot.
+     *
+     * @param[in] tile Pointer to the indexed tile to read.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] sparse_canvas Pointer to the `kra_imp_sparse_canvas_t` receiving the pixels.
+     *
+     * @return KRA_IMP_SUCCESS if the tile was successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The tile size of the header must match the one the sparse canvas was opened with.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_to_sparse_canvas(const kra_imp_layer_data_tile_t* tile,
+                                                                                      const kra_imp_layer_data_header_t* layer_data_header,
+                                                                                      kra_imp_sparse_canvas_t* sparse_canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Reads all tiles of layer data into a sparse canvas.
+     *
+     * @details
+     * Decodes every tile of the layer data in a single pass over the buffer and writes its pixels, converted to BGRA,
+     * into the slots of the sparse canvas. Only the painted area of the layer is allocated.
+     *
+     * @param[in] buffer Memory buffer containing the layer data (without the layer data header).
+     * @param[in] buffer_size Size of the buffer in bytes.
+     * @param[in] layer_data_header Pointer to the header previously read by `kra_imp_read_layer_data_header`.
+     * @param[out] sparse_canvas Pointer to the `kra_imp_sparse_canvas_t` receiving the pixels.
+     *
+     * @return KRA_IMP_SUCCESS if all tiles were successfully read, or other `kra_imp_error_code_e` on failure.
+     *
+     * @note The tile size of the header must match the one the sparse canvas was opened with.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_to_sparse_canvas(const char* buffer, const unsigned long long buffer_size,
+                                                                              const kra_imp_layer_data_header_t* layer_data_header, kra_imp_sparse_canvas_t* sparse_canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Retrieves the number of slots in a sparse canvas.
+     *
+     * @param[in] sparse_canvas Pointer to the `kra_imp_sparse_canvas_t`.
+     *
+     * @return The number of slots, or 0 if `sparse_canvas` is nullptr.
+     */
+    KRA_IMP_API unsigned int kra_imp_get_sparse_canvas_tiles_count(const kra_imp_sparse_canvas_t* sparse_canvas);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Retrieves a slot of a sparse canvas.
+     *
+     * @details
+     * Slots are numbered from 0 to `kra_imp_get_sparse_canvas_tiles_count() - 1` in the order they were created,
+     * which allows iterating over the painted area without touching empty parts of the image.
+     *
+     * @param[in] sparse_canvas Pointer to the `kra_imp_sparse_canvas_t`.
+     * @param[in] tile_index Index of the slot.
+     * @param[out] tile Pointer to the `kra_imp_sparse_canvas_tile_t` receiving the slot.
+     *
+     * @return KRA_IMP_SUCCESS if the slot was found, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_get_sparse_canvas_tile(const kra_imp_sparse_canvas_t* sparse_canvas, const unsigned int tile_index,
+                                                                    kra_imp_sparse_canvas_tile_t* tile);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Copies a rectangle of a sparse canvas into a dense BGRA buffer.
+     *
+     * @details
+     * Treats `region` as a window of the image whose top-left pixel lies at (`x_offset`, `y_offset`), like
+     * `kra_imp_read_layer_data_region`. Pixels of the window not covered by any slot are set to zero.
+     *
+     * @param[in] sparse_canvas Pointer to the `kra_imp_sparse_canvas_t` to export.
+     * @param[in] x_offset Horizontal position of the region in the image, in pixels.
+     * @param[in] y_offset Vertical position of the region in the image, in pixels.
+     * @param[out] region Pointer to the `kra_imp_canvas_t` structure describing the region buffer.
+     *
+     * @return KRA_IMP_SUCCESS if the region was successfully exported, or other `kra_imp_error_code_e` on failure.
+     */
+    KRA_IMP_API kra_imp_error_code_e kra_imp_export_sparse_canvas(const kra_imp_sparse_canvas_t* sparse_canvas, const int x_offset, const int y_offset,
+                                                                  kra_imp_canvas_t* region);
 #ifdef __cplusplus
 }
 #endif
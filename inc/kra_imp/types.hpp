@@ -46,6 +46,62 @@ extern "C"
      * @param ptr Pointer to the memory block to free.
      */
     typedef void (*kra_imp_deallocation_function)(void* ptr);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type for custom memory allocation with a user context.
+     *
+     * @details
+     * Same as `kra_imp_allocation_function`, but receives the context pointer registered together with it,
+     * e.g. an arena the memory is taken from.
+     *
+     * @param context The context pointer registered with the allocation function.
+     * @param size The number of bytes to allocate.
+     * @return Pointer to the allocated memory block, or NULL (nullptr) if allocation fails.
+     */
+    typedef void* (*kra_imp_context_allocation_function)(void* context, size_t size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type for custom memory deallocation with a user context.
+     *
+     * @param context The context pointer registered with the deallocation function.
+     * @param ptr Pointer to the memory block to free.
+     */
+    typedef void (*kra_imp_context_deallocation_function)(void* context, void* ptr);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type for a unit of work run by an executor.
+     *
+     * @param task_data Pointer to the task's data, as passed to `kra_imp_submit_task_function`.
+     */
+    typedef void (*kra_imp_task_function)(void* task_data);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type for submitting a task to an executor.
+     *
+     * @details
+     * The function should schedule `task(task_data)` to run on any worker thread. It may also run
+     * the task immediately on the calling thread.
+     *
+     * @param executor_context User context pointer stored in `kra_imp_executor_t::_context`.
+     * @param task Task function to run.
+     * @param task_data Pointer to pass to the task function.
+     */
+    typedef void (*kra_imp_submit_task_function)(void* executor_context, kra_imp_task_function task, void* task_data);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type for waiting on submitted tasks.
+     *
+     * @details
+     * The function should block until every task submitted through the same executor has finished.
+     *
+     * @param executor_context User context pointer stored in `kra_imp_executor_t::_context`.
+     */
+    typedef void (*kra_imp_wait_tasks_function)(void* executor_context);
     /**
      * @ingroup kra_imp
      *
@@ -89,6 +145,48 @@ extern "C"
         KRA_IMP_XYZA_COLOR_SPACE_MODEL,        /**< The CIEXYZ color space with an alpha channel. */
         KRA_IMP_YCBCR_COLOR_SPACE_MODEL,       /**< The YCbCr color space, often used in video and image compression. */
     } kra_imp_color_space_model_e;
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Enumerates channel depths of the color spaces in the KRA importer.
+     *
+     * @details
+     * The channel depth is taken from the color space name of a KRA document and, together with
+     * the color space model, determines the size and encoding of a pixel.
+     */
+    typedef enum kra_imp_channel_depth_e
+    {
+        KRA_IMP_UNKNOWN_CHANNEL_DEPTH = 0, /**< An unknown or unsupported channel depth. */
+        KRA_IMP_U8_CHANNEL_DEPTH,          /**< 8-bit unsigned integer channels. */
+        KRA_IMP_U16_CHANNEL_DEPTH,         /**< 16-bit unsigned integer channels. */
+        KRA_IMP_F16_CHANNEL_DEPTH,         /**< 16-bit floating point (half precision) channels. */
+        KRA_IMP_F32_CHANNEL_DEPTH,         /**< 32-bit floating point channels. */
+    } kra_imp_channel_depth_e;
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Enumerates the channel orders of output pixels.
+     *
+     * @details
+     * `kra_imp_delinearize_to_format` writes every order. The conversions described by `kra_imp_color_conversion_t`
+     * write BGRA and RGBA only, and reject ARGB with KRA_IMP_PARAMS_ERROR.
+     */
+    typedef enum kra_imp_pixel_order_e
+    {
+        KRA_IMP_BGRA_PIXEL_ORDER = 0, /**< Blue, Green, Red, Alpha, the order of Krita's 8-bit RGBA pixels. */
+        KRA_IMP_RGBA_PIXEL_ORDER,     /**< Red, Green, Blue, Alpha. */
+        KRA_IMP_ARGB_PIXEL_ORDER,     /**< Alpha, Red, Green, Blue, only written by `kra_imp_delinearize_to_format`. */
+    } kra_imp_pixel_order_e;
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Enumerates the ways color channels of output pixels relate to their alpha.
+     */
+    typedef enum kra_imp_alpha_mode_e
+    {
+        KRA_IMP_STRAIGHT_ALPHA = 0,  /**< Color channels are independent of alpha, as Krita stores them. */
+        KRA_IMP_PREMULTIPLIED_ALPHA, /**< Color channels are multiplied by alpha. */
+    } kra_imp_alpha_mode_e;
     /**
      * @ingroup kra_imp
      *
@@ -127,6 +225,20 @@ extern "C"
         KRA_IMP_HIDDEN = 0, /**< The layer is hidden and not displayed in the composition. */
         KRA_IMP_VISIBLE,    /**< The layer is visible and contributes to the composition. */
     } kra_imp_layer_visibility_e;
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Enumerates the compression methods of a layer data tile.
+     *
+     * @details
+     * Each tile stored in a layer data buffer is prefixed with a single byte flag describing
+     * how its payload is stored. The enumeration values match the flag byte stored in the file.
+     */
+    typedef enum kra_imp_tile_compression_e
+    {
+        KRA_IMP_UNCOMPRESSED_TILE = 0, /**< The tile payload is stored as raw planar pixel data. */
+        KRA_IMP_LZF_COMPRESSED_TILE,   /**< The tile payload is compressed with LZF. */
+    } kra_imp_tile_compression_e;
     /**
      * @struct kra_imp_archive_t
      *
@@ -138,7 +250,7 @@ extern "C"
      * files, layers, key frames, and image properties.
      *
      * The `kra_imp_archive_t` is managed internally by the API and must be created
-     * using `kra_imp_open_archive`. Once created, it serves as the primary handle
+     * using `kra_imp_open_archive` or `kra_imp_open_archive_file`. Once created, it serves as the primary handle
      * for interacting with the archive's content. It should be properly closed using
      * `kra_imp_close_archive` to release allocated resources.
      *
@@ -147,6 +259,24 @@ extern "C"
      */
     struct KRA_IMP_API kra_imp_archive_t;
     typedef struct kra_imp_archive_t kra_imp_archive_t;
+    /**
+     * @struct kra_imp_document_t
+     *
+     * @brief Represents a parsed XML document of a KRA archive.
+     *
+     * @details
+     * This structure keeps the parsed XML tree of a document (`maindoc.xml` or a keyframes file)
+     * together with flattened tables of its layers and key frames, so repeated queries do not
+     * parse the XML again.
+     *
+     * The `kra_imp_document_t` must be created using `kra_imp_open_document` and closed
+     * using `kra_imp_close_document` to release allocated resources.
+     *
+     * @note The structure's internal implementation is opaque to the user and is
+     * fully managed by the API.
+     */
+    struct KRA_IMP_API kra_imp_document_t;
+    typedef struct kra_imp_document_t kra_imp_document_t;
     /**
      * @struct kra_imp_animation_t
      *
@@ -178,6 +308,7 @@ extern "C"
         unsigned int _height;                           /**< The height of the image in pixels. */
         unsigned int _width;                            /**< The width of the image in pixels. */
         kra_imp_animation_t _animation;                 /**< The animation properties associated with the image. */
+        kra_imp_channel_depth_e _channel_depth;         /**< The channel depth used by the image (e.g., 8-bit, 32-bit float). Kept last so earlier fields keep their offsets. */
     };
     typedef struct kra_imp_main_doc_t kra_imp_main_doc_t;
     /**
@@ -200,6 +331,23 @@ extern "C"
         long _parent_index;                               /**< The index of the parent layer, or `-1` if the layer has no parent. */
     };
     typedef struct kra_imp_image_layer_t kra_imp_image_layer_t;
+    /**
+     * @struct kra_imp_image_layer_node_t
+     *
+     * @brief Represents a layer together with its position in the layer tree.
+     *
+     * @details
+     * Extends `kra_imp_image_layer_t` with the indices needed to walk the layer tree without any further lookups.
+     * All indices refer to the depth-first order used by `kra_imp_read_image_layer`.
+     */
+    struct KRA_IMP_API kra_imp_image_layer_node_t
+    {
+        kra_imp_image_layer_t _layer; /**< The layer data, including the index of its parent. */
+        long _first_child_index;      /**< The index of the first child layer, or `-1` if the layer has no children. */
+        long _next_sibling_index;     /**< The index of the next layer with the same parent, or `-1` if the layer is the last one. */
+        unsigned int _depth;          /**< The nesting depth of the layer, `0` for top level layers. */
+    };
+    typedef struct kra_imp_image_layer_node_t kra_imp_image_layer_node_t;
     /**
      * @struct kra_imp_image_key_frame_t
      *
@@ -262,6 +410,147 @@ extern "C"
         int _y_offset;                   /**< Vertical offset of the layer's data in the image. */
     };
     typedef struct kra_imp_layer_output_data_t kra_imp_layer_output_data_t;
+    /**
+     * @struct kra_imp_layer_data_tile_t
+     *
+     * @brief Represents the location of a single tile within a layer data buffer.
+     *
+     * @details
+     * This structure is filled by `kra_imp_index_layer_data`, which walks the layer data buffer once
+     * and records where every tile is stored. An indexed tile can then be read with
+     * `kra_imp_read_indexed_layer_data` without parsing any of the preceding tiles again.
+     *
+     * @note The `_data` field points into the layer data buffer that was indexed, so that buffer
+     * must stay valid for as long as the tile is used.
+     */
+    struct KRA_IMP_API kra_imp_layer_data_tile_t
+    {
+        const char* _data;                       /**< Pointer to the tile's payload (following the compression flag) within the layer data buffer. */
+        unsigned int _data_size;                 /**< Size of the tile's payload in bytes. */
+        int _x_offset;                           /**< Horizontal offset of the tile in the image. */
+        int _y_offset;                           /**< Vertical offset of the tile in the image. */
+        kra_imp_tile_compression_e _compression; /**< Compression method of the tile's payload, as defined by `kra_imp_tile_compression_e`. */
+    };
+    typedef struct kra_imp_layer_data_tile_t kra_imp_layer_data_tile_t;
+    /**
+     * @struct kra_imp_layer_data_bounds_t
+     *
+     * @brief Represents the extent of all tiles of a layer.
+     *
+     * @details
+     * This structure is filled by `kra_imp_get_layer_data_bounds` from the tile lines alone, without decompressing
+     * any tile. The bounds are aligned to tiles and split into a grid of `_columns` by `_rows` tile-sized cells,
+     * which is the layout of the occupancy bitmap filled by `kra_imp_get_layer_data_occupancy`.
+     */
+    struct KRA_IMP_API kra_imp_layer_data_bounds_t
+    {
+        int _x_offset;         /**< Horizontal position of the left edge of the bounds in the image. */
+        int _y_offset;         /**< Vertical position of the top edge of the bounds in the image. */
+        unsigned int _width;   /**< Width of the bounds in pixels. */
+        unsigned int _height;  /**< Height of the bounds in pixels. */
+        unsigned int _columns; /**< Number of tile-sized cells across the bounds. */
+        unsigned int _rows;    /**< Number of tile-sized cells down the bounds. */
+    };
+    typedef struct kra_imp_layer_data_bounds_t kra_imp_layer_data_bounds_t;
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type allocating the buffer for a file loaded from an archive.
+     *
+     * @param user_data User pointer passed to the loading function, e.g. an arena the buffer is placed in.
+     * @param file_size Uncompressed size of the file in bytes, never 0.
+     * @return Pointer to a buffer of at least `file_size` bytes, or NULL (nullptr) if allocation fails.
+     */
+    typedef char* (*kra_imp_file_allocation_function)(void* user_data, unsigned long long file_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type receiving consecutive chunks of a file streamed from an archive.
+     *
+     * @param user_data User pointer passed to the streaming function.
+     * @param chunk Pointer to the next decompressed bytes of the file, valid only during the call.
+     * @param chunk_size Number of bytes in the chunk.
+     * @return KRA_IMP_SUCCESS to continue streaming, any other value stops it and is returned by the streaming function.
+     */
+    typedef kra_imp_error_code_e (*kra_imp_file_chunk_function)(void* user_data, const char* chunk, unsigned long long chunk_size);
+    /**
+     * @ingroup kra_imp
+     *
+     * @brief Function pointer type receiving tiles of streamed layer data.
+     *
+     * @param user_data User pointer passed when the stream was opened.
+     * @param layer_data_header Header of the streamed layer data.
+     * @param tile The tile which bytes are complete. Its payload is valid only during the call.
+     * @return KRA_IMP_SUCCESS to continue streaming, any other value stops it and is returned by the streaming function.
+     */
+    typedef kra_imp_error_code_e (*kra_imp_layer_data_tile_function)(void* user_data, const kra_imp_layer_data_header_t* layer_data_header, const kra_imp_layer_data_tile_t* tile);
+    /**
+     * @struct kra_imp_layer_data_stream_t
+     *
+     * @brief Represents an incremental parser of layer data fed in chunks.
+     *
+     * @details
+     * The stream keeps only the bytes of a record (the header or a single tile) split between two chunks,
+     * so its memory usage is bounded by the size of one tile, regardless of the size of the layer data.
+     *
+     * The `kra_imp_layer_data_stream_t` must be created using `kra_imp_open_layer_data_stream` and closed
+     * using `kra_imp_close_layer_data_stream` to release allocated resources.
+     *
+     * @note The structure's internal implementation is opaque to the user and is
+     * fully managed by the API.
+     */
+    struct KRA_IMP_API kra_imp_layer_data_stream_t;
+    typedef struct kra_imp_layer_data_stream_t kra_imp_layer_data_stream_t;
+    /**
+     * @struct kra_imp_tile_offset_t
+     *
+     * @brief Represents the position of a tile in the image.
+     */
+    struct KRA_IMP_API kra_imp_tile_offset_t
+    {
+        int _x_offset; /**< Horizontal offset of the tile in the image. */
+        int _y_offset; /**< Vertical offset of the tile in the image. */
+    };
+    typedef struct kra_imp_tile_offset_t kra_imp_tile_offset_t;
+    /**
+     * @struct kra_imp_layer_data_atlas_t
+     *
+     * @brief Represents the output of decoding all tiles of a layer at once.
+     *
+     * @details
+     * This structure describes a caller-provided tile atlas filled by `kra_imp_read_layer_data_atlas`.
+     * Decoded tiles are stored one after another in `_buffer`, so tile `i` starts at byte
+     * `i * _layer_data_width * _layer_data_height * _layer_data_pixel_size`, and its position in the image
+     * is stored in `_offsets[i]`.
+     *
+     * @note Tiles are stored in the same planar layout as produced by `kra_imp_read_layer_data`.
+     */
+    struct KRA_IMP_API kra_imp_layer_data_atlas_t
+    {
+        char* _buffer;                   /**< Pointer to the buffer receiving the decoded tiles. */
+        unsigned long long _buffer_size; /**< Size of the buffer in bytes. */
+        kra_imp_tile_offset_t* _offsets; /**< Pointer to the array receiving the offsets of the decoded tiles. */
+        unsigned int _offsets_count;     /**< Number of elements in the offsets array. */
+    };
+    typedef struct kra_imp_layer_data_atlas_t kra_imp_layer_data_atlas_t;
+    /**
+     * @struct kra_imp_executor_t
+     *
+     * @brief Represents a user-provided task executor.
+     *
+     * @details
+     * This structure allows kra_imp to run independent work, such as tile decompression, on the
+     * user's own job system instead of spawning threads on its own. The library submits tasks
+     * with `_submit` and then calls `_wait` once to wait for all of them.
+     */
+    struct KRA_IMP_API kra_imp_executor_t
+    {
+        kra_imp_submit_task_function _submit; /**< Function submitting a task to the executor. */
+        kra_imp_wait_tasks_function _wait;    /**< Function waiting for all submitted tasks to finish. */
+        void* _context;                       /**< User context pointer passed to `_submit` and `_wait`. */
+        unsigned int _workers_count;          /**< Number of workers available, used to decide how to split the work. */
+    };
+    typedef struct kra_imp_executor_t kra_imp_executor_t;
     /**
      * @struct kra_imp_delinerize_output_t
      *
@@ -283,6 +572,90 @@ extern "C"
         unsigned int _width;             /**< Width of the data in pixels. */
     };
     typedef struct kra_imp_delinerize_output_t kra_imp_delinerize_output_t;
+    /**
+     * @struct kra_imp_canvas_t
+     *
+     * @brief Represents a full-size interleaved output image.
+     *
+     * @details
+     * This structure describes a caller-provided buffer holding a whole image in interleaved BGRA format,
+     * 4 bytes per pixel, row after row. Tiles decoded into a canvas are placed at their offsets, and parts
+     * of tiles falling outside of the canvas are clipped.
+     */
+    struct KRA_IMP_API kra_imp_canvas_t
+    {
+        char* _buffer;                   /**< Pointer to the buffer containing the canvas pixels. */
+        unsigned long long _buffer_size; /**< Size of the buffer in bytes. */
+        unsigned int _width;             /**< Width of the canvas in pixels. */
+        unsigned int _height;            /**< Height of the canvas in pixels. */
+    };
+    typedef struct kra_imp_canvas_t kra_imp_canvas_t;
+    /**
+     * @struct kra_imp_color_conversion_t
+     *
+     * @brief Describes a conversion of pixels to 8-bit sRGB.
+     *
+     * @details
+     * This structure pairs the color format of the source pixels, usually taken from `kra_imp_main_doc_t`,
+     * with the channel order of the 8-bit output pixels.
+     */
+    struct KRA_IMP_API kra_imp_color_conversion_t
+    {
+        kra_imp_color_space_model_e _color_space_model; /**< The color space model of the source pixels. */
+        kra_imp_channel_depth_e _channel_depth;         /**< The channel depth of the source pixels. */
+        kra_imp_pixel_order_e _pixel_order;             /**< The channel order of the output pixels, BGRA or RGBA; ARGB is rejected. */
+    };
+    typedef struct kra_imp_color_conversion_t kra_imp_color_conversion_t;
+    /**
+     * @struct kra_imp_pixel_format_t
+     *
+     * @brief Describes the format of pixels written by `kra_imp_delinearize_to_format`.
+     *
+     * @details
+     * Output pixels have four channels of `_channel_depth` each: 8 or 16-bit unsigned integers, or 32-bit floats
+     * ranging from 0 to 1.
+     */
+    struct KRA_IMP_API kra_imp_pixel_format_t
+    {
+        kra_imp_pixel_order_e _pixel_order;     /**< The channel order of the output pixels. */
+        kra_imp_alpha_mode_e _alpha_mode;       /**< Whether color channels are premultiplied by alpha. */
+        kra_imp_channel_depth_e _channel_depth; /**< The channel depth of the output pixels: U8, U16 or F32. */
+    };
+    typedef struct kra_imp_pixel_format_t kra_imp_pixel_format_t;
+    /**
+     * @struct kra_imp_sparse_canvas_t
+     *
+     * @brief Represents a BGRA image stored only where tiles were painted.
+     *
+     * @details
+     * The sparse canvas keeps a grid of tile-sized slots keyed by their position, allocated in pooled pages as tiles
+     * are decoded into it. Memory usage depends on the painted area only, not on the size of the document.
+     *
+     * The `kra_imp_sparse_canvas_t` must be created using `kra_imp_open_sparse_canvas` and closed
+     * using `kra_imp_close_sparse_canvas` to release allocated resources.
+     *
+     * @note The structure's internal implementation is opaque to the user and is
+     * fully managed by the API.
+     */
+    struct KRA_IMP_API kra_imp_sparse_canvas_t;
+    typedef struct kra_imp_sparse_canvas_t kra_imp_sparse_canvas_t;
+    /**
+     * @struct kra_imp_sparse_canvas_tile_t
+     *
+     * @brief Represents a single slot of a sparse canvas.
+     *
+     * @details
+     * The pixels are stored in interleaved BGRA format, 4 bytes per pixel, row after row, and remain valid until
+     * the sparse canvas is closed. Pixels never written by a decoded tile are zero.
+     */
+    struct KRA_IMP_API kra_imp_sparse_canvas_tile_t
+    {
+        const char* _data;       /**< Pointer to the pixels of the slot. */
+        unsigned int _data_size; /**< Size of the pixels in bytes. */
+        int _x_offset;           /**< Horizontal position of the slot in the image. */
+        int _y_offset;           /**< Vertical position of the slot in the image. */
+    };
+    typedef struct kra_imp_sparse_canvas_tile_t kra_imp_sparse_canvas_tile_t;
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,611 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "color_conversion.hpp"
+#include "cpu_features.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+static constexpr const unsigned long long KRA_IMP_CONVERSION_BATCH_SIZE{ 64ULL };
+static constexpr const unsigned int KRA_IMP_SRGB_TABLE_SIZE{ 4096U };
+static constexpr const unsigned int KRA_IMP_OUTPUT_PIXEL_SIZE{ 4U };
+
+struct float_batch_t
+{
+    std::array<float, KRA_IMP_CONVERSION_BATCH_SIZE> _red;
+    std::array<float, KRA_IMP_CONVERSION_BATCH_SIZE> _green;
+    std::array<float, KRA_IMP_CONVERSION_BATCH_SIZE> _blue;
+    std::array<float, KRA_IMP_CONVERSION_BATCH_SIZE> _alpha;
+};
+
+static constexpr unsigned int get_channels_count(const kra_imp_color_space_model_e color_space_model)
+{
+    switch (color_space_model)
+    {
+    case KRA_IMP_GRAYA_COLOR_SPACE_MODEL:
+        return 2U;
+    case KRA_IMP_CMYK_COLOR_SPACE_MODEL:
+        return 5U;
+    case KRA_IMP_CIELAB_COLOR_SPACE_MODEL:
+    case KRA_IMP_RGBA_COLOR_SPACE_MODEL:
+    case KRA_IMP_XYZA_COLOR_SPACE_MODEL:
+    case KRA_IMP_YCBCR_COLOR_SPACE_MODEL:
+        return 4U;
+    default:
+        return 0U;
+    }
+}
+
+static constexpr unsigned int get_channel_size(const kra_imp_channel_depth_e channel_depth)
+{
+    switch (channel_depth)
+    {
+    case KRA_IMP_U8_CHANNEL_DEPTH:
+        return 1U;
+    case KRA_IMP_U16_CHANNEL_DEPTH:
+    case KRA_IMP_F16_CHANNEL_DEPTH:
+        return 2U;
+    case KRA_IMP_F32_CHANNEL_DEPTH:
+        return 4U;
+    default:
+        return 0U;
+    }
+}
+
+unsigned int get_color_format_pixel_size(const kra_imp_color_space_model_e color_space_model, const kra_imp_channel_depth_e channel_depth)
+{
+    return get_channels_count(color_space_model) * get_channel_size(channel_depth);
+}
+
+static unsigned char narrow_channel(const std::uint16_t value)
+{
+    // Rounds value / 257 to the nearest integer, the same way the SIMD kernels do with saturating 16-bit arithmetic.
+    const unsigned int rounded = std::min(value + 128U, 65535U);
+    return static_cast<unsigned char>((rounded - (rounded >> 8U)) >> 8U);
+}
+
+static unsigned char multiply_channels(const unsigned int first, const unsigned int second)
+{
+    const unsigned int product = first * second + 128U;
+    return static_cast<unsigned char>((product + (product >> 8U)) >> 8U);
+}
+
+static float half_to_float(const std::uint16_t value)
+{
+    const std::uint32_t sign = static_cast<std::uint32_t>(value & 0x8000U) << 16U;
+    const std::uint32_t exponent = (value >> 10U) & 0x1FU;
+    const std::uint32_t mantissa = value & 0x3FFU;
+    if (exponent == 0U)
+    {
+        const float subnormal = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+        return sign == 0U ? subnormal : -subnormal;
+    }
+
+    const std::uint32_t bits = exponent == 0x1FU ? sign | 0x7F800000U | (mantissa << 13U) : sign | ((exponent + 112U) << 23U) | (mantissa << 13U);
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static float clamp_channel(const float value)
+{
+    // Written so that NaN is clamped to 0.
+    return std::min(1.0f, std::max(0.0f, value));
+}
+
+static const std::array<unsigned char, KRA_IMP_SRGB_TABLE_SIZE>& get_srgb_table()
+{
+    static const std::array<unsigned char, KRA_IMP_SRGB_TABLE_SIZE> SRGB_TABLE = []()
+    {
+        std::array<unsigned char, KRA_IMP_SRGB_TABLE_SIZE> table{};
+        for (unsigned int index = 0U; index < KRA_IMP_SRGB_TABLE_SIZE; ++index)
+        {
+            const double linear = static_cast<double>(index) / (KRA_IMP_SRGB_TABLE_SIZE - 1U);
+            const double encoded = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            table[index] = static_cast<unsigned char>(encoded * 255.0 + 0.5);
+        }
+        return table;
+    }();
+    return SRGB_TABLE;
+}
+
+static unsigned int get_red_index(const kra_imp_pixel_order_e pixel_order)
+{
+    return pixel_order == KRA_IMP_RGBA_PIXEL_ORDER ? 0U : 2U;
+}
+
+static void convert_rgba_u8_scalar(const char* input, char* output, const unsigned long long first_pixel, const unsigned long long pixels_count,
+                                   const kra_imp_pixel_order_e pixel_order)
+{
+    const unsigned int red_index = get_red_index(pixel_order);
+    for (unsigned long long x = first_pixel; x < pixels_count; ++x)
+    {
+        const char* pixel = input + x * 4U;
+        char* output_pixel = output + x * KRA_IMP_OUTPUT_PIXEL_SIZE;
+        output_pixel[red_index] = pixel[2];
+        output_pixel[1] = pixel[1];
+        output_pixel[2U - red_index] = pixel[0];
+        output_pixel[3] = pixel[3];
+    }
+}
+
+static void convert_rgba_u8_scalar(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    convert_rgba_u8_scalar(input, output, 0ULL, pixels_count, pixel_order);
+}
+
+static void convert_rgba_u16_scalar(const char* input, char* output, const unsigned long long first_pixel, const unsigned long long pixels_count,
+                                    const kra_imp_pixel_order_e pixel_order)
+{
+    const unsigned int red_index = get_red_index(pixel_order);
+    for (unsigned long long x = first_pixel; x < pixels_count; ++x)
+    {
+        std::array<std::uint16_t, 4> channels;
+        std::memcpy(channels.data(), input + x * 8U, sizeof(channels));
+        unsigned char* output_pixel = reinterpret_cast<unsigned char*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE);
+        output_pixel[red_index] = narrow_channel(channels[2]);
+        output_pixel[1] = narrow_channel(channels[1]);
+        output_pixel[2U - red_index] = narrow_channel(channels[0]);
+        output_pixel[3] = narrow_channel(channels[3]);
+    }
+}
+
+static void convert_rgba_u16_scalar(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    convert_rgba_u16_scalar(input, output, 0ULL, pixels_count, pixel_order);
+}
+
+static void convert_graya_u8_scalar(const char* input, char* output, const unsigned long long first_pixel, const unsigned long long pixels_count)
+{
+    for (unsigned long long x = first_pixel; x < pixels_count; ++x)
+    {
+        char* output_pixel = output + x * KRA_IMP_OUTPUT_PIXEL_SIZE;
+        output_pixel[0] = input[x * 2U];
+        output_pixel[1] = input[x * 2U];
+        output_pixel[2] = input[x * 2U];
+        output_pixel[3] = input[x * 2U + 1U];
+    }
+}
+
+static void convert_graya_u8_scalar(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e)
+{
+    convert_graya_u8_scalar(input, output, 0ULL, pixels_count);
+}
+
+static void convert_graya_u16_scalar(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e)
+{
+    for (unsigned long long x = 0ULL; x < pixels_count; ++x)
+    {
+        std::array<std::uint16_t, 2> channels;
+        std::memcpy(channels.data(), input + x * 4U, sizeof(channels));
+        unsigned char* output_pixel = reinterpret_cast<unsigned char*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE);
+        output_pixel[0] = output_pixel[1] = output_pixel[2] = narrow_channel(channels[0]);
+        output_pixel[3] = narrow_channel(channels[1]);
+    }
+}
+
+static void convert_cmyk_u8_scalar(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    const unsigned int red_index = get_red_index(pixel_order);
+    const unsigned char* pixels = reinterpret_cast<const unsigned char*>(input);
+    for (unsigned long long x = 0ULL; x < pixels_count; ++x)
+    {
+        const unsigned char* pixel = pixels + x * 5U;
+        const unsigned int key = 255U - pixel[3];
+        unsigned char* output_pixel = reinterpret_cast<unsigned char*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE);
+        output_pixel[red_index] = multiply_channels(255U - pixel[0], key);
+        output_pixel[1] = multiply_channels(255U - pixel[1], key);
+        output_pixel[2U - red_index] = multiply_channels(255U - pixel[2], key);
+        output_pixel[3] = pixel[4];
+    }
+}
+
+#ifdef KRA_IMP_X86
+KRA_IMP_TARGET("sse2") static __m128i swap_red_blue_sse2(const __m128i pixels)
+{
+    const __m128i green_alpha = _mm_and_si128(pixels, _mm_set1_epi32(static_cast<int>(0xFF00FF00U)));
+    const __m128i low = _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32(0x000000FF));
+    const __m128i high = _mm_and_si128(_mm_slli_epi32(pixels, 16), _mm_set1_epi32(0x00FF0000));
+    return _mm_or_si128(green_alpha, _mm_or_si128(low, high));
+}
+
+KRA_IMP_TARGET("sse2") static __m128i narrow_channels_sse2(const __m128i channels)
+{
+    const __m128i rounded = _mm_adds_epu16(channels, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_sub_epi16(rounded, _mm_srli_epi16(rounded, 8)), 8);
+}
+
+KRA_IMP_TARGET("sse2")
+static void convert_rgba_u8_sse2(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    if (pixel_order == KRA_IMP_BGRA_PIXEL_ORDER)
+    {
+        std::memcpy(output, input, pixels_count * KRA_IMP_OUTPUT_PIXEL_SIZE);
+        return;
+    }
+
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 4ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + x * 4U));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE), swap_red_blue_sse2(pixels));
+    }
+    convert_rgba_u8_scalar(input, output, vector_pixels_count, pixels_count, pixel_order);
+}
+
+KRA_IMP_TARGET("sse2")
+static void convert_rgba_u16_sse2(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 4ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + x * 8U));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + x * 8U + 16U));
+        __m128i pixels = _mm_packus_epi16(narrow_channels_sse2(first), narrow_channels_sse2(second));
+        if (pixel_order == KRA_IMP_RGBA_PIXEL_ORDER)
+        {
+            pixels = swap_red_blue_sse2(pixels);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE), pixels);
+    }
+    convert_rgba_u16_scalar(input, output, vector_pixels_count, pixels_count, pixel_order);
+}
+
+KRA_IMP_TARGET("sse2")
+static void convert_graya_u8_sse2(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e)
+{
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 8ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + x * 2U));
+        const __m128i gray = _mm_and_si128(pixels, _mm_set1_epi16(0x00FF));
+        const __m128i gray_gray = _mm_or_si128(gray, _mm_slli_epi16(gray, 8));
+        char* output_pixels = output + x * KRA_IMP_OUTPUT_PIXEL_SIZE;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output_pixels), _mm_unpacklo_epi16(gray_gray, pixels));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output_pixels + 16U), _mm_unpackhi_epi16(gray_gray, pixels));
+    }
+    convert_graya_u8_scalar(input, output, vector_pixels_count, pixels_count);
+}
+#endif
+
+#ifdef KRA_IMP_NEON
+static uint8x8_t narrow_channels_neon(const uint16x8_t channels)
+{
+    const uint16x8_t rounded = vqaddq_u16(channels, vdupq_n_u16(128U));
+    return vmovn_u16(vshrq_n_u16(vsubq_u16(rounded, vshrq_n_u16(rounded, 8)), 8));
+}
+
+static void convert_rgba_u8_neon(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    if (pixel_order == KRA_IMP_BGRA_PIXEL_ORDER)
+    {
+        std::memcpy(output, input, pixels_count * KRA_IMP_OUTPUT_PIXEL_SIZE);
+        return;
+    }
+
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 16ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        uint8x16x4_t pixels = vld4q_u8(reinterpret_cast<const uint8_t*>(input + x * 4U));
+        const uint8x16_t blue = pixels.val[0];
+        pixels.val[0] = pixels.val[2];
+        pixels.val[2] = blue;
+        vst4q_u8(reinterpret_cast<uint8_t*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE), pixels);
+    }
+    convert_rgba_u8_scalar(input, output, vector_pixels_count, pixels_count, pixel_order);
+}
+
+static void convert_rgba_u16_neon(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    const unsigned int red_index = get_red_index(pixel_order);
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 8ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        const uint16x8x4_t channels = vld4q_u16(reinterpret_cast<const uint16_t*>(input + x * 8U));
+        uint8x8x4_t pixels;
+        pixels.val[red_index] = narrow_channels_neon(channels.val[2]);
+        pixels.val[1] = narrow_channels_neon(channels.val[1]);
+        pixels.val[2U - red_index] = narrow_channels_neon(channels.val[0]);
+        pixels.val[3] = narrow_channels_neon(channels.val[3]);
+        vst4_u8(reinterpret_cast<uint8_t*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE), pixels);
+    }
+    convert_rgba_u16_scalar(input, output, vector_pixels_count, pixels_count, pixel_order);
+}
+
+static void convert_graya_u8_neon(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e)
+{
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 16ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        const uint8x16x2_t channels = vld2q_u8(reinterpret_cast<const uint8_t*>(input + x * 2U));
+        const uint8x16x4_t pixels{ { channels.val[0], channels.val[0], channels.val[0], channels.val[1] } };
+        vst4q_u8(reinterpret_cast<uint8_t*>(output + x * KRA_IMP_OUTPUT_PIXEL_SIZE), pixels);
+    }
+    convert_graya_u8_scalar(input, output, vector_pixels_count, pixels_count);
+}
+#endif
+
+static convert_pixels_function select_rgba_u8_kernel()
+{
+#if defined(KRA_IMP_X86)
+    if (cpu_supports_sse2())
+    {
+        return convert_rgba_u8_sse2;
+    }
+#elif defined(KRA_IMP_NEON)
+    return convert_rgba_u8_neon;
+#endif
+    return convert_rgba_u8_scalar;
+}
+
+static convert_pixels_function select_rgba_u16_kernel()
+{
+#if defined(KRA_IMP_X86)
+    if (cpu_supports_sse2())
+    {
+        return convert_rgba_u16_sse2;
+    }
+#elif defined(KRA_IMP_NEON)
+    return convert_rgba_u16_neon;
+#endif
+    return convert_rgba_u16_scalar;
+}
+
+static convert_pixels_function select_graya_u8_kernel()
+{
+#if defined(KRA_IMP_X86)
+    if (cpu_supports_sse2())
+    {
+        return convert_graya_u8_sse2;
+    }
+#elif defined(KRA_IMP_NEON)
+    return convert_graya_u8_neon;
+#endif
+    return convert_graya_u8_scalar;
+}
+
+template <kra_imp_channel_depth_e CHANNEL_DEPTH> static float load_channel(const char* pixel, const unsigned int channel_index)
+{
+    if constexpr (CHANNEL_DEPTH == KRA_IMP_U8_CHANNEL_DEPTH)
+    {
+        return static_cast<float>(static_cast<unsigned char>(pixel[channel_index])) * (1.0f / 255.0f);
+    }
+    else if constexpr (CHANNEL_DEPTH == KRA_IMP_U16_CHANNEL_DEPTH)
+    {
+        std::uint16_t value;
+        std::memcpy(&value, pixel + channel_index * sizeof(value), sizeof(value));
+        return static_cast<float>(value) * (1.0f / 65535.0f);
+    }
+    else if constexpr (CHANNEL_DEPTH == KRA_IMP_F16_CHANNEL_DEPTH)
+    {
+        std::uint16_t value;
+        std::memcpy(&value, pixel + channel_index * sizeof(value), sizeof(value));
+        return half_to_float(value);
+    }
+    else
+    {
+        float value;
+        std::memcpy(&value, pixel + channel_index * sizeof(value), sizeof(value));
+        return value;
+    }
+}
+
+static float lab_to_xyz_component(const float value)
+{
+    static constexpr float EPSILON = 6.0f / 29.0f;
+    return value > EPSILON ? value * value * value : 3.0f * EPSILON * EPSILON * (value - 4.0f / 29.0f);
+}
+
+static void xyz_to_linear_srgb(const float x, const float y, const float z, float& red, float& green, float& blue)
+{
+    // XYZ relative to D50, as stored by Krita, adapted to the D65 white point of sRGB with the Bradford transform.
+    red = 3.1338561f * x - 1.6168667f * y - 0.4906146f * z;
+    green = -0.9787684f * x + 1.9161415f * y + 0.0334540f * z;
+    blue = 0.0719453f * x - 0.2289914f * y + 1.4052427f * z;
+}
+
+// Loads a pixel as red, green and blue, which are linear light for the models `is_linear_color_format` returns true for,
+// and sRGB encoded otherwise, and alpha.
+template <kra_imp_color_space_model_e COLOR_SPACE_MODEL, kra_imp_channel_depth_e CHANNEL_DEPTH>
+static void load_pixel(const char* pixel, float& red, float& green, float& blue, float& alpha)
+{
+    constexpr bool IS_FLOAT = CHANNEL_DEPTH == KRA_IMP_F16_CHANNEL_DEPTH || CHANNEL_DEPTH == KRA_IMP_F32_CHANNEL_DEPTH;
+    if constexpr (COLOR_SPACE_MODEL == KRA_IMP_RGBA_COLOR_SPACE_MODEL)
+    {
+        // Integer pixels are stored as BGRA, floating point pixels as RGBA.
+        red = load_channel<CHANNEL_DEPTH>(pixel, IS_FLOAT ? 0U : 2U);
+        green = load_channel<CHANNEL_DEPTH>(pixel, 1U);
+        blue = load_channel<CHANNEL_DEPTH>(pixel, IS_FLOAT ? 2U : 0U);
+        alpha = load_channel<CHANNEL_DEPTH>(pixel, 3U);
+    }
+    else if constexpr (COLOR_SPACE_MODEL == KRA_IMP_GRAYA_COLOR_SPACE_MODEL)
+    {
+        red = green = blue = load_channel<CHANNEL_DEPTH>(pixel, 0U);
+        alpha = load_channel<CHANNEL_DEPTH>(pixel, 1U);
+    }
+    else if constexpr (COLOR_SPACE_MODEL == KRA_IMP_CMYK_COLOR_SPACE_MODEL)
+    {
+        // Floating point ink channels range from 0 to 100.
+        constexpr float INK_SCALE = IS_FLOAT ? 0.01f : 1.0f;
+        const float key = 1.0f - load_channel<CHANNEL_DEPTH>(pixel, 3U) * INK_SCALE;
+        red = (1.0f - load_channel<CHANNEL_DEPTH>(pixel, 0U) * INK_SCALE) * key;
+        green = (1.0f - load_channel<CHANNEL_DEPTH>(pixel, 1U) * INK_SCALE) * key;
+        blue = (1.0f - load_channel<CHANNEL_DEPTH>(pixel, 2U) * INK_SCALE) * key;
+        alpha = load_channel<CHANNEL_DEPTH>(pixel, 4U);
+    }
+    else if constexpr (COLOR_SPACE_MODEL == KRA_IMP_CIELAB_COLOR_SPACE_MODEL)
+    {
+        // Floating point pixels store L from 0 to 100 and a, b from -128 to 127, integer pixels store them normalized.
+        // Krita's 16-bit L is the exception: 0xFF00 is L=100, and the values above it are clamped.
+        constexpr float LIGHTNESS_SCALE = IS_FLOAT ? 1.0f : (CHANNEL_DEPTH == KRA_IMP_U16_CHANNEL_DEPTH ? 100.0f * 65535.0f / 65280.0f : 100.0f);
+        constexpr float CHROMA_SCALE = IS_FLOAT ? 1.0f : 255.0f;
+        constexpr float CHROMA_OFFSET = IS_FLOAT ? 0.0f : 128.0f;
+        float lightness = load_channel<CHANNEL_DEPTH>(pixel, 0U) * LIGHTNESS_SCALE;
+        if constexpr (CHANNEL_DEPTH == KRA_IMP_U16_CHANNEL_DEPTH)
+        {
+            lightness = std::min(lightness, 100.0f);
+        }
+        const float a = load_channel<CHANNEL_DEPTH>(pixel, 1U) * CHROMA_SCALE - CHROMA_OFFSET;
+        const float b = load_channel<CHANNEL_DEPTH>(pixel, 2U) * CHROMA_SCALE - CHROMA_OFFSET;
+        const float fy = (lightness + 16.0f) / 116.0f;
+        const float x = 0.9642f * lab_to_xyz_component(fy + a / 500.0f);
+        const float y = lab_to_xyz_component(fy);
+        const float z = 0.8249f * lab_to_xyz_component(fy - b / 200.0f);
+        xyz_to_linear_srgb(x, y, z, red, green, blue);
+        alpha = load_channel<CHANNEL_DEPTH>(pixel, 3U);
+    }
+    else if constexpr (COLOR_SPACE_MODEL == KRA_IMP_XYZA_COLOR_SPACE_MODEL)
+    {
+        const float x = load_channel<CHANNEL_DEPTH>(pixel, 0U);
+        const float y = load_channel<CHANNEL_DEPTH>(pixel, 1U);
+        const float z = load_channel<CHANNEL_DEPTH>(pixel, 2U);
+        xyz_to_linear_srgb(x, y, z, red, green, blue);
+        alpha = load_channel<CHANNEL_DEPTH>(pixel, 3U);
+    }
+    else
+    {
+        // Full range BT.709, the primaries of Krita's default YCbCr profile.
+        constexpr float CHROMA_OFFSET = IS_FLOAT ? 0.5f : 128.0f / 255.0f;
+        const float luma = load_channel<CHANNEL_DEPTH>(pixel, 0U);
+        const float blue_difference = load_channel<CHANNEL_DEPTH>(pixel, 1U) - CHROMA_OFFSET;
+        const float red_difference = load_channel<CHANNEL_DEPTH>(pixel, 2U) - CHROMA_OFFSET;
+        red = luma + 1.5748f * red_difference;
+        green = luma - 0.1873f * blue_difference - 0.4681f * red_difference;
+        blue = luma + 1.8556f * blue_difference;
+        alpha = load_channel<CHANNEL_DEPTH>(pixel, 3U);
+    }
+}
+
+static constexpr bool is_linear_color_format(const kra_imp_color_space_model_e color_space_model, const kra_imp_channel_depth_e channel_depth)
+{
+    const bool is_float = channel_depth == KRA_IMP_F16_CHANNEL_DEPTH || channel_depth == KRA_IMP_F32_CHANNEL_DEPTH;
+    switch (color_space_model)
+    {
+    case KRA_IMP_CIELAB_COLOR_SPACE_MODEL:
+    case KRA_IMP_XYZA_COLOR_SPACE_MODEL:
+        return true;
+    case KRA_IMP_GRAYA_COLOR_SPACE_MODEL:
+    case KRA_IMP_RGBA_COLOR_SPACE_MODEL:
+        return is_float;
+    default:
+        return false;
+    }
+}
+
+template <bool IS_LINEAR>
+static void store_batch(const float_batch_t& batch, const unsigned long long pixels_count, char* output, const kra_imp_pixel_order_e pixel_order)
+{
+    const unsigned int red_index = get_red_index(pixel_order);
+    const std::array<unsigned char, KRA_IMP_SRGB_TABLE_SIZE>& srgb_table = get_srgb_table();
+    unsigned char* output_pixels = reinterpret_cast<unsigned char*>(output);
+    for (unsigned long long x = 0ULL; x < pixels_count; ++x)
+    {
+        unsigned char* output_pixel = output_pixels + x * KRA_IMP_OUTPUT_PIXEL_SIZE;
+        if constexpr (IS_LINEAR)
+        {
+            static constexpr float TABLE_SCALE = static_cast<float>(KRA_IMP_SRGB_TABLE_SIZE - 1U);
+            output_pixel[red_index] = srgb_table[static_cast<unsigned int>(clamp_channel(batch._red[x]) * TABLE_SCALE + 0.5f)];
+            output_pixel[1] = srgb_table[static_cast<unsigned int>(clamp_channel(batch._green[x]) * TABLE_SCALE + 0.5f)];
+            output_pixel[2U - red_index] = srgb_table[static_cast<unsigned int>(clamp_channel(batch._blue[x]) * TABLE_SCALE + 0.5f)];
+        }
+        else
+        {
+            output_pixel[red_index] = static_cast<unsigned char>(clamp_channel(batch._red[x]) * 255.0f + 0.5f);
+            output_pixel[1] = static_cast<unsigned char>(clamp_channel(batch._green[x]) * 255.0f + 0.5f);
+            output_pixel[2U - red_index] = static_cast<unsigned char>(clamp_channel(batch._blue[x]) * 255.0f + 0.5f);
+        }
+        output_pixel[3] = static_cast<unsigned char>(clamp_channel(batch._alpha[x]) * 255.0f + 0.5f);
+    }
+}
+
+// Converts pixels in batches: all pixels of a batch are loaded and converted to floats first, then encoded, so that
+// both loops are free of cross-iteration dependencies and the compiler can vectorize them.
+template <kra_imp_color_space_model_e COLOR_SPACE_MODEL, kra_imp_channel_depth_e CHANNEL_DEPTH>
+static void convert_pixels_batched(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order)
+{
+    constexpr unsigned int PIXEL_SIZE = get_channels_count(COLOR_SPACE_MODEL) * get_channel_size(CHANNEL_DEPTH);
+    float_batch_t batch;
+    for (unsigned long long first_pixel = 0ULL; first_pixel < pixels_count; first_pixel += KRA_IMP_CONVERSION_BATCH_SIZE)
+    {
+        const unsigned long long batch_size = std::min(KRA_IMP_CONVERSION_BATCH_SIZE, pixels_count - first_pixel);
+        const char* batch_input = input + first_pixel * PIXEL_SIZE;
+        for (unsigned long long x = 0ULL; x < batch_size; ++x)
+        {
+            load_pixel<COLOR_SPACE_MODEL, CHANNEL_DEPTH>(batch_input + x * PIXEL_SIZE, batch._red[x], batch._green[x], batch._blue[x], batch._alpha[x]);
+        }
+        store_batch<is_linear_color_format(COLOR_SPACE_MODEL, CHANNEL_DEPTH)>(batch, batch_size, output + first_pixel * KRA_IMP_OUTPUT_PIXEL_SIZE, pixel_order);
+    }
+}
+
+template <kra_imp_color_space_model_e COLOR_SPACE_MODEL> static convert_pixels_function find_batched_kernel(const kra_imp_channel_depth_e channel_depth)
+{
+    switch (channel_depth)
+    {
+    case KRA_IMP_U8_CHANNEL_DEPTH:
+        return convert_pixels_batched<COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH>;
+    case KRA_IMP_U16_CHANNEL_DEPTH:
+        return convert_pixels_batched<COLOR_SPACE_MODEL, KRA_IMP_U16_CHANNEL_DEPTH>;
+    case KRA_IMP_F16_CHANNEL_DEPTH:
+        return convert_pixels_batched<COLOR_SPACE_MODEL, KRA_IMP_F16_CHANNEL_DEPTH>;
+    case KRA_IMP_F32_CHANNEL_DEPTH:
+        return convert_pixels_batched<COLOR_SPACE_MODEL, KRA_IMP_F32_CHANNEL_DEPTH>;
+    default:
+        return nullptr;
+    }
+}
+
+convert_pixels_function find_convert_pixels_function(const kra_imp_color_space_model_e color_space_model, const kra_imp_channel_depth_e channel_depth)
+{
+    switch (color_space_model)
+    {
+    case KRA_IMP_RGBA_COLOR_SPACE_MODEL:
+        if (channel_depth == KRA_IMP_U8_CHANNEL_DEPTH)
+        {
+            static const convert_pixels_function RGBA_U8_KERNEL{ select_rgba_u8_kernel() };
+            return RGBA_U8_KERNEL;
+        }
+        if (channel_depth == KRA_IMP_U16_CHANNEL_DEPTH)
+        {
+            static const convert_pixels_function RGBA_U16_KERNEL{ select_rgba_u16_kernel() };
+            return RGBA_U16_KERNEL;
+        }
+        return find_batched_kernel<KRA_IMP_RGBA_COLOR_SPACE_MODEL>(channel_depth);
+    case KRA_IMP_GRAYA_COLOR_SPACE_MODEL:
+        if (channel_depth == KRA_IMP_U8_CHANNEL_DEPTH)
+        {
+            static const convert_pixels_function GRAYA_U8_KERNEL{ select_graya_u8_kernel() };
+            return GRAYA_U8_KERNEL;
+        }
+        if (channel_depth == KRA_IMP_U16_CHANNEL_DEPTH)
+        {
+            return convert_graya_u16_scalar;
+        }
+        return find_batched_kernel<KRA_IMP_GRAYA_COLOR_SPACE_MODEL>(channel_depth);
+    case KRA_IMP_CMYK_COLOR_SPACE_MODEL:
+        if (channel_depth == KRA_IMP_U8_CHANNEL_DEPTH)
+        {
+            return convert_cmyk_u8_scalar;
+        }
+        return find_batched_kernel<KRA_IMP_CMYK_COLOR_SPACE_MODEL>(channel_depth);
+    case KRA_IMP_CIELAB_COLOR_SPACE_MODEL:
+        return find_batched_kernel<KRA_IMP_CIELAB_COLOR_SPACE_MODEL>(channel_depth);
+    case KRA_IMP_XYZA_COLOR_SPACE_MODEL:
+        return find_batched_kernel<KRA_IMP_XYZA_COLOR_SPACE_MODEL>(channel_depth);
+    case KRA_IMP_YCBCR_COLOR_SPACE_MODEL:
+        return find_batched_kernel<KRA_IMP_YCBCR_COLOR_SPACE_MODEL>(channel_depth);
+    default:
+        return nullptr;
+    }
+}
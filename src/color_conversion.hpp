@@ -0,0 +1,45 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+#include "kra_imp/types.hpp"
+
+/**
+ * @brief Largest size, in bytes, of a pixel of any supported color format (CMYKA with 32-bit float channels).
+ */
+static constexpr const unsigned int KRA_IMP_MAX_COLOR_PIXEL_SIZE{ 20U };
+
+/**
+ * @brief Kernel converting interleaved pixels of one color format to 8-bit BGRA or RGBA pixels.
+ *
+ * @param[in] input Interleaved pixels in Krita's channel order, as written by the delinearize kernels.
+ * @param[out] output Buffer receiving the converted pixels, at least `pixels_count * 4` bytes.
+ * @param[in] pixels_count Number of pixels to convert.
+ * @param[in] pixel_order Order of the channels of the output pixels.
+ */
+using convert_pixels_function = void (*)(const char* input, char* output, const unsigned long long pixels_count, const kra_imp_pixel_order_e pixel_order);
+
+/**
+ * @brief Gets the size of a pixel of the given color format.
+ *
+ * @return Size of the pixel in bytes, or 0 if the color format is not supported.
+ */
+unsigned int get_color_format_pixel_size(const kra_imp_color_space_model_e color_space_model, const kra_imp_channel_depth_e channel_depth);
+
+/**
+ * @brief Finds the kernel converting pixels of the given color format.
+ *
+ * @details
+ * 8-bit RGBA and GRAYA pixels, and 16-bit RGBA pixels, are converted with SIMD kernels (SSE2 or NEON) working on integers,
+ * and 8-bit CMYKA and 16-bit GRAYA pixels with scalar integer kernels. Other formats are converted in batches of floats,
+ * which the compiler vectorizes, and linear light colors are encoded to sRGB through a lookup table. Conversions do not
+ * use ICC profiles. Integer RGBA and GRAYA pixels, and all CMYKA and YCbCrA pixels, are taken as sRGB encoded, and
+ * floating point RGBA and GRAYA pixels as linear light with sRGB primaries. CIELAB and XYZA pixels are taken as relative
+ * to the D50 white point.
+ *
+ * @return The kernel, or nullptr if the color format is not supported.
+ */
+convert_pixels_function find_convert_pixels_function(const kra_imp_color_space_model_e color_space_model, const kra_imp_channel_depth_e channel_depth);
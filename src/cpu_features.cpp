@@ -0,0 +1,42 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "cpu_features.hpp"
+
+#ifdef KRA_IMP_X86
+bool cpu_supports_sse2()
+{
+#    if defined(_M_X64) || defined(__x86_64__)
+    return true;
+#    elif defined(_MSC_VER)
+    int cpu_info[4]{};
+    __cpuid(cpu_info, 1);
+    return (cpu_info[3] & (1 << 26)) != 0;
+#    else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#    endif
+}
+
+bool cpu_supports_avx2()
+{
+#    ifdef _MSC_VER
+    int cpu_info[4]{};
+    __cpuid(cpu_info, 0);
+    if (cpu_info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(cpu_info, 1);
+    const bool os_saves_ymm = (cpu_info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(cpu_info, 7, 0);
+    return os_saves_ymm && (cpu_info[1] & (1 << 5)) != 0;
+#    else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+#endif
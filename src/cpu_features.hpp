@@ -0,0 +1,36 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define KRA_IMP_X86
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || (defined(__ARM_NEON) && defined(__ARM_NEON__))
+#    define KRA_IMP_NEON
+#    include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#    define KRA_IMP_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#else
+#    define KRA_IMP_TARGET(instruction_set)
+#endif
+
+#ifdef KRA_IMP_X86
+/**
+ * @brief Checks whether the CPU supports SSE2 instructions.
+ */
+bool cpu_supports_sse2();
+
+/**
+ * @brief Checks whether the CPU and operating system support AVX2 instructions.
+ */
+bool cpu_supports_avx2();
+#endif
@@ -0,0 +1,661 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "delinearize.hpp"
+#include "cpu_features.hpp"
+#include "kernels.hpp"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+template <unsigned int PIXEL_SIZE>
+static void delinearize_row_scalar(const char* const* planes, char* output, const unsigned long long first_pixel, const unsigned long long pixels_count)
+{
+    for (unsigned long long x = first_pixel; x < pixels_count; ++x)
+    {
+        for (unsigned int plane_index = 0U; plane_index < PIXEL_SIZE; ++plane_index)
+        {
+            output[x * PIXEL_SIZE + plane_index] = planes[plane_index][x];
+        }
+    }
+}
+
+template <unsigned int PIXEL_SIZE> static void delinearize_row_scalar(const char* const* planes, const unsigned int, char* output, const unsigned long long pixels_count)
+{
+    delinearize_row_scalar<PIXEL_SIZE>(planes, output, 0ULL, pixels_count);
+}
+
+static void delinearize_row_generic(const char* const* planes, const unsigned int pixel_size, char* output, const unsigned long long pixels_count)
+{
+    for (unsigned long long x = 0ULL; x < pixels_count; ++x)
+    {
+        for (unsigned int plane_index = 0U; plane_index < pixel_size; ++plane_index)
+        {
+            output[x * pixel_size + plane_index] = planes[plane_index][x];
+        }
+    }
+}
+
+// The SIMD kernels transpose PIXEL_SIZE vectors, one per byte plane, in log2(PIXEL_SIZE) levels. At every level,
+// vectors holding neighbouring byte groups of the same pixels are unpacked together, which doubles the width of
+// the groups and halves the number of pixels per vector, until every vector holds whole pixels.
+#ifdef KRA_IMP_X86
+template <unsigned int ELEMENT_SIZE> KRA_IMP_TARGET("sse2") static __m128i unpack_low_sse2(const __m128i first, const __m128i second)
+{
+    if constexpr (ELEMENT_SIZE == 1U)
+    {
+        return _mm_unpacklo_epi8(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 2U)
+    {
+        return _mm_unpacklo_epi16(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 4U)
+    {
+        return _mm_unpacklo_epi32(first, second);
+    }
+    else
+    {
+        return _mm_unpacklo_epi64(first, second);
+    }
+}
+
+template <unsigned int ELEMENT_SIZE> KRA_IMP_TARGET("sse2") static __m128i unpack_high_sse2(const __m128i first, const __m128i second)
+{
+    if constexpr (ELEMENT_SIZE == 1U)
+    {
+        return _mm_unpackhi_epi8(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 2U)
+    {
+        return _mm_unpackhi_epi16(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 4U)
+    {
+        return _mm_unpackhi_epi32(first, second);
+    }
+    else
+    {
+        return _mm_unpackhi_epi64(first, second);
+    }
+}
+
+template <unsigned int PIXEL_SIZE, unsigned int ELEMENT_SIZE> KRA_IMP_TARGET("sse2") static void interleave_vectors_sse2(__m128i (&vectors)[PIXEL_SIZE])
+{
+    if constexpr (ELEMENT_SIZE < PIXEL_SIZE)
+    {
+        // Vector `group * ELEMENT_SIZE + block` holds byte group `group` of the pixels in block `block`.
+        __m128i interleaved[PIXEL_SIZE];
+        for (unsigned int group = 0U; group < PIXEL_SIZE / ELEMENT_SIZE / 2U; ++group)
+        {
+            for (unsigned int block = 0U; block < ELEMENT_SIZE; ++block)
+            {
+                const __m128i first = vectors[2U * group * ELEMENT_SIZE + block];
+                const __m128i second = vectors[(2U * group + 1U) * ELEMENT_SIZE + block];
+                interleaved[group * 2U * ELEMENT_SIZE + 2U * block] = unpack_low_sse2<ELEMENT_SIZE>(first, second);
+                interleaved[group * 2U * ELEMENT_SIZE + 2U * block + 1U] = unpack_high_sse2<ELEMENT_SIZE>(first, second);
+            }
+        }
+        for (unsigned int vector_index = 0U; vector_index < PIXEL_SIZE; ++vector_index)
+        {
+            vectors[vector_index] = interleaved[vector_index];
+        }
+        interleave_vectors_sse2<PIXEL_SIZE, ELEMENT_SIZE * 2U>(vectors);
+    }
+}
+
+template <unsigned int PIXEL_SIZE>
+KRA_IMP_TARGET("sse2") static void delinearize_row_sse2(const char* const* planes, const unsigned int, char* output, const unsigned long long pixels_count)
+{
+    static constexpr unsigned long long PIXELS_PER_STEP{ 16ULL };
+    unsigned long long x = 0ULL;
+    for (; x + PIXELS_PER_STEP <= pixels_count; x += PIXELS_PER_STEP)
+    {
+        __m128i vectors[PIXEL_SIZE];
+        for (unsigned int plane_index = 0U; plane_index < PIXEL_SIZE; ++plane_index)
+        {
+            vectors[plane_index] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[plane_index] + x));
+        }
+        interleave_vectors_sse2<PIXEL_SIZE, 1U>(vectors);
+        __m128i* pixels = reinterpret_cast<__m128i*>(output + x * PIXEL_SIZE);
+        for (unsigned int vector_index = 0U; vector_index < PIXEL_SIZE; ++vector_index)
+        {
+            _mm_storeu_si128(pixels + vector_index, vectors[vector_index]);
+        }
+    }
+    delinearize_row_scalar<PIXEL_SIZE>(planes, output, x, pixels_count);
+}
+
+template <unsigned int ELEMENT_SIZE> KRA_IMP_TARGET("avx2") static __m256i unpack_low_avx2(const __m256i first, const __m256i second)
+{
+    if constexpr (ELEMENT_SIZE == 1U)
+    {
+        return _mm256_unpacklo_epi8(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 2U)
+    {
+        return _mm256_unpacklo_epi16(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 4U)
+    {
+        return _mm256_unpacklo_epi32(first, second);
+    }
+    else
+    {
+        return _mm256_unpacklo_epi64(first, second);
+    }
+}
+
+template <unsigned int ELEMENT_SIZE> KRA_IMP_TARGET("avx2") static __m256i unpack_high_avx2(const __m256i first, const __m256i second)
+{
+    if constexpr (ELEMENT_SIZE == 1U)
+    {
+        return _mm256_unpackhi_epi8(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 2U)
+    {
+        return _mm256_unpackhi_epi16(first, second);
+    }
+    else if constexpr (ELEMENT_SIZE == 4U)
+    {
+        return _mm256_unpackhi_epi32(first, second);
+    }
+    else
+    {
+        return _mm256_unpackhi_epi64(first, second);
+    }
+}
+
+template <unsigned int PIXEL_SIZE, unsigned int ELEMENT_SIZE> KRA_IMP_TARGET("avx2") static void interleave_vectors_avx2(__m256i (&vectors)[PIXEL_SIZE])
+{
+    if constexpr (ELEMENT_SIZE < PIXEL_SIZE)
+    {
+        __m256i interleaved[PIXEL_SIZE];
+        for (unsigned int group = 0U; group < PIXEL_SIZE / ELEMENT_SIZE / 2U; ++group)
+        {
+            for (unsigned int block = 0U; block < ELEMENT_SIZE; ++block)
+            {
+                const __m256i first = vectors[2U * group * ELEMENT_SIZE + block];
+                const __m256i second = vectors[(2U * group + 1U) * ELEMENT_SIZE + block];
+                interleaved[group * 2U * ELEMENT_SIZE + 2U * block] = unpack_low_avx2<ELEMENT_SIZE>(first, second);
+                interleaved[group * 2U * ELEMENT_SIZE + 2U * block + 1U] = unpack_high_avx2<ELEMENT_SIZE>(first, second);
+            }
+        }
+        for (unsigned int vector_index = 0U; vector_index < PIXEL_SIZE; ++vector_index)
+        {
+            vectors[vector_index] = interleaved[vector_index];
+        }
+        interleave_vectors_avx2<PIXEL_SIZE, ELEMENT_SIZE * 2U>(vectors);
+    }
+}
+
+template <unsigned int PIXEL_SIZE>
+KRA_IMP_TARGET("avx2") static void delinearize_row_avx2(const char* const* planes, const unsigned int, char* output, const unsigned long long pixels_count)
+{
+    static constexpr unsigned long long PIXELS_PER_STEP{ 32ULL };
+    unsigned long long x = 0ULL;
+    for (; x + PIXELS_PER_STEP <= pixels_count; x += PIXELS_PER_STEP)
+    {
+        __m256i vectors[PIXEL_SIZE];
+        for (unsigned int plane_index = 0U; plane_index < PIXEL_SIZE; ++plane_index)
+        {
+            vectors[plane_index] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(planes[plane_index] + x));
+        }
+        // Unpacking works within 128-bit lanes, so the low lanes hold the first 16 pixels of the step and the high lanes the rest.
+        interleave_vectors_avx2<PIXEL_SIZE, 1U>(vectors);
+        __m256i* pixels = reinterpret_cast<__m256i*>(output + x * PIXEL_SIZE);
+        for (unsigned int vector_index = 0U; vector_index < PIXEL_SIZE / 2U; ++vector_index)
+        {
+            _mm256_storeu_si256(pixels + vector_index, _mm256_permute2x128_si256(vectors[2U * vector_index], vectors[2U * vector_index + 1U], 0x20));
+            _mm256_storeu_si256(pixels + PIXEL_SIZE / 2U + vector_index,
+                                _mm256_permute2x128_si256(vectors[2U * vector_index], vectors[2U * vector_index + 1U], 0x31));
+        }
+    }
+    delinearize_row_scalar<PIXEL_SIZE>(planes, output, x, pixels_count);
+}
+#endif
+
+#ifdef KRA_IMP_NEON
+template <unsigned int PIXEL_SIZE>
+static void delinearize_row_neon(const char* const* planes, const unsigned int, char* output, const unsigned long long pixels_count)
+{
+    static constexpr unsigned long long PIXELS_PER_STEP{ 16ULL };
+    unsigned long long x = 0ULL;
+    for (; x + PIXELS_PER_STEP <= pixels_count; x += PIXELS_PER_STEP)
+    {
+        uint8x16_t vectors[PIXEL_SIZE];
+        for (unsigned int plane_index = 0U; plane_index < PIXEL_SIZE; ++plane_index)
+        {
+            vectors[plane_index] = vld1q_u8(reinterpret_cast<const uint8_t*>(planes[plane_index] + x));
+        }
+
+        char* pixels = output + x * PIXEL_SIZE;
+        if constexpr (PIXEL_SIZE == 2U)
+        {
+            vst2q_u8(reinterpret_cast<uint8_t*>(pixels), uint8x16x2_t{ { vectors[0], vectors[1] } });
+        }
+        else if constexpr (PIXEL_SIZE == 4U)
+        {
+            vst4q_u8(reinterpret_cast<uint8_t*>(pixels), uint8x16x4_t{ { vectors[0], vectors[1], vectors[2], vectors[3] } });
+        }
+        else
+        {
+            // Byte planes are zipped into 16-bit (and for 16 byte pixels 32-bit) groups, which the structured stores interleave.
+            uint8x16x2_t pairs[PIXEL_SIZE / 2U];
+            for (unsigned int pair_index = 0U; pair_index < PIXEL_SIZE / 2U; ++pair_index)
+            {
+                pairs[pair_index] = vzipq_u8(vectors[2U * pair_index], vectors[2U * pair_index + 1U]);
+            }
+
+            if constexpr (PIXEL_SIZE == 8U)
+            {
+                for (unsigned int half = 0U; half < 2U; ++half)
+                {
+                    const uint16x8x4_t groups{ { vreinterpretq_u16_u8(pairs[0].val[half]), vreinterpretq_u16_u8(pairs[1].val[half]),
+                                                 vreinterpretq_u16_u8(pairs[2].val[half]), vreinterpretq_u16_u8(pairs[3].val[half]) } };
+                    vst4q_u16(reinterpret_cast<uint16_t*>(pixels + half * 8U * PIXEL_SIZE), groups);
+                }
+            }
+            else
+            {
+                static_assert(PIXEL_SIZE == 16U, "Unsupported pixel size");
+                uint16x8x2_t quads[2][4];
+                for (unsigned int half = 0U; half < 2U; ++half)
+                {
+                    for (unsigned int quad_index = 0U; quad_index < 4U; ++quad_index)
+                    {
+                        quads[half][quad_index] =
+                            vzipq_u16(vreinterpretq_u16_u8(pairs[2U * quad_index].val[half]), vreinterpretq_u16_u8(pairs[2U * quad_index + 1U].val[half]));
+                    }
+                }
+                for (unsigned int block = 0U; block < 4U; ++block)
+                {
+                    const unsigned int half = block / 2U;
+                    const unsigned int part = block % 2U;
+                    const uint32x4x4_t groups{ { vreinterpretq_u32_u16(quads[half][0].val[part]), vreinterpretq_u32_u16(quads[half][1].val[part]),
+                                                 vreinterpretq_u32_u16(quads[half][2].val[part]), vreinterpretq_u32_u16(quads[half][3].val[part]) } };
+                    vst4q_u32(reinterpret_cast<uint32_t*>(pixels + block * 4U * PIXEL_SIZE), groups);
+                }
+            }
+        }
+    }
+    delinearize_row_scalar<PIXEL_SIZE>(planes, output, x, pixels_count);
+}
+#endif
+
+template <unsigned int PIXEL_SIZE> static delinearize_row_function select_delinearize_kernel()
+{
+#if defined(KRA_IMP_X86)
+    // Transposing 8 or more 256-bit vectors runs out of registers and ends up slower than SSE2.
+    if constexpr (PIXEL_SIZE <= 4U)
+    {
+        if (cpu_supports_avx2())
+        {
+            return delinearize_row_avx2<PIXEL_SIZE>;
+        }
+    }
+    if (cpu_supports_sse2())
+    {
+        return delinearize_row_sse2<PIXEL_SIZE>;
+    }
+#elif defined(KRA_IMP_NEON)
+    return delinearize_row_neon<PIXEL_SIZE>;
+#endif
+    return delinearize_row_scalar<PIXEL_SIZE>;
+}
+
+template <unsigned int PIXEL_SIZE> static delinearize_row_function get_delinearize_kernel()
+{
+    static const delinearize_row_function DELINEARIZE_KERNEL{ select_delinearize_kernel<PIXEL_SIZE>() };
+    return DELINEARIZE_KERNEL;
+}
+
+template <unsigned int PIXEL_SIZE> static void list_delinearize_kernels(kernels_t<delinearize_row_function>& kernels)
+{
+    kernels._kernels[kernels._kernels_count++] = { "scalar", delinearize_row_scalar<PIXEL_SIZE> };
+#if defined(KRA_IMP_X86)
+    if (cpu_supports_sse2())
+    {
+        kernels._kernels[kernels._kernels_count++] = { "sse2", delinearize_row_sse2<PIXEL_SIZE> };
+    }
+    if constexpr (PIXEL_SIZE <= 4U)
+    {
+        if (cpu_supports_avx2())
+        {
+            kernels._kernels[kernels._kernels_count++] = { "avx2", delinearize_row_avx2<PIXEL_SIZE> };
+        }
+    }
+#elif defined(KRA_IMP_NEON)
+    kernels._kernels[kernels._kernels_count++] = { "neon", delinearize_row_neon<PIXEL_SIZE> };
+#endif
+}
+
+kernels_t<delinearize_row_function> list_delinearize_row_functions(const unsigned int pixel_size)
+{
+    kernels_t<delinearize_row_function> kernels{};
+    if (pixel_size == 0U || pixel_size > KRA_IMP_MAX_PIXEL_SIZE)
+    {
+        return kernels;
+    }
+
+    kernels._kernels[kernels._kernels_count++] = { "generic", delinearize_row_generic };
+    switch (pixel_size)
+    {
+    case 2U:
+        list_delinearize_kernels<2U>(kernels);
+        break;
+    case 4U:
+        list_delinearize_kernels<4U>(kernels);
+        break;
+    case 8U:
+        list_delinearize_kernels<8U>(kernels);
+        break;
+    case 16U:
+        list_delinearize_kernels<16U>(kernels);
+        break;
+    case 5U:
+        kernels._kernels[kernels._kernels_count++] = { "scalar", delinearize_row_scalar<5U> };
+        break;
+    case 10U:
+        kernels._kernels[kernels._kernels_count++] = { "scalar", delinearize_row_scalar<10U> };
+        break;
+    case 20U:
+        kernels._kernels[kernels._kernels_count++] = { "scalar", delinearize_row_scalar<20U> };
+        break;
+    default:
+        break;
+    }
+    return kernels;
+}
+
+delinearize_row_function find_delinearize_row_function(const unsigned int pixel_size)
+{
+    switch (pixel_size)
+    {
+    case 2U:
+        return get_delinearize_kernel<2U>();
+    case 4U:
+        return get_delinearize_kernel<4U>();
+    case 8U:
+        return get_delinearize_kernel<8U>();
+    case 16U:
+        return get_delinearize_kernel<16U>();
+    case 5U:
+        return delinearize_row_scalar<5U>;
+    case 10U:
+        return delinearize_row_scalar<10U>;
+    case 20U:
+        return delinearize_row_scalar<20U>;
+    default:
+        return pixel_size == 0U || pixel_size > KRA_IMP_MAX_PIXEL_SIZE ? nullptr : delinearize_row_generic;
+    }
+}
+
+void delinearize_row(const char* const channels[4], char* output, const unsigned long long pixels_count)
+{
+    static constexpr unsigned int pixel_size = 4U;
+    static const delinearize_row_function DELINEARIZE_KERNEL{ get_delinearize_kernel<pixel_size>() };
+    DELINEARIZE_KERNEL(channels, pixel_size, output, pixels_count);
+}
+
+// Positions of the blue, green, red and alpha channels in an output pixel.
+using channel_positions_t = std::array<unsigned int, 4>;
+
+static constexpr channel_positions_t get_channel_positions(const kra_imp_pixel_order_e pixel_order)
+{
+    switch (pixel_order)
+    {
+    case KRA_IMP_RGBA_PIXEL_ORDER:
+        return { 2U, 1U, 0U, 3U };
+    case KRA_IMP_ARGB_PIXEL_ORDER:
+        return { 3U, 2U, 1U, 0U };
+    default:
+        return { 0U, 1U, 2U, 3U };
+    }
+}
+
+static unsigned int premultiply_channel(const unsigned int channel, const unsigned int alpha)
+{
+    const unsigned int product = channel * alpha + 128U;
+    return (product + (product >> 8U)) >> 8U;
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER, kra_imp_alpha_mode_e ALPHA_MODE, kra_imp_channel_depth_e CHANNEL_DEPTH>
+static void delinearize_format_row_scalar(const char* const channels[4], char* output, const unsigned long long first_pixel, const unsigned long long pixels_count)
+{
+    constexpr channel_positions_t POSITIONS = get_channel_positions(PIXEL_ORDER);
+    for (unsigned long long x = first_pixel; x < pixels_count; ++x)
+    {
+        const unsigned int alpha = static_cast<unsigned char>(channels[3][x]);
+        for (unsigned int channel_index = 0U; channel_index < 4U; ++channel_index)
+        {
+            const unsigned int channel = static_cast<unsigned char>(channels[channel_index][x]);
+            const bool premultiply = ALPHA_MODE == KRA_IMP_PREMULTIPLIED_ALPHA && channel_index != 3U;
+            const unsigned long long output_index = x * 4U + POSITIONS[channel_index];
+            if constexpr (CHANNEL_DEPTH == KRA_IMP_U8_CHANNEL_DEPTH)
+            {
+                output[output_index] = static_cast<char>(premultiply ? premultiply_channel(channel, alpha) : channel);
+            }
+            else if constexpr (CHANNEL_DEPTH == KRA_IMP_U16_CHANNEL_DEPTH)
+            {
+                // Widening by 257 maps 255 to 65535; premultiplying at 16 bits keeps the precision 8-bit output loses.
+                const std::uint16_t value = static_cast<std::uint16_t>(premultiply ? (channel * alpha * 257U + 127U) / 255U : channel * 257U);
+                std::memcpy(output + output_index * sizeof(value), &value, sizeof(value));
+            }
+            else
+            {
+                const float value = premultiply ? static_cast<float>(channel * alpha) * (1.0f / (255.0f * 255.0f)) : static_cast<float>(channel) * (1.0f / 255.0f);
+                std::memcpy(output + output_index * sizeof(value), &value, sizeof(value));
+            }
+        }
+    }
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER, kra_imp_alpha_mode_e ALPHA_MODE, kra_imp_channel_depth_e CHANNEL_DEPTH>
+static void delinearize_format_row_scalar(const char* const channels[4], char* output, const unsigned long long pixels_count)
+{
+    delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, CHANNEL_DEPTH>(channels, output, 0ULL, pixels_count);
+}
+
+#ifdef KRA_IMP_X86
+KRA_IMP_TARGET("sse2") static __m128i premultiply_channels_sse2(const __m128i channels, const __m128i alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi16(128);
+    __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(channels, zero), _mm_unpacklo_epi8(alpha, zero)), rounding);
+    __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(channels, zero), _mm_unpackhi_epi8(alpha, zero)), rounding);
+    low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+    high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+    return _mm_packus_epi16(low, high);
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER, kra_imp_alpha_mode_e ALPHA_MODE>
+KRA_IMP_TARGET("sse2")
+static void delinearize_format_row_sse2(const char* const channels[4], char* output, const unsigned long long pixels_count)
+{
+    constexpr channel_positions_t POSITIONS = get_channel_positions(PIXEL_ORDER);
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 16ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        __m128i vectors[4];
+        const __m128i alpha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(channels[3] + x));
+        for (unsigned int channel_index = 0U; channel_index < 3U; ++channel_index)
+        {
+            const __m128i channel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(channels[channel_index] + x));
+            vectors[POSITIONS[channel_index]] = ALPHA_MODE == KRA_IMP_PREMULTIPLIED_ALPHA ? premultiply_channels_sse2(channel, alpha) : channel;
+        }
+        vectors[POSITIONS[3]] = alpha;
+
+        const __m128i low_01 = _mm_unpacklo_epi8(vectors[0], vectors[1]);
+        const __m128i high_01 = _mm_unpackhi_epi8(vectors[0], vectors[1]);
+        const __m128i low_23 = _mm_unpacklo_epi8(vectors[2], vectors[3]);
+        const __m128i high_23 = _mm_unpackhi_epi8(vectors[2], vectors[3]);
+        __m128i* output_vectors = reinterpret_cast<__m128i*>(output + x * 4U);
+        _mm_storeu_si128(output_vectors, _mm_unpacklo_epi16(low_01, low_23));
+        _mm_storeu_si128(output_vectors + 1, _mm_unpackhi_epi16(low_01, low_23));
+        _mm_storeu_si128(output_vectors + 2, _mm_unpacklo_epi16(high_01, high_23));
+        _mm_storeu_si128(output_vectors + 3, _mm_unpackhi_epi16(high_01, high_23));
+    }
+    delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_U8_CHANNEL_DEPTH>(channels, output, vector_pixels_count, pixels_count);
+}
+#endif
+
+#ifdef KRA_IMP_NEON
+static uint8x16_t premultiply_channels_neon(const uint8x16_t channels, const uint8x16_t alpha)
+{
+    const uint16x8_t low = vmull_u8(vget_low_u8(channels), vget_low_u8(alpha));
+    const uint16x8_t high = vmull_u8(vget_high_u8(channels), vget_high_u8(alpha));
+    return vcombine_u8(vraddhn_u16(low, vrshrq_n_u16(low, 8)), vraddhn_u16(high, vrshrq_n_u16(high, 8)));
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER, kra_imp_alpha_mode_e ALPHA_MODE>
+static void delinearize_format_row_neon(const char* const channels[4], char* output, const unsigned long long pixels_count)
+{
+    constexpr channel_positions_t POSITIONS = get_channel_positions(PIXEL_ORDER);
+    static constexpr unsigned long long PIXELS_PER_ITERATION = 16ULL;
+    const unsigned long long vector_pixels_count = pixels_count - pixels_count % PIXELS_PER_ITERATION;
+    for (unsigned long long x = 0ULL; x < vector_pixels_count; x += PIXELS_PER_ITERATION)
+    {
+        uint8x16x4_t vectors;
+        const uint8x16_t alpha = vld1q_u8(reinterpret_cast<const uint8_t*>(channels[3] + x));
+        for (unsigned int channel_index = 0U; channel_index < 3U; ++channel_index)
+        {
+            const uint8x16_t channel = vld1q_u8(reinterpret_cast<const uint8_t*>(channels[channel_index] + x));
+            vectors.val[POSITIONS[channel_index]] = ALPHA_MODE == KRA_IMP_PREMULTIPLIED_ALPHA ? premultiply_channels_neon(channel, alpha) : channel;
+        }
+        vectors.val[POSITIONS[3]] = alpha;
+        vst4q_u8(reinterpret_cast<uint8_t*>(output + x * 4U), vectors);
+    }
+    delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_U8_CHANNEL_DEPTH>(channels, output, vector_pixels_count, pixels_count);
+}
+#endif
+
+template <kra_imp_pixel_order_e PIXEL_ORDER, kra_imp_alpha_mode_e ALPHA_MODE> static delinearize_format_row_function select_delinearize_format_kernel()
+{
+#if defined(KRA_IMP_X86)
+    if (cpu_supports_sse2())
+    {
+        return delinearize_format_row_sse2<PIXEL_ORDER, ALPHA_MODE>;
+    }
+#elif defined(KRA_IMP_NEON)
+    return delinearize_format_row_neon<PIXEL_ORDER, ALPHA_MODE>;
+#endif
+    return delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_U8_CHANNEL_DEPTH>;
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER, kra_imp_alpha_mode_e ALPHA_MODE>
+static delinearize_format_row_function find_delinearize_format_kernel(const kra_imp_channel_depth_e channel_depth)
+{
+    switch (channel_depth)
+    {
+    case KRA_IMP_U8_CHANNEL_DEPTH:
+        if constexpr (PIXEL_ORDER == KRA_IMP_BGRA_PIXEL_ORDER && ALPHA_MODE == KRA_IMP_STRAIGHT_ALPHA)
+        {
+            return delinearize_row;
+        }
+        else
+        {
+            static const delinearize_format_row_function DELINEARIZE_FORMAT_KERNEL{ select_delinearize_format_kernel<PIXEL_ORDER, ALPHA_MODE>() };
+            return DELINEARIZE_FORMAT_KERNEL;
+        }
+    case KRA_IMP_U16_CHANNEL_DEPTH:
+        return delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_U16_CHANNEL_DEPTH>;
+    case KRA_IMP_F32_CHANNEL_DEPTH:
+        return delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_F32_CHANNEL_DEPTH>;
+    default:
+        return nullptr;
+    }
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER, kra_imp_alpha_mode_e ALPHA_MODE>
+static kernels_t<delinearize_format_row_function> list_delinearize_format_kernels(const kra_imp_channel_depth_e channel_depth)
+{
+    kernels_t<delinearize_format_row_function> kernels{};
+    switch (channel_depth)
+    {
+    case KRA_IMP_U8_CHANNEL_DEPTH:
+        kernels._kernels[kernels._kernels_count++] = { "scalar", delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_U8_CHANNEL_DEPTH> };
+#if defined(KRA_IMP_X86)
+        if (cpu_supports_sse2())
+        {
+            kernels._kernels[kernels._kernels_count++] = { "sse2", delinearize_format_row_sse2<PIXEL_ORDER, ALPHA_MODE> };
+        }
+#elif defined(KRA_IMP_NEON)
+        kernels._kernels[kernels._kernels_count++] = { "neon", delinearize_format_row_neon<PIXEL_ORDER, ALPHA_MODE> };
+#endif
+        if constexpr (PIXEL_ORDER == KRA_IMP_BGRA_PIXEL_ORDER && ALPHA_MODE == KRA_IMP_STRAIGHT_ALPHA)
+        {
+            kernels._kernels[kernels._kernels_count++] = { "delinearize_row", delinearize_row };
+        }
+        break;
+    case KRA_IMP_U16_CHANNEL_DEPTH:
+        kernels._kernels[kernels._kernels_count++] = { "scalar", delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_U16_CHANNEL_DEPTH> };
+        break;
+    case KRA_IMP_F32_CHANNEL_DEPTH:
+        kernels._kernels[kernels._kernels_count++] = { "scalar", delinearize_format_row_scalar<PIXEL_ORDER, ALPHA_MODE, KRA_IMP_F32_CHANNEL_DEPTH> };
+        break;
+    default:
+        break;
+    }
+    return kernels;
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER> static kernels_t<delinearize_format_row_function> list_delinearize_format_kernels(const kra_imp_pixel_format_t& pixel_format)
+{
+    switch (pixel_format._alpha_mode)
+    {
+    case KRA_IMP_STRAIGHT_ALPHA:
+        return list_delinearize_format_kernels<PIXEL_ORDER, KRA_IMP_STRAIGHT_ALPHA>(pixel_format._channel_depth);
+    case KRA_IMP_PREMULTIPLIED_ALPHA:
+        return list_delinearize_format_kernels<PIXEL_ORDER, KRA_IMP_PREMULTIPLIED_ALPHA>(pixel_format._channel_depth);
+    default:
+        return {};
+    }
+}
+
+kernels_t<delinearize_format_row_function> list_delinearize_format_row_functions(const kra_imp_pixel_format_t& pixel_format)
+{
+    switch (pixel_format._pixel_order)
+    {
+    case KRA_IMP_BGRA_PIXEL_ORDER:
+        return list_delinearize_format_kernels<KRA_IMP_BGRA_PIXEL_ORDER>(pixel_format);
+    case KRA_IMP_RGBA_PIXEL_ORDER:
+        return list_delinearize_format_kernels<KRA_IMP_RGBA_PIXEL_ORDER>(pixel_format);
+    case KRA_IMP_ARGB_PIXEL_ORDER:
+        return list_delinearize_format_kernels<KRA_IMP_ARGB_PIXEL_ORDER>(pixel_format);
+    default:
+        return {};
+    }
+}
+
+template <kra_imp_pixel_order_e PIXEL_ORDER> static delinearize_format_row_function find_delinearize_format_kernel(const kra_imp_pixel_format_t& pixel_format)
+{
+    switch (pixel_format._alpha_mode)
+    {
+    case KRA_IMP_STRAIGHT_ALPHA:
+        return find_delinearize_format_kernel<PIXEL_ORDER, KRA_IMP_STRAIGHT_ALPHA>(pixel_format._channel_depth);
+    case KRA_IMP_PREMULTIPLIED_ALPHA:
+        return find_delinearize_format_kernel<PIXEL_ORDER, KRA_IMP_PREMULTIPLIED_ALPHA>(pixel_format._channel_depth);
+    default:
+        return nullptr;
+    }
+}
+
+delinearize_format_row_function find_delinearize_format_row_function(const kra_imp_pixel_format_t& pixel_format)
+{
+    switch (pixel_format._pixel_order)
+    {
+    case KRA_IMP_BGRA_PIXEL_ORDER:
+        return find_delinearize_format_kernel<KRA_IMP_BGRA_PIXEL_ORDER>(pixel_format);
+    case KRA_IMP_RGBA_PIXEL_ORDER:
+        return find_delinearize_format_kernel<KRA_IMP_RGBA_PIXEL_ORDER>(pixel_format);
+    case KRA_IMP_ARGB_PIXEL_ORDER:
+        return find_delinearize_format_kernel<KRA_IMP_ARGB_PIXEL_ORDER>(pixel_format);
+    default:
+        return nullptr;
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+#include "kra_imp/types.hpp"
+
+/**
+ * @brief Largest pixel size, in bytes, supported by the delinearize kernels.
+ */
+static constexpr const unsigned int KRA_IMP_MAX_PIXEL_SIZE{ 32U };
+
+/**
+ * @brief Kernel interleaving a row of pixels stored as `pixel_size` separate byte planes.
+ *
+ * @param[in] planes Pointers to the byte planes of the row, one per byte of a pixel.
+ * @param[in] pixel_size Number of byte planes, which is the size of a pixel in bytes.
+ * @param[out] output Buffer receiving the interleaved pixels, at least `pixels_count * pixel_size` bytes.
+ * @param[in] pixels_count Number of pixels to interleave.
+ */
+using delinearize_row_function = void (*)(const char* const* planes, const unsigned int pixel_size, char* output, const unsigned long long pixels_count);
+
+/**
+ * @brief Finds the kernel interleaving rows of pixels of the given size.
+ *
+ * @details
+ * Krita linearizes a tile byte by byte, so a pixel of any color model and channel depth is stored as `pixel_size`
+ * byte planes. Kernels are compiled for the pixel sizes of common color models: SIMD kernels (AVX2, SSE2 or NEON,
+ * selected once, on first use, for the best instruction set supported by the CPU) for 2 (GRAYA8), 4 (RGBA8), 8 (RGBA16)
+ * and 16 (RGBA32F) bytes, and unrolled scalar kernels for 5 (CMYKA8), 10 (CMYKA16) and 20 (CMYKA32F) bytes.
+ * Other sizes get a generic scalar kernel. All kernels produce identical output.
+ *
+ * @param[in] pixel_size Size of a pixel in bytes, from 1 to `KRA_IMP_MAX_PIXEL_SIZE`.
+ *
+ * @return The kernel, or nullptr if the pixel size is not supported.
+ */
+delinearize_row_function find_delinearize_row_function(const unsigned int pixel_size);
+
+/**
+ * @brief Interleaves a row of pixels stored as four separate channel planes.
+ *
+ * @details
+ * Writes `pixels_count` pixels to `output`, 4 bytes per pixel, taking the n-th byte of each pixel from
+ * the n-th channel plane, using the kernel returned by `find_delinearize_row_function` for 4 byte pixels.
+ *
+ * @param[in] channels Pointers to the four channel planes of the row.
+ * @param[out] output Buffer receiving the interleaved pixels, at least `pixels_count * 4` bytes.
+ * @param[in] pixels_count Number of pixels to interleave.
+ */
+void delinearize_row(const char* const channels[4], char* output, const unsigned long long pixels_count);
+
+/**
+ * @brief Kernel interleaving a row of 8-bit BGRA pixels stored as four channel planes into pixels of another format.
+ *
+ * @param[in] channels Pointers to the blue, green, red and alpha planes of the row.
+ * @param[out] output Buffer receiving the interleaved pixels, at least `pixels_count * 4` channels of the output depth.
+ * @param[in] pixels_count Number of pixels to interleave.
+ */
+using delinearize_format_row_function = void (*)(const char* const channels[4], char* output, const unsigned long long pixels_count);
+
+/**
+ * @brief Finds the kernel interleaving rows of 8-bit BGRA pixels into the given pixel format.
+ *
+ * @details
+ * Reordering and premultiplying the channels, and widening them to the output depth, happen inside the interleaving
+ * kernel, so every pixel is written once. 8-bit output uses SIMD kernels (SSE2 or NEON), and straight BGRA is
+ * `delinearize_row`. 16-bit and float output use scalar kernels the compiler vectorizes.
+ *
+ * @return The kernel, or nullptr if the pixel format is not supported.
+ */
+delinearize_format_row_function find_delinearize_format_row_function(const kra_imp_pixel_format_t& pixel_format);
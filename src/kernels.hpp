@@ -0,0 +1,58 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+#include "delinearize.hpp"
+#include "separators.hpp"
+#include <array>
+
+/**
+ * @brief Kernel written for one instruction set.
+ */
+template <typename Function> struct kernel_t
+{
+    const char* _instruction_set{ nullptr }; /**< Name of the instruction set, for diagnostics. */
+    Function _function{ nullptr };           /**< The kernel. */
+};
+
+/**
+ * @brief Kernels of every instruction set usable on the running CPU, the scalar reference first.
+ *
+ * @details
+ * Dispatchers pick one of these once, on first use. The lists exist so every kernel built for the target can be
+ * checked against the scalar one, including kernels the dispatcher would not pick on the running CPU.
+ */
+template <typename Function> struct kernels_t
+{
+    std::array<kernel_t<Function>, 5> _kernels{}; /**< Kernels, scalar first. */
+    unsigned int _kernels_count{ 0U };            /**< Number of kernels in `_kernels`. */
+};
+
+/**
+ * @brief Lists the kernels interleaving rows of pixels of the given size.
+ *
+ * @details
+ * The generic scalar kernel comes first, followed by the unrolled scalar and SIMD kernels compiled for the pixel size.
+ *
+ * @param[in] pixel_size Size of a pixel in bytes, from 1 to `KRA_IMP_MAX_PIXEL_SIZE`.
+ *
+ * @return The kernels, none if the pixel size is not supported.
+ */
+kernels_t<delinearize_row_function> list_delinearize_row_functions(const unsigned int pixel_size);
+
+/**
+ * @brief Lists the kernels interleaving rows of 8-bit BGRA pixels into the given pixel format.
+ *
+ * @return The kernels, none if the pixel format is not supported.
+ */
+kernels_t<delinearize_format_row_function> list_delinearize_format_row_functions(const kra_imp_pixel_format_t& pixel_format);
+
+/**
+ * @brief Lists the kernels behind `find_separators`.
+ *
+ * @return The kernels.
+ */
+kernels_t<find_separators_function> list_find_separators_functions();
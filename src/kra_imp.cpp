@@ -5,20 +5,30 @@
  * This library is distributed under the MIT License.
  */
 #include "kra_imp/kra_imp.hpp"
-#include "lzf/lzf.h"
+#include "color_conversion.hpp"
+#include "delinearize.hpp"
+#include "lzf_decoder.hpp"
+#include "mapped_file.hpp"
+#include "memory.hpp"
+#include "separators.hpp"
+#include <algorithm>
 #include <array>
 #include <charconv>
 #include <cstring>
 #include <functional>
+#include <limits>
 #include <pugixml.hpp>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <vector>
 #include <zip.h>
 
 static constexpr const char* KRA_IMP_MAIN_DOC_FILE_NAME{ "maindoc.xml" };
 static constexpr const char* KRA_IMP_LAYERS_DIRECTORY_NAME{ "layers" };
-static constexpr const pugi::char_t* KRA_IMP_DOC_IMAGE_NODE{ "DOC/IMAGE" };
-static constexpr const pugi::char_t* KRA_IMP_DOC_ANIMATION_NODE{ "DOC/IMAGE/animation" };
+static constexpr const pugi::char_t* KRA_IMP_DOC_NODE{ "DOC" };
+static constexpr const pugi::char_t* KRA_IMP_IMAGE_NODE{ "IMAGE" };
+static constexpr const pugi::char_t* KRA_IMP_ANIMATION_NODE{ "animation" };
 static constexpr const pugi::char_t* KRA_IMP_FRAME_RATE_NODE{ "framerate" };
 static constexpr const pugi::char_t* KRA_IMP_RANGE_NODE{ "range" };
 static constexpr const pugi::char_t* KRA_IMP_VALUE_ATTRIBUTE{ "value" };
@@ -32,10 +42,12 @@ static constexpr const pugi::char_t* KRA_IMP_HEIGHT_ATTRIBUTE{ "height" };
 static constexpr const pugi::char_t* KRA_IMP_WIDTH_ATTRIBUTE{ "width" };
 static constexpr const pugi::char_t* KRA_IMP_FILE_NAME_ATTRIBUTE{ "filename" };
 static constexpr const pugi::char_t* KRA_IMP_KEY_FRAMES_ATTRIBUTE{ "keyframes" };
-static constexpr const pugi::char_t* KRA_IMP_LAYER_NODES{ "DOC/IMAGE/layers/layer" };
+static constexpr const pugi::char_t* KRA_IMP_LAYERS_NODE{ "layers" };
+static constexpr const pugi::char_t* KRA_IMP_LAYER_NODE{ "layer" };
 static constexpr const pugi::char_t* KRA_IMP_NODE_TYPE_ATTRIBUTE{ "nodetype" };
-static constexpr const pugi::char_t* KRA_IMP_INNER_LAYER_NODES{ "layers/layer" };
-static constexpr const pugi::char_t* KRA_IMP_KEY_FRAME_NODES{ "keyframes/channel/keyframe" };
+static constexpr const pugi::char_t* KRA_IMP_KEY_FRAMES_NODE{ "keyframes" };
+static constexpr const pugi::char_t* KRA_IMP_CHANNEL_NODE{ "channel" };
+static constexpr const pugi::char_t* KRA_IMP_KEY_FRAME_NODE{ "keyframe" };
 static constexpr const pugi::char_t* KRA_IMP_X_ATTRIBUTE{ "x" };
 static constexpr const pugi::char_t* KRA_IMP_Y_ATTRIBUTE{ "y" };
 static constexpr const pugi::char_t* KRA_IMP_FRAME_ATTRIBUTE{ "frame" };
@@ -43,15 +55,41 @@ static constexpr const pugi::char_t* KRA_IMP_TIME_ATTRIBUTE{ "time" };
 static constexpr const pugi::char_t* KRA_IMP_OFFSET_NODE{ "offset" };
 static constexpr const char KRA_IMP_EMPTY_CHAR{ '\0' };
 static constexpr const char KRA_IMP_END{ '\n' };
-static constexpr const char KRA_IMP_UNCOMPRESSED_FLAG{ 0 };
-static constexpr const char KRA_IMP_COMPRESSED_FLAG{ 1 };
 static constexpr const char KRA_IMP_SEPARATOR{ ',' };
 static constexpr const char* KRA_IMP_COMPRESSION_TYPE{ "LZF" };
 static constexpr const unsigned char KRA_IMP_MAX_NAME_LENGTH{ 255 };
+static constexpr const unsigned long long KRA_IMP_MAX_STREAMED_LINE_SIZE{ 64ULL };
+static constexpr const unsigned int KRA_IMP_LAYER_DATA_HEADER_LINES_COUNT{ 5U };
+
+struct archive_entry_t
+{
+    memory_string_t _name;
+    memory_string_t _lookup_name;
+    unsigned long long _size{ 0ULL };
+};
 
 struct kra_imp_archive_t
 {
     zip_t* _archive{ nullptr };
+    mapped_file_t _mapped_file;
+    memory_vector_t<archive_entry_t> _entries;
+    memory_unordered_map_t<std::string_view, unsigned long long> _entry_indices;
+};
+
+struct document_layer_t
+{
+    pugi::xml_node _node;
+    long _parent_index{ -1L };
+    long _first_child_index{ -1L };
+    long _next_sibling_index{ -1L };
+    unsigned int _depth{ 0U };
+};
+
+struct kra_imp_document_t
+{
+    pugi::xml_document _xml_document;
+    memory_vector_t<document_layer_t> _layers;
+    memory_vector_t<pugi::xml_node> _key_frames;
 };
 
 constexpr kra_imp_layer_type_e to_layer_type(const std::string_view string)
@@ -107,6 +145,26 @@ constexpr kra_imp_color_space_model_e to_color_space_model(const std::string_vie
     return KRA_IMP_UNKNOWN_COLOR_SPACE_MODEL;
 }
 
+constexpr kra_imp_channel_depth_e to_channel_depth(const std::string_view string)
+{
+    constexpr std::string_view F32_DEPTH = "F32";
+    constexpr std::string_view F16_DEPTH = "F16";
+    constexpr std::string_view U16_DEPTH = "16";
+    // 16-bit CIELAB is the only color space whose name has no depth suffix and is not 8-bit.
+    constexpr std::string_view LABA_U16_COLOR_SPACE = "LABA";
+
+    if (to_color_space_model(string) == KRA_IMP_UNKNOWN_COLOR_SPACE_MODEL)
+        return KRA_IMP_UNKNOWN_CHANNEL_DEPTH;
+    if (string.find(F32_DEPTH) != std::string::npos)
+        return KRA_IMP_F32_CHANNEL_DEPTH;
+    if (string.find(F16_DEPTH) != std::string::npos)
+        return KRA_IMP_F16_CHANNEL_DEPTH;
+    if (string.find(U16_DEPTH) != std::string::npos || string == LABA_U16_COLOR_SPACE)
+        return KRA_IMP_U16_CHANNEL_DEPTH;
+
+    return KRA_IMP_U8_CHANNEL_DEPTH;
+}
+
 KRA_IMP_API unsigned int kra_imp_get_version()
 {
     return KRA_IMP_VERSION;
@@ -114,7 +172,123 @@ KRA_IMP_API unsigned int kra_imp_get_version()
 
 KRA_IMP_API void kra_imp_set_memory_functions(kra_imp_allocation_function allocation_function, kra_imp_deallocation_function deallocation_function)
 {
-    pugi::set_memory_management_functions(allocation_function, deallocation_function);
+    set_memory_functions(allocation_function, deallocation_function, nullptr, nullptr, nullptr);
+    pugi::set_memory_management_functions(allocate_memory, deallocate_memory);
+}
+
+KRA_IMP_API void kra_imp_set_memory_functions_with_context(kra_imp_context_allocation_function allocation_function,
+                                                           kra_imp_context_deallocation_function deallocation_function, void* context)
+{
+    set_memory_functions(nullptr, nullptr, allocation_function, deallocation_function, context);
+    pugi::set_memory_management_functions(allocate_memory, deallocate_memory);
+}
+
+KRA_IMP_API void kra_imp_set_scratch_buffer(char* scratch_buffer, const unsigned long long scratch_buffer_size)
+{
+    set_scratch_buffer(scratch_buffer, static_cast<size_t>(scratch_buffer_size));
+    pugi::set_memory_management_functions(allocate_memory, deallocate_memory);
+}
+
+// Entries are looked up the way zip_entry_open does: backslashes are separators, empty and dot-only path components
+// (such as a leading "./") are dropped, and letters compare regardless of case.
+memory_string_t normalize_archive_entry_name(const std::string_view name)
+{
+    static constexpr std::string_view PATH_SEPARATORS{ "/\\" };
+    memory_string_t normalized_name;
+    normalized_name.reserve(name.size());
+    std::size_t component_start = 0U;
+    while (component_start <= name.size())
+    {
+        const std::size_t component_end = std::min(name.find_first_of(PATH_SEPARATORS, component_start), name.size());
+        const std::string_view component = name.substr(component_start, component_end - component_start);
+        if (component.find_first_not_of('.') != std::string_view::npos)
+        {
+            if (!normalized_name.empty())
+            {
+                normalized_name.push_back('/');
+            }
+            for (const char character : component)
+            {
+                normalized_name.push_back(character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character);
+            }
+        }
+        component_start = component_end + 1U;
+    }
+
+    return normalized_name;
+}
+
+bool index_archive_entries(kra_imp_archive_t& archive)
+{
+    const ssize_t entries_count = zip_entries_total(archive._archive);
+    if (entries_count < 0)
+    {
+        return false;
+    }
+
+    try
+    {
+        archive._entries.resize(static_cast<size_t>(entries_count));
+        for (size_t entry_index = 0U; entry_index < archive._entries.size(); ++entry_index)
+        {
+            if (zip_entry_openbyindex(archive._archive, entry_index) != 0)
+            {
+                return false;
+            }
+
+            archive._entries[entry_index]._name = zip_entry_name(archive._archive);
+            archive._entries[entry_index]._lookup_name = normalize_archive_entry_name(archive._entries[entry_index]._name);
+            archive._entries[entry_index]._size = zip_entry_size(archive._archive);
+            if (zip_entry_close(archive._archive) != 0)
+            {
+                return false;
+            }
+        }
+
+        // Names are viewed in place, so the map is filled only once the entries vector stops growing.
+        archive._entry_indices.reserve(archive._entries.size());
+        for (size_t entry_index = 0U; entry_index < archive._entries.size(); ++entry_index)
+        {
+            archive._entry_indices.emplace(archive._entries[entry_index]._lookup_name, entry_index);
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        zip_entry_close(archive._archive);
+        return false;
+    }
+
+    return true;
+}
+
+bool find_archive_entry(const kra_imp_archive_t& archive, const char* file_path, unsigned long long& entry_index)
+{
+    if (file_path == nullptr)
+    {
+        return false;
+    }
+
+    try
+    {
+        const memory_string_t lookup_name = normalize_archive_entry_name(file_path);
+        const auto entry = archive._entry_indices.find(std::string_view(lookup_name));
+        if (entry == archive._entry_indices.end())
+        {
+            return false;
+        }
+
+        entry_index = entry->second;
+        return true;
+    }
+    catch (const std::bad_alloc&)
+    {
+        return false;
+    }
+}
+
+bool open_archive_entry(kra_imp_archive_t& archive, const unsigned long long entry_index)
+{
+    return entry_index < archive._entries.size() && zip_entry_openbyindex(archive._archive, static_cast<size_t>(entry_index)) == 0;
 }
 
 KRA_IMP_API kra_imp_archive_t* kra_imp_open_archive(const char* archive_buffer, const unsigned long long archive_buffer_size)
@@ -131,8 +305,45 @@ KRA_IMP_API kra_imp_archive_t* kra_imp_open_archive(const char* archive_buffer,
         return nullptr;
     }
 
-    kra_imp_archive_t* archive = new kra_imp_archive_t;
+    kra_imp_archive_t* archive = new_object<kra_imp_archive_t>();
+    if (archive == nullptr)
+    {
+        zip_stream_close(zip_archive);
+        return nullptr;
+    }
+
     archive->_archive = zip_archive;
+    if (!index_archive_entries(*archive))
+    {
+        zip_stream_close(zip_archive);
+        delete_object(archive);
+        return nullptr;
+    }
+
+    return archive;
+}
+
+KRA_IMP_API kra_imp_archive_t* kra_imp_open_archive_file(const char* archive_file_path)
+{
+    if (archive_file_path == nullptr)
+    {
+        return nullptr;
+    }
+
+    mapped_file_t mapped_file;
+    if (!map_file(archive_file_path, mapped_file))
+    {
+        return nullptr;
+    }
+
+    kra_imp_archive_t* archive = kra_imp_open_archive(mapped_file._data, mapped_file._size);
+    if (archive == nullptr)
+    {
+        unmap_file(mapped_file);
+        return nullptr;
+    }
+
+    archive->_mapped_file = mapped_file;
     return archive;
 }
 
@@ -144,39 +355,191 @@ KRA_IMP_API void kra_imp_close_archive(kra_imp_archive_t* archive)
     }
 
     zip_stream_close(archive->_archive);
-    delete archive;
+    unmap_file(archive->_mapped_file);
+    delete_object(archive);
+}
+
+KRA_IMP_API unsigned long long kra_imp_get_files_count(const kra_imp_archive_t* archive)
+{
+    return archive == nullptr ? 0ULL : archive->_entries.size();
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_find_file_index(const kra_imp_archive_t* archive, const char* file_path, unsigned long long* file_index)
+{
+    if (archive == nullptr || file_path == nullptr || file_index == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    return find_archive_entry(*archive, file_path, *file_index) ? KRA_IMP_SUCCESS : KRA_IMP_FAIL;
+}
+
+KRA_IMP_API const char* kra_imp_get_file_name(const kra_imp_archive_t* archive, const unsigned long long file_index)
+{
+    if (archive == nullptr || file_index >= archive->_entries.size())
+    {
+        return nullptr;
+    }
+
+    return archive->_entries[file_index]._name.c_str();
 }
 
 KRA_IMP_API unsigned long long kra_imp_get_file_size(kra_imp_archive_t* archive, const char* file_path)
 {
-    if (archive == nullptr || zip_entry_open(archive->_archive, file_path) != 0)
+    unsigned long long file_index{ 0ULL };
+    if (archive == nullptr || !find_archive_entry(*archive, file_path, file_index))
     {
         return 0ULL;
     }
 
-    const unsigned long long entry_size = zip_entry_size(archive->_archive);
-    if (zip_entry_close(archive->_archive) != 0)
+    return kra_imp_get_file_size_by_index(archive, file_index);
+}
+
+KRA_IMP_API unsigned long long kra_imp_get_file_size_by_index(const kra_imp_archive_t* archive, const unsigned long long file_index)
+{
+    if (archive == nullptr || file_index >= archive->_entries.size())
     {
         return 0ULL;
     }
 
-    return entry_size;
+    return archive->_entries[file_index]._size;
 }
 
 KRA_IMP_API unsigned long long kra_imp_load_file(kra_imp_archive_t* archive, const char* file_path, char* file_buffer, const unsigned long long file_buffer_size)
 {
-    if (archive == nullptr || file_buffer_size == 0ULL || zip_entry_open(archive->_archive, file_path) != 0)
+    unsigned long long file_index{ 0ULL };
+    if (archive == nullptr || !find_archive_entry(*archive, file_path, file_index))
+    {
+        return 0ULL;
+    }
+
+    return kra_imp_load_file_by_index(archive, file_index, file_buffer, file_buffer_size);
+}
+
+KRA_IMP_API unsigned long long kra_imp_load_file_by_index(kra_imp_archive_t* archive, const unsigned long long file_index, char* file_buffer,
+                                                          const unsigned long long file_buffer_size)
+{
+    if (archive == nullptr || file_buffer == nullptr || file_buffer_size == 0ULL || !open_archive_entry(*archive, file_index))
     {
         return 0ULL;
     }
 
-    const unsigned long long read_bytes = zip_entry_noallocread(archive->_archive, file_buffer, file_buffer_size);
-    if (zip_entry_close(archive->_archive) != 0)
+    const ssize_t read_bytes = zip_entry_noallocread(archive->_archive, file_buffer, file_buffer_size);
+    if (zip_entry_close(archive->_archive) != 0 || read_bytes < 0)
     {
         return 0ULL;
     }
 
-    return read_bytes;
+    return static_cast<unsigned long long>(read_bytes);
+}
+
+kra_imp_error_code_e read_archive_entry(kra_imp_archive_t& archive, const unsigned long long entry_index, char* file_buffer)
+{
+    const unsigned long long entry_size = archive._entries[entry_index]._size;
+    if (entry_size == 0ULL)
+    {
+        return KRA_IMP_SUCCESS;
+    }
+
+    if (!open_archive_entry(archive, entry_index))
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    const ssize_t read_bytes = zip_entry_noallocread(archive._archive, file_buffer, entry_size);
+    zip_entry_close(archive._archive);
+    return read_bytes >= 0 && static_cast<unsigned long long>(read_bytes) == entry_size ? KRA_IMP_SUCCESS : KRA_IMP_DECOMPRESS_ERROR;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_file(kra_imp_archive_t* archive, const char* file_path, char* file_buffer, const unsigned long long file_buffer_size,
+                                                   unsigned long long* file_size)
+{
+    if (archive == nullptr || file_path == nullptr || file_size == nullptr || (file_buffer == nullptr && file_buffer_size != 0ULL))
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    unsigned long long file_index{ 0ULL };
+    if (!find_archive_entry(*archive, file_path, file_index))
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    *file_size = archive->_entries[file_index]._size;
+    if (*file_size > file_buffer_size)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    return read_archive_entry(*archive, file_index, file_buffer);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_file_allocated(kra_imp_archive_t* archive, const char* file_path, kra_imp_file_allocation_function allocation_function,
+                                                             void* user_data, char** file_buffer, unsigned long long* file_size)
+{
+    if (archive == nullptr || file_path == nullptr || allocation_function == nullptr || file_buffer == nullptr || file_size == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    *file_buffer = nullptr;
+    unsigned long long file_index{ 0ULL };
+    if (!find_archive_entry(*archive, file_path, file_index))
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    *file_size = archive->_entries[file_index]._size;
+    if (*file_size == 0ULL)
+    {
+        return KRA_IMP_SUCCESS;
+    }
+
+    *file_buffer = allocation_function(user_data, *file_size);
+    if (*file_buffer == nullptr)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    return read_archive_entry(*archive, file_index, *file_buffer);
+}
+
+struct file_stream_t
+{
+    kra_imp_file_chunk_function _chunk_function{ nullptr };
+    void* _user_data{ nullptr };
+    kra_imp_error_code_e _result{ KRA_IMP_SUCCESS };
+};
+
+size_t on_file_stream_chunk(void* file_stream, uint64_t, const void* data, size_t size)
+{
+    file_stream_t& stream = *static_cast<file_stream_t*>(file_stream);
+    stream._result = stream._chunk_function(stream._user_data, static_cast<const char*>(data), size);
+    return stream._result == KRA_IMP_SUCCESS ? size : 0U;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_stream_file(kra_imp_archive_t* archive, const char* file_path, kra_imp_file_chunk_function chunk_function, void* user_data)
+{
+    if (archive == nullptr || file_path == nullptr || chunk_function == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    unsigned long long file_index{ 0ULL };
+    if (!find_archive_entry(*archive, file_path, file_index) || !open_archive_entry(*archive, file_index))
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    file_stream_t stream{ chunk_function, user_data };
+    const bool extracted = zip_entry_extract(archive->_archive, on_file_stream_chunk, &stream) >= 0;
+    zip_entry_close(archive->_archive);
+    if (stream._result != KRA_IMP_SUCCESS)
+    {
+        return stream._result;
+    }
+
+    return extracted ? KRA_IMP_SUCCESS : KRA_IMP_DECOMPRESS_ERROR;
 }
 
 KRA_IMP_API const char* kra_imp_get_main_doc_file_name()
@@ -189,16 +552,76 @@ KRA_IMP_API const char* kra_imp_get_layer_directory_name()
     return KRA_IMP_LAYERS_DIRECTORY_NAME;
 }
 
+pugi::xml_node first_nested_child(const pugi::xml_node& xml_node, const pugi::char_t* child_name, const pugi::char_t* nested_child_name)
+{
+    for (pugi::xml_node child = xml_node.child(child_name); child; child = child.next_sibling(child_name))
+    {
+        const pugi::xml_node nested_child = child.child(nested_child_name);
+        if (nested_child)
+        {
+            return nested_child;
+        }
+    }
+    return {};
+}
+
+pugi::xml_node next_nested_child(const pugi::xml_node& nested_child, const pugi::char_t* child_name, const pugi::char_t* nested_child_name)
+{
+    const pugi::xml_node nested_sibling = nested_child.next_sibling(nested_child_name);
+    if (nested_sibling)
+    {
+        return nested_sibling;
+    }
+
+    for (pugi::xml_node child = nested_child.parent().next_sibling(child_name); child; child = child.next_sibling(child_name))
+    {
+        const pugi::xml_node first_child = child.child(nested_child_name);
+        if (first_child)
+        {
+            return first_child;
+        }
+    }
+    return {};
+}
+
+pugi::xml_node first_layer_node(const pugi::xml_node& xml_node)
+{
+    return first_nested_child(xml_node, KRA_IMP_LAYERS_NODE, KRA_IMP_LAYER_NODE);
+}
+
+pugi::xml_node next_layer_node(const pugi::xml_node& layer_node)
+{
+    return next_nested_child(layer_node, KRA_IMP_LAYERS_NODE, KRA_IMP_LAYER_NODE);
+}
+
+pugi::xml_node first_key_frame_node(const pugi::xml_node& document_node)
+{
+    return first_nested_child(document_node.child(KRA_IMP_KEY_FRAMES_NODE), KRA_IMP_CHANNEL_NODE, KRA_IMP_KEY_FRAME_NODE);
+}
+
+pugi::xml_node next_key_frame_node(const pugi::xml_node& key_frame_node)
+{
+    return next_nested_child(key_frame_node, KRA_IMP_CHANNEL_NODE, KRA_IMP_KEY_FRAME_NODE);
+}
+
+pugi::xml_node find_image_node(const pugi::xml_node& document_node)
+{
+    return document_node.child(KRA_IMP_DOC_NODE).child(KRA_IMP_IMAGE_NODE);
+}
+
+bool is_group_layer_node(const pugi::xml_node& layer_node)
+{
+    const pugi::char_t* node_type_attribute = layer_node.attribute(KRA_IMP_NODE_TYPE_ATTRIBUTE).value();
+    return to_layer_type(std::string_view(node_type_attribute)) == KRA_IMP_GROUP_LAYER_TYPE;
+}
+
 void iterate_layers_recursive(const pugi::xml_node& xml_node, unsigned int& layers_count)
 {
-    const pugi::char_t* node_type_attribute = xml_node.attribute(KRA_IMP_NODE_TYPE_ATTRIBUTE).value();
-    const char current_layer_type = to_layer_type(std::string_view(node_type_attribute));
-    if (current_layer_type == KRA_IMP_GROUP_LAYER_TYPE)
+    if (is_group_layer_node(xml_node))
     {
-        const pugi::xpath_node_set layer_nodes = xml_node.select_nodes(KRA_IMP_INNER_LAYER_NODES);
-        for (pugi::xpath_node_set::const_iterator it = layer_nodes.begin(); it != layer_nodes.end(); ++it)
+        for (pugi::xml_node layer_node = first_layer_node(xml_node); layer_node; layer_node = next_layer_node(layer_node))
         {
-            iterate_layers_recursive(it->node(), layers_count);
+            iterate_layers_recursive(layer_node, layers_count);
         }
     }
     ++layers_count;
@@ -206,15 +629,32 @@ void iterate_layers_recursive(const pugi::xml_node& xml_node, unsigned int& laye
 
 void parse_animation(const pugi::xml_node& xml_node, kra_imp_animation_t& animation)
 {
-    const pugi::xpath_node frame_rate_xnode = xml_node.select_node(KRA_IMP_FRAME_RATE_NODE);
-    const pugi::xml_node frame_rate_node = frame_rate_xnode.node();
+    const pugi::xml_node frame_rate_node = xml_node.child(KRA_IMP_FRAME_RATE_NODE);
     animation._frame_rate = frame_rate_node.empty() ? 0U : frame_rate_node.attribute(KRA_IMP_VALUE_ATTRIBUTE).as_uint();
-    const pugi::xpath_node range_xnode = xml_node.select_node(KRA_IMP_RANGE_NODE);
-    const pugi::xml_node range_node = range_xnode.node();
+    const pugi::xml_node range_node = xml_node.child(KRA_IMP_RANGE_NODE);
     animation._from = range_node.empty() ? 0U : range_node.attribute(KRA_IMP_FROM_ATTRIBUTE).as_uint();
     animation._to = range_node.empty() ? 0U : range_node.attribute(KRA_IMP_TO_ATTRIBUTE).as_uint();
 }
 
+bool read_main_doc_image(const pugi::xml_node& document_node, kra_imp_main_doc_t& main_doc)
+{
+    const pugi::xml_node image_node = find_image_node(document_node);
+    if (image_node.empty())
+    {
+        return false;
+    }
+
+    parse_animation(image_node.child(KRA_IMP_ANIMATION_NODE), main_doc._animation);
+    std::memset(main_doc._image_name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
+    std::strncpy(main_doc._image_name, image_node.attribute(KRA_IMP_NAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
+    const pugi::char_t* color_space_attribute = image_node.attribute(KRA_IMP_COLOR_SPACE_NAME_ATTRIBUTE).value();
+    main_doc._color_space_model = to_color_space_model(std::string_view(color_space_attribute));
+    main_doc._channel_depth = to_channel_depth(std::string_view(color_space_attribute));
+    main_doc._width = image_node.attribute(KRA_IMP_WIDTH_ATTRIBUTE).as_ullong();
+    main_doc._height = image_node.attribute(KRA_IMP_HEIGHT_ATTRIBUTE).as_ullong();
+    return true;
+}
+
 KRA_IMP_API kra_imp_error_code_e kra_imp_read_main_doc(const char* xml_buffer, const unsigned long long xml_buffer_size, kra_imp_main_doc_t* main_doc)
 {
     if (xml_buffer == nullptr || xml_buffer_size == 0ULL || main_doc == nullptr)
@@ -222,6 +662,7 @@ KRA_IMP_API kra_imp_error_code_e kra_imp_read_main_doc(const char* xml_buffer, c
         return KRA_IMP_PARAMS_ERROR;
     }
 
+    const scratch_scope_t scratch_scope;
     pugi::xml_document main_doc_xml_document;
     const pugi::xml_parse_result parse_result = main_doc_xml_document.load_buffer(xml_buffer, xml_buffer_size);
     if (!parse_result)
@@ -229,54 +670,50 @@ KRA_IMP_API kra_imp_error_code_e kra_imp_read_main_doc(const char* xml_buffer, c
         return KRA_IMP_PARSE_ERROR;
     }
 
-    const pugi::xpath_node image_xnode = main_doc_xml_document.select_node(KRA_IMP_DOC_IMAGE_NODE);
-    const pugi::xml_node image_node = image_xnode.node();
-    if (image_node.empty())
+    if (!read_main_doc_image(main_doc_xml_document, *main_doc))
     {
         return KRA_IMP_FAIL;
     }
 
-    const pugi::xpath_node animation_xnode = main_doc_xml_document.select_node(KRA_IMP_DOC_ANIMATION_NODE);
-    parse_animation(animation_xnode.node(), main_doc->_animation);
-    std::memset(main_doc->_image_name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
-    std::strncpy(main_doc->_image_name, image_node.attribute(KRA_IMP_NAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
-    const pugi::char_t* color_space_attribute = image_node.attribute(KRA_IMP_COLOR_SPACE_NAME_ATTRIBUTE).value();
-    main_doc->_color_space_model = to_color_space_model(std::string_view(color_space_attribute));
-    main_doc->_width = image_node.attribute(KRA_IMP_WIDTH_ATTRIBUTE).as_ullong();
-    main_doc->_height = image_node.attribute(KRA_IMP_HEIGHT_ATTRIBUTE).as_ullong();
-    const pugi::xpath_node_set layer_nodes = main_doc_xml_document.select_nodes(KRA_IMP_LAYER_NODES);
     main_doc->_layers_count = 0;
-    for (pugi::xpath_node_set::const_iterator it = layer_nodes.begin(); it != layer_nodes.end(); ++it)
+    const pugi::xml_node image_node = find_image_node(main_doc_xml_document);
+    for (pugi::xml_node layer_node = first_layer_node(image_node); layer_node; layer_node = next_layer_node(layer_node))
     {
-        iterate_layers_recursive(it->node(), main_doc->_layers_count);
+        iterate_layers_recursive(layer_node, main_doc->_layers_count);
     }
     return KRA_IMP_SUCCESS;
 }
 
-bool read_image_layer_recursive(const unsigned int layer_index, kra_imp_image_layer_t* image_layer, const pugi::xml_node& node, long& current_layer_index, const long parent_index)
+void read_image_layer_node(const pugi::xml_node& node, const long parent_index, kra_imp_image_layer_t& image_layer)
 {
     const pugi::char_t* node_type_attribute = node.attribute(KRA_IMP_NODE_TYPE_ATTRIBUTE).value();
-    const kra_imp_layer_type_e current_layer_type = to_layer_type(std::string_view(node_type_attribute));
+    image_layer._type = to_layer_type(std::string_view(node_type_attribute));
+    image_layer._opacity = static_cast<unsigned char>(node.attribute(KRA_IMP_OPACITY_ATTRIBUTE).as_uint());
+    image_layer._visibility = static_cast<kra_imp_layer_visibility_e>(node.attribute(KRA_IMP_VISIBLE_ATTRIBUTE).as_int());
+    image_layer._parent_index = parent_index;
+    std::memset(image_layer._file_name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
+    std::memset(image_layer._frame_file_name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
+    std::memset(image_layer._name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
+    std::strncpy(image_layer._file_name, node.attribute(KRA_IMP_FILE_NAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
+    std::strncpy(image_layer._name, node.attribute(KRA_IMP_NAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
+    std::strncpy(image_layer._frame_file_name, node.attribute(KRA_IMP_KEY_FRAMES_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
+}
+
+bool read_image_layer_recursive(const unsigned int layer_index, kra_imp_image_layer_t* image_layer, const pugi::xml_node& node, long& current_layer_index, const long parent_index)
+{
     if (current_layer_index == layer_index)
     {
-        image_layer->_type = current_layer_type;
-        image_layer->_opacity = static_cast<unsigned char>(node.attribute(KRA_IMP_OPACITY_ATTRIBUTE).as_uint());
-        image_layer->_visibility = static_cast<kra_imp_layer_visibility_e>(node.attribute(KRA_IMP_VISIBLE_ATTRIBUTE).as_int());
-        image_layer->_parent_index = parent_index;
-        std::strncpy(image_layer->_file_name, node.attribute(KRA_IMP_FILE_NAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
-        std::strncpy(image_layer->_name, node.attribute(KRA_IMP_NAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
-        std::strncpy(image_layer->_frame_file_name, node.attribute(KRA_IMP_KEY_FRAMES_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
+        read_image_layer_node(node, parent_index, *image_layer);
         return true;
     }
 
     const unsigned long long current_parent_index = current_layer_index;
     ++current_layer_index;
-    if (current_layer_type == KRA_IMP_GROUP_LAYER_TYPE)
+    if (is_group_layer_node(node))
     {
-        const pugi::xpath_node_set layer_nodes = node.select_nodes(KRA_IMP_INNER_LAYER_NODES);
-        for (pugi::xpath_node_set::const_iterator it = layer_nodes.begin(); it != layer_nodes.end(); ++it)
+        for (pugi::xml_node layer_node = first_layer_node(node); layer_node; layer_node = next_layer_node(layer_node))
         {
-            if (read_image_layer_recursive(layer_index, image_layer, it->node(), current_layer_index, current_parent_index))
+            if (read_image_layer_recursive(layer_index, image_layer, layer_node, current_layer_index, current_parent_index))
             {
                 return true;
             }
@@ -294,6 +731,7 @@ KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_layer(const char* xml_buffer
         return KRA_IMP_PARAMS_ERROR;
     }
 
+    const scratch_scope_t scratch_scope;
     pugi::xml_document main_doc_xml_document;
     const pugi::xml_parse_result parse_result = main_doc_xml_document.load_buffer(xml_buffer, xml_buffer_size);
     if (!parse_result)
@@ -301,15 +739,11 @@ KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_layer(const char* xml_buffer
         return KRA_IMP_PARSE_ERROR;
     }
 
-    std::memset(image_layer->_file_name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
-    std::memset(image_layer->_frame_file_name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
-    std::memset(image_layer->_name, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
-
-    const pugi::xpath_node_set layer_nodes = main_doc_xml_document.select_nodes(KRA_IMP_LAYER_NODES);
+    const pugi::xml_node image_node = find_image_node(main_doc_xml_document);
     long current_layer_index = 0;
-    for (pugi::xpath_node_set::const_iterator it = layer_nodes.begin(); it != layer_nodes.end(); ++it)
+    for (pugi::xml_node layer_node = first_layer_node(image_node); layer_node; layer_node = next_layer_node(layer_node))
     {
-        if (read_image_layer_recursive(layer_index, image_layer, it->node(), current_layer_index, -1L))
+        if (read_image_layer_recursive(layer_index, image_layer, layer_node, current_layer_index, -1L))
         {
             return KRA_IMP_SUCCESS;
         }
@@ -318,6 +752,16 @@ KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_layer(const char* xml_buffer
     return KRA_IMP_FAIL;
 }
 
+void read_image_key_frame_node(const pugi::xml_node& node, kra_imp_image_key_frame_t& image_key_frame)
+{
+    image_key_frame._time = node.attribute(KRA_IMP_TIME_ATTRIBUTE).as_uint();
+    const pugi::xml_node offset_node = node.child(KRA_IMP_OFFSET_NODE);
+    image_key_frame._x = offset_node.attribute(KRA_IMP_X_ATTRIBUTE).as_int();
+    image_key_frame._y = offset_node.attribute(KRA_IMP_Y_ATTRIBUTE).as_int();
+    std::memset(image_key_frame._frame, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
+    std::strncpy(image_key_frame._frame, node.attribute(KRA_IMP_FRAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
+}
+
 KRA_IMP_API unsigned int kra_imp_get_image_key_frames_count(const char* xml_buffer, const unsigned long long xml_buffer_size)
 {
     if (xml_buffer == nullptr || xml_buffer_size == 0ULL)
@@ -325,6 +769,7 @@ KRA_IMP_API unsigned int kra_imp_get_image_key_frames_count(const char* xml_buff
         return 0U;
     }
 
+    const scratch_scope_t scratch_scope;
     pugi::xml_document key_frames_xml_document;
     const pugi::xml_parse_result parse_result = key_frames_xml_document.load_buffer(xml_buffer, xml_buffer_size);
     if (!parse_result)
@@ -332,8 +777,12 @@ KRA_IMP_API unsigned int kra_imp_get_image_key_frames_count(const char* xml_buff
         return 0U;
     }
 
-    const pugi::xpath_node_set key_frame_nodes = key_frames_xml_document.select_nodes(KRA_IMP_KEY_FRAME_NODES);
-    return key_frame_nodes.size();
+    unsigned int key_frames_count = 0U;
+    for (pugi::xml_node key_frame_node = first_key_frame_node(key_frames_xml_document); key_frame_node; key_frame_node = next_key_frame_node(key_frame_node))
+    {
+        ++key_frames_count;
+    }
+    return key_frames_count;
 }
 
 KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_key_frame(const char* xml_buffer, const unsigned long long xml_buffer_size, const unsigned int key_frame_index,
@@ -344,6 +793,7 @@ KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_key_frame(const char* xml_bu
         return KRA_IMP_PARAMS_ERROR;
     }
 
+    const scratch_scope_t scratch_scope;
     pugi::xml_document key_frames_xml_document;
     const pugi::xml_parse_result parse_result = key_frames_xml_document.load_buffer(xml_buffer, xml_buffer_size);
     if (!parse_result)
@@ -351,351 +801,1786 @@ KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_key_frame(const char* xml_bu
         return KRA_IMP_PARSE_ERROR;
     }
 
-    const pugi::xpath_node_set key_frame_nodes = key_frames_xml_document.select_nodes(KRA_IMP_KEY_FRAME_NODES);
-    if (key_frame_nodes.size() <= key_frame_index)
+    unsigned int current_key_frame_index = 0U;
+    for (pugi::xml_node key_frame_node = first_key_frame_node(key_frames_xml_document); key_frame_node; key_frame_node = next_key_frame_node(key_frame_node))
     {
-        return KRA_IMP_FAIL;
+        if (current_key_frame_index == key_frame_index)
+        {
+            read_image_key_frame_node(key_frame_node, *image_key_frame);
+            return KRA_IMP_SUCCESS;
+        }
+        ++current_key_frame_index;
     }
 
-    pugi::xpath_node_set::const_iterator it = key_frame_nodes.begin() + key_frame_index;
-    const pugi::xml_node& xml_node = it->node();
-    image_key_frame->_time = xml_node.attribute(KRA_IMP_TIME_ATTRIBUTE).as_uint();
-    const pugi::xml_node& offset_node = xml_node.child(KRA_IMP_OFFSET_NODE);
-    image_key_frame->_x = offset_node.attribute(KRA_IMP_X_ATTRIBUTE).as_int();
-    image_key_frame->_y = offset_node.attribute(KRA_IMP_Y_ATTRIBUTE).as_int();
-    std::memset(image_key_frame->_frame, KRA_IMP_EMPTY_CHAR, KRA_IMP_MAX_NAME_LENGTH);
-    std::strncpy(image_key_frame->_frame, xml_node.attribute(KRA_IMP_FRAME_ATTRIBUTE).value(), KRA_IMP_MAX_NAME_LENGTH - 1);
-    return KRA_IMP_SUCCESS;
+    return KRA_IMP_FAIL;
 }
 
-std::string_view parse_header_element(const char* buffer, const unsigned long long buffer_size, const std::string_view header_element, unsigned int& buffer_offset)
+void flatten_layers_recursive(const pugi::xml_node& xml_node, const long parent_index, const unsigned int depth, memory_vector_t<document_layer_t>& layers)
 {
-    const std::string_view current_header(buffer + buffer_offset, header_element.size());
-    if (header_element.compare(current_header) != 0)
+    long previous_index = -1L;
+    for (pugi::xml_node layer_node = first_layer_node(xml_node); layer_node; layer_node = next_layer_node(layer_node))
     {
-        return {};
-    }
+        const long layer_index = static_cast<long>(layers.size());
+        if (previous_index >= 0L)
+        {
+            layers[previous_index]._next_sibling_index = layer_index;
+        }
+        else if (parent_index >= 0L)
+        {
+            layers[parent_index]._first_child_index = layer_index;
+        }
+
+        layers.push_back({ layer_node, parent_index, -1L, -1L, depth });
+        if (is_group_layer_node(layer_node))
+        {
+            flatten_layers_recursive(layer_node, layer_index, depth + 1U, layers);
+        }
+        previous_index = layer_index;
+    }
+}
+
+bool load_document(const char* xml_buffer, const unsigned long long xml_buffer_size, kra_imp_document_t& document)
+{
+    const pugi::xml_parse_result parse_result = document._xml_document.load_buffer(xml_buffer, xml_buffer_size);
+    if (!parse_result)
+    {
+        return false;
+    }
+
+    try
+    {
+        flatten_layers_recursive(find_image_node(document._xml_document), -1L, 0U, document._layers);
+        for (pugi::xml_node key_frame_node = first_key_frame_node(document._xml_document); key_frame_node; key_frame_node = next_key_frame_node(key_frame_node))
+        {
+            document._key_frames.push_back(key_frame_node);
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        return false;
+    }
+    return true;
+}
+
+kra_imp_error_code_e read_document_image_layers(const kra_imp_document_t& document, kra_imp_image_layer_node_t* layer_nodes, const unsigned int layers_count)
+{
+    if (document._layers.size() < layers_count)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    for (unsigned int layer_index = 0U; layer_index < layers_count; ++layer_index)
+    {
+        const document_layer_t& layer = document._layers[layer_index];
+        kra_imp_image_layer_node_t& layer_node = layer_nodes[layer_index];
+        read_image_layer_node(layer._node, layer._parent_index, layer_node._layer);
+        layer_node._first_child_index = layer._first_child_index;
+        layer_node._next_sibling_index = layer._next_sibling_index;
+        layer_node._depth = layer._depth;
+    }
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_image_layers(const char* xml_buffer, const unsigned long long xml_buffer_size, kra_imp_image_layer_node_t* layer_nodes,
+                                                           const unsigned int layers_count)
+{
+    if (xml_buffer == nullptr || xml_buffer_size == 0ULL || layer_nodes == nullptr || layers_count == 0U)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const scratch_scope_t scratch_scope;
+    kra_imp_document_t document;
+    if (!load_document(xml_buffer, xml_buffer_size, document))
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    return read_document_image_layers(document, layer_nodes, layers_count);
+}
+
+KRA_IMP_API kra_imp_document_t* kra_imp_open_document(const char* xml_buffer, const unsigned long long xml_buffer_size)
+{
+    if (xml_buffer == nullptr || xml_buffer_size == 0ULL)
+    {
+        return nullptr;
+    }
+
+    kra_imp_document_t* document = new_object<kra_imp_document_t>();
+    if (document == nullptr || !load_document(xml_buffer, xml_buffer_size, *document))
+    {
+        delete_object(document);
+        return nullptr;
+    }
+    return document;
+}
+
+KRA_IMP_API void kra_imp_close_document(kra_imp_document_t* document)
+{
+    delete_object(document);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_main_doc(const kra_imp_document_t* document, kra_imp_main_doc_t* main_doc)
+{
+    if (document == nullptr || main_doc == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    if (!read_main_doc_image(document->_xml_document, *main_doc))
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    main_doc->_layers_count = static_cast<unsigned int>(document->_layers.size());
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API unsigned int kra_imp_get_document_layers_count(const kra_imp_document_t* document)
+{
+    return document == nullptr ? 0U : static_cast<unsigned int>(document->_layers.size());
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_image_layer(const kra_imp_document_t* document, const unsigned int layer_index, kra_imp_image_layer_t* image_layer)
+{
+    if (document == nullptr || image_layer == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    if (document->_layers.size() <= layer_index)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    const document_layer_t& layer = document->_layers[layer_index];
+    read_image_layer_node(layer._node, layer._parent_index, *image_layer);
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_image_layers(const kra_imp_document_t* document, kra_imp_image_layer_node_t* layer_nodes, const unsigned int layers_count)
+{
+    if (document == nullptr || layer_nodes == nullptr || layers_count == 0U)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    return read_document_image_layers(*document, layer_nodes, layers_count);
+}
+
+KRA_IMP_API unsigned int kra_imp_get_document_key_frames_count(const kra_imp_document_t* document)
+{
+    return document == nullptr ? 0U : static_cast<unsigned int>(document->_key_frames.size());
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_document_image_key_frame(const kra_imp_document_t* document, const unsigned int key_frame_index,
+                                                                      kra_imp_image_key_frame_t* image_key_frame)
+{
+    if (document == nullptr || image_key_frame == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    if (document->_key_frames.size() <= key_frame_index)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    read_image_key_frame_node(document->_key_frames[key_frame_index], *image_key_frame);
+    return KRA_IMP_SUCCESS;
+}
+
+std::string_view parse_header_element(const char* buffer, const unsigned long long buffer_size, const std::string_view header_element, unsigned int& buffer_offset)
+{
+    if (buffer_offset + header_element.size() > buffer_size)
+    {
+        return {};
+    }
+
+    const std::string_view current_header(buffer + buffer_offset, header_element.size());
+    if (header_element.compare(current_header) != 0)
+    {
+        return {};
+    }
     buffer_offset += header_element.size();
-    unsigned int end_position = buffer_offset + 1U;
-    while (buffer_size > end_position && buffer[end_position] != KRA_IMP_END)
+    const void* line_end = buffer_offset + 1ULL < buffer_size ? std::memchr(buffer + buffer_offset + 1U, KRA_IMP_END, buffer_size - buffer_offset - 1U) : nullptr;
+    const unsigned int end_position = line_end == nullptr ? static_cast<unsigned int>(buffer_size) : static_cast<unsigned int>(static_cast<const char*>(line_end) - buffer);
+    const std::string_view current_header_value(buffer + buffer_offset, end_position - buffer_offset);
+    buffer_offset = end_position + 1U;
+    return current_header_value;
+}
+
+bool get_header_element(const char* buffer, const unsigned long long buffer_size, const std::string_view header, unsigned int& buffer_offset, unsigned int& value)
+{
+    const std::string_view current_header_value = parse_header_element(buffer, buffer_size, header, buffer_offset);
+    if (current_header_value.empty())
+    {
+        return false;
+    }
+
+    // The value is not null terminated when the buffer ends with it, so it is parsed within its bounds only.
+    const char* value_end = current_header_value.data() + current_header_value.size();
+    const std::from_chars_result result = std::from_chars(current_header_value.data(), value_end, value);
+    return result.ec == std::errc() && result.ptr == value_end;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_header(const char* buffer, const unsigned long long buffer_size, kra_imp_layer_data_header_t* layer_data_header)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    static constexpr const std::array<std::string_view, 5> KRA_IMP_HEADERS{ "VERSION ", "TILEWIDTH ", "TILEHEIGHT ", "PIXELSIZE ", "DATA " };
+
+    layer_data_header->_header_size = 0U;
+    if (!get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[0], layer_data_header->_header_size, layer_data_header->_version) ||
+        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[1], layer_data_header->_header_size, layer_data_header->_layer_data_width) ||
+        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[2], layer_data_header->_header_size, layer_data_header->_layer_data_height) ||
+        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[3], layer_data_header->_header_size, layer_data_header->_layer_data_pixel_size) ||
+        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[4], layer_data_header->_header_size, layer_data_header->_layer_datas_count) ||
+        layer_data_header->_header_size > buffer_size)
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    return KRA_IMP_SUCCESS;
+}
+
+kra_imp_error_code_e parse_layer_data_tile(const char* buffer, const unsigned long long buffer_size, unsigned long long& position, kra_imp_layer_data_tile_t& tile)
+{
+    // A tile line holds four fields: "x,y,LZF,size\n".
+    std::array<unsigned long long, 4> separators;
+    if (find_separators(buffer, buffer_size, position + 1ULL, separators.data(), static_cast<unsigned int>(separators.size())) != separators.size())
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    if (std::from_chars(&buffer[position], &buffer[separators[0]], tile._x_offset).ec != std::errc())
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    if (std::from_chars(&buffer[separators[0] + 1ULL], &buffer[separators[1]], tile._y_offset).ec != std::errc())
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    const std::string_view tile_compression_type(&buffer[separators[1] + 1ULL], separators[2] - separators[1] - 1ULL);
+    if (tile_compression_type.compare(KRA_IMP_COMPRESSION_TYPE) != 0)
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    unsigned int compressed_size = 0U;
+    if (std::from_chars(&buffer[separators[2] + 1ULL], &buffer[separators[3]], compressed_size).ec != std::errc())
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    const unsigned long long start_position = separators[3] + 1ULL;
+    if (compressed_size == 0U || start_position >= buffer_size || compressed_size > buffer_size - start_position)
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    const unsigned char compression_flag = static_cast<unsigned char>(buffer[start_position]);
+    if (compression_flag != KRA_IMP_UNCOMPRESSED_TILE && compression_flag != KRA_IMP_LZF_COMPRESSED_TILE)
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    tile._compression = static_cast<kra_imp_tile_compression_e>(compression_flag);
+    tile._data = &buffer[start_position + 1UL];
+    tile._data_size = compressed_size - 1U;
+    position = start_position + compressed_size;
+    return KRA_IMP_SUCCESS;
+}
+
+kra_imp_error_code_e decompress_layer_data_tile(const kra_imp_layer_data_tile_t& tile, char* output, const unsigned long long output_size,
+                                                const unsigned long long output_capacity)
+{
+    if (KRA_IMP_UNCOMPRESSED_TILE == tile._compression)
+    {
+        if (tile._data_size < output_size)
+        {
+            return KRA_IMP_DECOMPRESS_ERROR;
+        }
+        std::memcpy(output, tile._data, output_size);
+    }
+    else if (KRA_IMP_LZF_COMPRESSED_TILE == tile._compression)
+    {
+        if (!lzf_validate(tile._data, tile._data_size, output_size))
+        {
+            return KRA_IMP_DECOMPRESS_ERROR;
+        }
+        lzf_decode_validated(tile._data, tile._data_size, output, output_size, output_capacity);
+    }
+    else
+    {
+        return KRA_IMP_DECOMPRESS_ERROR;
+    }
+
+    return KRA_IMP_SUCCESS;
+}
+
+// Every walk over the tiles of a layer data goes through here, so the buffer bounds are checked in one place.
+// The function is called with each parsed tile and its index, and the walk stops on the first error it returns.
+template <typename Function>
+kra_imp_error_code_e for_each_layer_data_tile(const char* buffer, const unsigned long long buffer_size, const unsigned int tiles_count, Function&& function)
+{
+    kra_imp_layer_data_tile_t tile{};
+    unsigned long long position = 0ULL;
+    for (unsigned int tile_index = 0U; tile_index < tiles_count; ++tile_index)
+    {
+        if (position + 1ULL >= buffer_size)
+        {
+            return KRA_IMP_PARSE_ERROR;
+        }
+
+        kra_imp_error_code_e result = parse_layer_data_tile(buffer, buffer_size, position, tile);
+        if (result != KRA_IMP_SUCCESS)
+        {
+            return result;
+        }
+
+        result = function(tile, tile_index);
+        if (result != KRA_IMP_SUCCESS)
+        {
+            return result;
+        }
+    }
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_tile(const char* input, const unsigned long long input_size, unsigned int layer_data_tile_index, char* output,
+                                                              const unsigned long long output_size, int* x_offset, int* y_offset)
+{
+    if (input == nullptr || input_size == 0ULL || output == nullptr || output_size == 0ULL || x_offset == nullptr || y_offset == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    kra_imp_layer_output_data_t output_data{ output, output_size, 0, 0 };
+    const kra_imp_error_code_e result = kra_imp_read_layer_data(input, input_size, layer_data_tile_index, &output_data);
+    *x_offset = output_data._x_offset;
+    *y_offset = output_data._y_offset;
+    return result;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data(const char* buffer, const unsigned long long buffer_size, const unsigned int data_index,
+                                                         kra_imp_layer_output_data_t* output)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || output == nullptr || output->_buffer == nullptr || output->_buffer_size == 0ULL)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    kra_imp_layer_data_tile_t tile{};
+    unsigned long long position = 0UL;
+    unsigned int current_index = 0U;
+    while (position + 1UL < buffer_size)
+    {
+        const kra_imp_error_code_e result = parse_layer_data_tile(buffer, buffer_size, position, tile);
+        if (result != KRA_IMP_SUCCESS)
+        {
+            return result;
+        }
+
+        if (current_index == data_index)
+        {
+            output->_x_offset = tile._x_offset;
+            output->_y_offset = tile._y_offset;
+            return decompress_layer_data_tile(tile, output->_buffer, output->_buffer_size, output->_buffer_size);
+        }
+        ++current_index;
+    }
+    return KRA_IMP_FAIL;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_index_layer_data(const char* buffer, const unsigned long long buffer_size, kra_imp_layer_data_tile_t* tiles,
+                                                          const unsigned int tiles_count)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || tiles == nullptr || tiles_count == 0U)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const auto store_tile = [tiles](const kra_imp_layer_data_tile_t& tile, const unsigned int tile_index)
+    {
+        tiles[tile_index] = tile;
+        return KRA_IMP_SUCCESS;
+    };
+    return for_each_layer_data_tile(buffer, buffer_size, tiles_count, store_tile);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data(const kra_imp_layer_data_tile_t* tile, kra_imp_layer_output_data_t* output)
+{
+    if (tile == nullptr || tile->_data == nullptr || output == nullptr || output->_buffer == nullptr || output->_buffer_size == 0ULL)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    output->_x_offset = tile->_x_offset;
+    output->_y_offset = tile->_y_offset;
+    return decompress_layer_data_tile(*tile, output->_buffer, output->_buffer_size, output->_buffer_size);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_uncompressed_tile_data(const kra_imp_layer_data_tile_t* tile, const kra_imp_layer_data_header_t* layer_data_header,
+                                                                    const char** tile_data, unsigned long long* tile_data_size)
+{
+    if (tile == nullptr || tile->_data == nullptr || layer_data_header == nullptr || tile_data == nullptr || tile_data_size == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    if (tile->_compression != KRA_IMP_UNCOMPRESSED_TILE)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    const unsigned long long tile_size =
+        static_cast<unsigned long long>(layer_data_header->_layer_data_width) * layer_data_header->_layer_data_height * layer_data_header->_layer_data_pixel_size;
+    if (tile_size == 0ULL || tile->_data_size < tile_size)
+    {
+        return KRA_IMP_DECOMPRESS_ERROR;
+    }
+
+    *tile_data = tile->_data;
+    *tile_data_size = tile_size;
+    return KRA_IMP_SUCCESS;
+}
+
+long long floor_divide(const long long value, const unsigned int divisor)
+{
+    return value >= 0LL ? value / divisor : -((-value + divisor - 1LL) / divisor);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_layer_data_bounds(const char* buffer, const unsigned long long buffer_size, const kra_imp_layer_data_header_t* layer_data_header,
+                                                               kra_imp_layer_data_bounds_t* bounds)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || layer_data_header->_layer_data_width == 0U ||
+        layer_data_header->_layer_data_height == 0U || bounds == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const unsigned int tile_width = layer_data_header->_layer_data_width;
+    const unsigned int tile_height = layer_data_header->_layer_data_height;
+    long long first_x = std::numeric_limits<long long>::max();
+    long long first_y = std::numeric_limits<long long>::max();
+    long long last_x = std::numeric_limits<long long>::min();
+    long long last_y = std::numeric_limits<long long>::min();
+    const auto extend_bounds = [&](const kra_imp_layer_data_tile_t& tile, unsigned int)
+    {
+        first_x = std::min<long long>(first_x, tile._x_offset);
+        first_y = std::min<long long>(first_y, tile._y_offset);
+        last_x = std::max<long long>(last_x, static_cast<long long>(tile._x_offset) + tile_width);
+        last_y = std::max<long long>(last_y, static_cast<long long>(tile._y_offset) + tile_height);
+        return KRA_IMP_SUCCESS;
+    };
+    const kra_imp_error_code_e result = for_each_layer_data_tile(buffer, buffer_size, layer_data_header->_layer_datas_count, extend_bounds);
+    if (result != KRA_IMP_SUCCESS)
+    {
+        return result;
+    }
+
+    *bounds = {};
+    if (layer_data_header->_layer_datas_count == 0U)
+    {
+        return KRA_IMP_SUCCESS;
+    }
+
+    if (last_x - first_x > std::numeric_limits<unsigned int>::max() || last_y - first_y > std::numeric_limits<unsigned int>::max())
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    bounds->_x_offset = static_cast<int>(first_x);
+    bounds->_y_offset = static_cast<int>(first_y);
+    bounds->_width = static_cast<unsigned int>(last_x - first_x);
+    bounds->_height = static_cast<unsigned int>(last_y - first_y);
+    bounds->_columns = static_cast<unsigned int>((last_x - first_x + tile_width - 1LL) / tile_width);
+    bounds->_rows = static_cast<unsigned int>((last_y - first_y + tile_height - 1LL) / tile_height);
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_layer_data_occupancy(const char* buffer, const unsigned long long buffer_size,
+                                                                  const kra_imp_layer_data_header_t* layer_data_header, const kra_imp_layer_data_bounds_t* bounds,
+                                                                  unsigned char* occupancy, const unsigned long long occupancy_size)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || layer_data_header->_layer_data_width == 0U ||
+        layer_data_header->_layer_data_height == 0U || bounds == nullptr || (occupancy == nullptr && occupancy_size != 0ULL))
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const unsigned long long cells_count = static_cast<unsigned long long>(bounds->_columns) * bounds->_rows;
+    if (occupancy_size < (cells_count + 7ULL) / 8ULL)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    // Unaligned tiles mark every cell of the bounds grid they overlap, and tiles outside of the grid are ignored.
+    const unsigned int tile_width = layer_data_header->_layer_data_width;
+    const unsigned int tile_height = layer_data_header->_layer_data_height;
+    std::fill_n(occupancy, (cells_count + 7ULL) / 8ULL, static_cast<unsigned char>(0U));
+    const auto mark_occupied_cells = [&](const kra_imp_layer_data_tile_t& tile, unsigned int)
+    {
+        const long long tile_x = static_cast<long long>(tile._x_offset) - bounds->_x_offset;
+        const long long tile_y = static_cast<long long>(tile._y_offset) - bounds->_y_offset;
+        const long long first_column = std::max<long long>(floor_divide(tile_x, tile_width), 0LL);
+        const long long last_column = std::min<long long>(floor_divide(tile_x + tile_width - 1LL, tile_width), bounds->_columns - 1LL);
+        const long long first_row = std::max<long long>(floor_divide(tile_y, tile_height), 0LL);
+        const long long last_row = std::min<long long>(floor_divide(tile_y + tile_height - 1LL, tile_height), bounds->_rows - 1LL);
+        for (long long row = first_row; row <= last_row; ++row)
+        {
+            for (long long column = first_column; column <= last_column; ++column)
+            {
+                const unsigned long long cell = static_cast<unsigned long long>(row) * bounds->_columns + static_cast<unsigned long long>(column);
+                occupancy[cell / 8ULL] |= static_cast<unsigned char>(1U << (cell % 8ULL));
+            }
+        }
+        return KRA_IMP_SUCCESS;
+    };
+    return for_each_layer_data_tile(buffer, buffer_size, layer_data_header->_layer_datas_count, mark_occupied_cells);
+}
+
+struct kra_imp_layer_data_stream_t
+{
+    kra_imp_layer_data_tile_function _tile_function{ nullptr };
+    void* _user_data{ nullptr };
+    kra_imp_layer_data_header_t _layer_data_header{};
+    bool _header_read{ false };
+    unsigned int _tiles_read{ 0U };
+    memory_vector_t<char> _pending_record;
+    unsigned long long _pending_record_size{ 0ULL };
+};
+
+bool is_layer_data_stream_finished(const kra_imp_layer_data_stream_t& stream)
+{
+    return stream._header_read && stream._tiles_read >= stream._layer_data_header._layer_datas_count;
+}
+
+// Finds the size of the record (the header or a tile) starting at the beginning of the buffer.
+// Returns KRA_IMP_FAIL if more bytes are needed to tell the size.
+kra_imp_error_code_e get_layer_data_record_size(const kra_imp_layer_data_stream_t& stream, const char* buffer, const unsigned long long buffer_size,
+                                                unsigned long long& record_size)
+{
+    const unsigned int lines_count = stream._header_read ? 1U : KRA_IMP_LAYER_DATA_HEADER_LINES_COUNT;
+    unsigned long long line_start = 0ULL;
+    unsigned long long line_end = 0ULL;
+    for (unsigned int line_index = 0U; line_index < lines_count; ++line_index)
+    {
+        line_start = line_end;
+        const unsigned long long line_limit = std::min(buffer_size, line_start + KRA_IMP_MAX_STREAMED_LINE_SIZE);
+        const void* end = std::memchr(buffer + line_start, KRA_IMP_END, line_limit - line_start);
+        if (end == nullptr)
+        {
+            return line_limit - line_start < KRA_IMP_MAX_STREAMED_LINE_SIZE ? KRA_IMP_FAIL : KRA_IMP_PARSE_ERROR;
+        }
+        line_end = static_cast<unsigned long long>(static_cast<const char*>(end) - buffer) + 1ULL;
+    }
+
+    if (!stream._header_read)
+    {
+        record_size = line_end;
+        return KRA_IMP_SUCCESS;
+    }
+
+    // The compressed size is the last element of the tile's header line.
+    const std::string_view tile_header(buffer + line_start, line_end - line_start - 1ULL);
+    const std::size_t separator_position = tile_header.rfind(KRA_IMP_SEPARATOR);
+    unsigned int compressed_size = 0U;
+    if (separator_position == std::string_view::npos ||
+        std::from_chars(tile_header.data() + separator_position + 1U, tile_header.data() + tile_header.size(), compressed_size).ec != std::errc())
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    const kra_imp_layer_data_header_t& header = stream._layer_data_header;
+    const unsigned long long max_compressed_size =
+        1ULL + static_cast<unsigned long long>(header._layer_data_width) * header._layer_data_height * header._layer_data_pixel_size;
+    if (compressed_size > max_compressed_size)
+    {
+        return KRA_IMP_PARSE_ERROR;
+    }
+
+    record_size = line_end + compressed_size;
+    return KRA_IMP_SUCCESS;
+}
+
+kra_imp_error_code_e read_layer_data_record(kra_imp_layer_data_stream_t& stream, const char* record, const unsigned long long record_size)
+{
+    if (!stream._header_read)
+    {
+        const kra_imp_error_code_e result = kra_imp_read_layer_data_header(record, record_size, &stream._layer_data_header);
+        stream._header_read = result == KRA_IMP_SUCCESS;
+        return result;
+    }
+
+    unsigned long long position = 0ULL;
+    kra_imp_layer_data_tile_t tile;
+    const kra_imp_error_code_e result = parse_layer_data_tile(record, record_size, position, tile);
+    if (result != KRA_IMP_SUCCESS)
+    {
+        return result;
+    }
+
+    // A tile counts as read only once the user accepted it, so a stream stopped on its last tile is not finished.
+    const kra_imp_error_code_e tile_result = stream._tile_function(stream._user_data, &stream._layer_data_header, &tile);
+    if (tile_result == KRA_IMP_SUCCESS)
+    {
+        ++stream._tiles_read;
+    }
+    return tile_result;
+}
+
+KRA_IMP_API kra_imp_layer_data_stream_t* kra_imp_open_layer_data_stream(kra_imp_layer_data_tile_function tile_function, void* user_data)
+{
+    if (tile_function == nullptr)
+    {
+        return nullptr;
+    }
+
+    kra_imp_layer_data_stream_t* stream = new_object<kra_imp_layer_data_stream_t>();
+    if (stream == nullptr)
+    {
+        return nullptr;
+    }
+
+    stream->_tile_function = tile_function;
+    stream->_user_data = user_data;
+    return stream;
+}
+
+kra_imp_error_code_e read_layer_data_stream_chunk(kra_imp_layer_data_stream_t& stream, const char* chunk, const unsigned long long chunk_size)
+{
+    unsigned long long position = 0ULL;
+    while (position < chunk_size && !is_layer_data_stream_finished(stream))
+    {
+        if (stream._pending_record.empty())
+        {
+            // Records fully contained in the chunk are read in place, only a record split between chunks is copied.
+            unsigned long long record_size = 0ULL;
+            const kra_imp_error_code_e result = get_layer_data_record_size(stream, chunk + position, chunk_size - position, record_size);
+            if (result == KRA_IMP_SUCCESS && record_size <= chunk_size - position)
+            {
+                const kra_imp_error_code_e read_result = read_layer_data_record(stream, chunk + position, record_size);
+                if (read_result != KRA_IMP_SUCCESS)
+                {
+                    return read_result;
+                }
+                position += record_size;
+                continue;
+            }
+
+            if (result == KRA_IMP_PARSE_ERROR)
+            {
+                return result;
+            }
+
+            stream._pending_record.assign(chunk + position, chunk + chunk_size);
+            stream._pending_record_size = result == KRA_IMP_SUCCESS ? record_size : 0ULL;
+            return KRA_IMP_SUCCESS;
+        }
+
+        // Appends no more than the rest of the pending record, or the next line while its size is still unknown.
+        unsigned long long bytes_count = chunk_size - position;
+        if (stream._pending_record_size != 0ULL)
+        {
+            bytes_count = std::min(bytes_count, stream._pending_record_size - stream._pending_record.size());
+        }
+        else if (const void* line_end = std::memchr(chunk + position, KRA_IMP_END, bytes_count))
+        {
+            bytes_count = static_cast<unsigned long long>(static_cast<const char*>(line_end) - (chunk + position)) + 1ULL;
+        }
+        stream._pending_record.insert(stream._pending_record.end(), chunk + position, chunk + position + bytes_count);
+        position += bytes_count;
+
+        if (stream._pending_record_size == 0ULL)
+        {
+            const kra_imp_error_code_e result = get_layer_data_record_size(stream, stream._pending_record.data(), stream._pending_record.size(), stream._pending_record_size);
+            if (result == KRA_IMP_PARSE_ERROR)
+            {
+                return result;
+            }
+            if (result != KRA_IMP_SUCCESS)
+            {
+                stream._pending_record_size = 0ULL;
+                continue;
+            }
+        }
+
+        if (stream._pending_record.size() == stream._pending_record_size)
+        {
+            const kra_imp_error_code_e read_result = read_layer_data_record(stream, stream._pending_record.data(), stream._pending_record_size);
+            stream._pending_record.clear();
+            stream._pending_record_size = 0ULL;
+            if (read_result != KRA_IMP_SUCCESS)
+            {
+                return read_result;
+            }
+        }
+    }
+
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_stream(kra_imp_layer_data_stream_t* stream, const char* chunk, const unsigned long long chunk_size)
+{
+    if (stream == nullptr || (chunk == nullptr && chunk_size != 0ULL))
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    try
+    {
+        return read_layer_data_stream_chunk(*stream, chunk, chunk_size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        // The bytes of the pending record are lost, so the stream cannot be continued and closing it reports a parse error.
+        stream->_pending_record.clear();
+        stream->_pending_record_size = 0ULL;
+        return KRA_IMP_FAIL;
+    }
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_close_layer_data_stream(kra_imp_layer_data_stream_t* stream)
+{
+    if (stream == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const bool finished = is_layer_data_stream_finished(*stream);
+    delete_object(stream);
+    return finished ? KRA_IMP_SUCCESS : KRA_IMP_PARSE_ERROR;
+}
+
+kra_imp_error_code_e on_layer_data_stream_chunk(void* stream, const char* chunk, unsigned long long chunk_size)
+{
+    return kra_imp_read_layer_data_stream(static_cast<kra_imp_layer_data_stream_t*>(stream), chunk, chunk_size);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_stream_layer_data(kra_imp_archive_t* archive, const char* file_path, kra_imp_layer_data_tile_function tile_function,
+                                                           void* user_data)
+{
+    if (archive == nullptr || file_path == nullptr || tile_function == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    kra_imp_layer_data_stream_t stream;
+    stream._tile_function = tile_function;
+    stream._user_data = user_data;
+    const kra_imp_error_code_e result = kra_imp_stream_file(archive, file_path, on_layer_data_stream_chunk, &stream);
+    if (result != KRA_IMP_SUCCESS)
+    {
+        return result;
+    }
+
+    return is_layer_data_stream_finished(stream) ? KRA_IMP_SUCCESS : KRA_IMP_PARSE_ERROR;
+}
+
+kra_imp_error_code_e get_layer_data_atlas_tile_size(const kra_imp_layer_data_header_t& layer_data_header, const kra_imp_layer_data_atlas_t& atlas,
+                                                    unsigned long long& tile_size)
+{
+    tile_size = static_cast<unsigned long long>(layer_data_header._layer_data_width) * layer_data_header._layer_data_height * layer_data_header._layer_data_pixel_size;
+    const unsigned int tiles_count = layer_data_header._layer_datas_count;
+    if (atlas._buffer == nullptr || atlas._offsets == nullptr || tile_size == 0ULL || atlas._offsets_count < tiles_count || atlas._buffer_size / tile_size < tiles_count)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    return KRA_IMP_SUCCESS;
+}
+
+kra_imp_error_code_e read_layer_data_atlas_tile(const kra_imp_layer_data_tile_t& tile, const unsigned int tile_index, const unsigned long long tile_size,
+                                                kra_imp_layer_data_atlas_t& atlas)
+{
+    // Neighbouring tiles may be decoded concurrently, so no slack past the tile is granted.
+    const kra_imp_error_code_e result = decompress_layer_data_tile(tile, atlas._buffer + tile_index * tile_size, tile_size, tile_size);
+    if (result != KRA_IMP_SUCCESS)
+    {
+        return result;
+    }
+
+    atlas._offsets[tile_index]._x_offset = tile._x_offset;
+    atlas._offsets[tile_index]._y_offset = tile._y_offset;
+    return KRA_IMP_SUCCESS;
+}
+
+kra_imp_error_code_e read_layer_data_atlas_tiles(const char* buffer, const unsigned long long buffer_size, const unsigned int tiles_count, const unsigned long long tile_size,
+                                                 kra_imp_layer_data_atlas_t& atlas)
+{
+    const auto read_atlas_tile = [&](const kra_imp_layer_data_tile_t& tile, const unsigned int tile_index)
+    {
+        return read_layer_data_atlas_tile(tile, tile_index, tile_size, atlas);
+    };
+    return for_each_layer_data_tile(buffer, buffer_size, tiles_count, read_atlas_tile);
+}
+
+struct layer_data_atlas_task_t
+{
+    const kra_imp_layer_data_tile_t* _tiles{ nullptr };
+    unsigned int _first_tile_index{ 0U };
+    unsigned int _tiles_count{ 0U };
+    unsigned long long _tile_size{ 0ULL };
+    kra_imp_layer_data_atlas_t* _atlas{ nullptr };
+    kra_imp_error_code_e _result{ KRA_IMP_FAIL };
+};
+
+void run_layer_data_atlas_task(void* task_data)
+{
+    layer_data_atlas_task_t* task = static_cast<layer_data_atlas_task_t*>(task_data);
+    task->_result = KRA_IMP_SUCCESS;
+    for (unsigned int tile_index = task->_first_tile_index; tile_index < task->_first_tile_index + task->_tiles_count; ++tile_index)
+    {
+        task->_result = read_layer_data_atlas_tile(task->_tiles[tile_index], tile_index, task->_tile_size, *task->_atlas);
+        if (task->_result != KRA_IMP_SUCCESS)
+        {
+            return;
+        }
+    }
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_atlas(const char* buffer, const unsigned long long buffer_size, const kra_imp_layer_data_header_t* layer_data_header,
+                                                               kra_imp_layer_data_atlas_t* atlas)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || atlas == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    unsigned long long tile_size = 0ULL;
+    if (get_layer_data_atlas_tile_size(*layer_data_header, *atlas, tile_size) != KRA_IMP_SUCCESS)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    return read_layer_data_atlas_tiles(buffer, buffer_size, layer_data_header->_layer_datas_count, tile_size, *atlas);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_atlas_parallel(const char* buffer, const unsigned long long buffer_size,
+                                                                        const kra_imp_layer_data_header_t* layer_data_header, kra_imp_layer_data_atlas_t* atlas,
+                                                                        const kra_imp_executor_t* executor)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || atlas == nullptr || executor == nullptr || executor->_submit == nullptr ||
+        executor->_wait == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    unsigned long long tile_size = 0ULL;
+    if (get_layer_data_atlas_tile_size(*layer_data_header, *atlas, tile_size) != KRA_IMP_SUCCESS)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    // Splits the tiles into contiguous ranges, a few per worker to even out tiles that decompress slower than others.
+    static constexpr unsigned int TASKS_PER_WORKER{ 4U };
+    static constexpr unsigned int MAX_TASKS_COUNT{ 256U };
+    std::array<layer_data_atlas_task_t, MAX_TASKS_COUNT> tasks;
+    const unsigned int tiles_count = layer_data_header->_layer_datas_count;
+    if (tiles_count == 0U)
+    {
+        return KRA_IMP_SUCCESS;
+    }
+
+    // Workers are clamped before multiplying, so a large user supplied count cannot wrap around.
+    const unsigned int workers_count = std::min({ std::max(executor->_workers_count, 1U), tiles_count, MAX_TASKS_COUNT });
+    const unsigned int tasks_count = std::min({ tiles_count, workers_count * TASKS_PER_WORKER, MAX_TASKS_COUNT });
+
+    // Tile headers are found by a single serial walk, then every task decompresses its range of the index.
+    memory_vector_t<kra_imp_layer_data_tile_t> tiles;
+    try
+    {
+        tiles.resize(tiles_count);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    const kra_imp_error_code_e index_result = kra_imp_index_layer_data(buffer, buffer_size, tiles.data(), tiles_count);
+    if (index_result != KRA_IMP_SUCCESS)
+    {
+        return index_result;
+    }
+
+    unsigned int tile_index = 0U;
+    for (unsigned int task_index = 0U; task_index < tasks_count; ++task_index)
+    {
+        layer_data_atlas_task_t& task = tasks[task_index];
+        task._tiles = tiles.data();
+        task._first_tile_index = tile_index;
+        task._tiles_count = tiles_count / tasks_count + (task_index < tiles_count % tasks_count ? 1U : 0U);
+        task._tile_size = tile_size;
+        task._atlas = atlas;
+        tile_index += task._tiles_count;
+    }
+
+    for (unsigned int task_index = 0U; task_index < tasks_count; ++task_index)
+    {
+        executor->_submit(executor->_context, run_layer_data_atlas_task, &tasks[task_index]);
+    }
+    executor->_wait(executor->_context);
+
+    for (unsigned int task_index = 0U; task_index < tasks_count; ++task_index)
+    {
+        if (tasks[task_index]._result != KRA_IMP_SUCCESS)
+        {
+            return tasks[task_index]._result;
+        }
+    }
+
+    return KRA_IMP_SUCCESS;
+}
+
+static constexpr const unsigned long long KRA_IMP_NO_POSITION{ ~0ULL };
+
+struct layer_data_index_task_t
+{
+    const char* _buffer{ nullptr };
+    unsigned long long _buffer_size{ 0ULL };
+    unsigned long long _begin{ 0ULL };
+    unsigned long long _end{ 0ULL };
+    unsigned long long _start_position{ KRA_IMP_NO_POSITION };
+    unsigned long long _exit_position{ KRA_IMP_NO_POSITION };
+    memory_vector_t<kra_imp_layer_data_tile_t> _tiles;
+    kra_imp_error_code_e _result{ KRA_IMP_SUCCESS };
+};
+
+bool is_tile_line_chain(const char* buffer, const unsigned long long buffer_size, unsigned long long position)
+{
+    static constexpr unsigned int CHAINED_TILES_COUNT{ 3U };
+    kra_imp_layer_data_tile_t tile{};
+    for (unsigned int tile_index = 0U; tile_index < CHAINED_TILES_COUNT && position != buffer_size; ++tile_index)
+    {
+        if (position + 1ULL >= buffer_size || parse_layer_data_tile(buffer, buffer_size, position, tile) != KRA_IMP_SUCCESS ||
+            (tile._compression != KRA_IMP_UNCOMPRESSED_TILE && tile._compression != KRA_IMP_LZF_COMPRESSED_TILE))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned long long skip_number_backwards(const char* buffer, const unsigned long long lower_bound, unsigned long long position)
+{
+    const unsigned long long number_end = position;
+    while (position > lower_bound && buffer[position - 1ULL] >= '0' && buffer[position - 1ULL] <= '9')
+    {
+        --position;
+    }
+    if (position != number_end && position > lower_bound && buffer[position - 1ULL] == '-')
+    {
+        --position;
+    }
+    return position == number_end ? KRA_IMP_NO_POSITION : position;
+}
+
+// Speculatively finds the first tile line at or after `from`, by looking for ",LZF," and checking that the
+// following tiles chain up. Returns KRA_IMP_NO_POSITION if none is found.
+unsigned long long find_tile_line(const char* buffer, const unsigned long long buffer_size, const unsigned long long from)
+{
+    static constexpr std::string_view TILE_COMPRESSION_FIELD{ ",LZF," };
+    const std::string_view data(buffer, buffer_size);
+    for (unsigned long long field_position = data.find(TILE_COMPRESSION_FIELD, from); field_position != std::string_view::npos;
+         field_position = data.find(TILE_COMPRESSION_FIELD, field_position + 1ULL))
+    {
+        const unsigned long long y_position = skip_number_backwards(buffer, from, field_position);
+        if (y_position == KRA_IMP_NO_POSITION || y_position == from || buffer[y_position - 1ULL] != KRA_IMP_SEPARATOR)
+        {
+            continue;
+        }
+
+        const unsigned long long x_position = skip_number_backwards(buffer, from, y_position - 1ULL);
+        if (x_position != KRA_IMP_NO_POSITION && is_tile_line_chain(buffer, buffer_size, x_position))
+        {
+            return x_position;
+        }
+    }
+    return KRA_IMP_NO_POSITION;
+}
+
+void index_layer_data_range(layer_data_index_task_t& task, unsigned long long position)
+{
+    task._start_position = position;
+    task._tiles.clear();
+    task._result = KRA_IMP_SUCCESS;
+    kra_imp_layer_data_tile_t tile{};
+    while (position < task._end)
+    {
+        if (position + 1ULL >= task._buffer_size)
+        {
+            task._result = KRA_IMP_PARSE_ERROR;
+            break;
+        }
+
+        task._result = parse_layer_data_tile(task._buffer, task._buffer_size, position, tile);
+        if (task._result != KRA_IMP_SUCCESS)
+        {
+            break;
+        }
+        try
+        {
+            task._tiles.push_back(tile);
+        }
+        catch (const std::bad_alloc&)
+        {
+            task._result = KRA_IMP_FAIL;
+            break;
+        }
+    }
+    task._exit_position = position;
+}
+
+void run_layer_data_index_task(void* task_data)
+{
+    layer_data_index_task_t& task = *static_cast<layer_data_index_task_t*>(task_data);
+    const unsigned long long start_position = task._begin == 0ULL ? 0ULL : find_tile_line(task._buffer, task._buffer_size, task._begin);
+    if (start_position != KRA_IMP_NO_POSITION)
+    {
+        index_layer_data_range(task, start_position);
+    }
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_index_layer_data_parallel(const char* buffer, const unsigned long long buffer_size, kra_imp_layer_data_tile_t* tiles,
+                                                                   const unsigned int tiles_count, const kra_imp_executor_t* executor)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || tiles == nullptr || tiles_count == 0U || executor == nullptr || executor->_submit == nullptr ||
+        executor->_wait == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    // Chunks smaller than this are not worth a task; tile lines are short, so resynchronizing costs little.
+    static constexpr unsigned long long MIN_CHUNK_SIZE{ 256ULL * 1024ULL };
+    static constexpr unsigned int TASKS_PER_WORKER{ 4U };
+    static constexpr unsigned int MAX_TASKS_COUNT{ 256U };
+    const unsigned long long chunks_count = std::min<unsigned long long>(buffer_size / MIN_CHUNK_SIZE, MAX_TASKS_COUNT);
+    const unsigned int workers_count = static_cast<unsigned int>(std::min<unsigned long long>(std::max(executor->_workers_count, 1U), chunks_count));
+    const unsigned int tasks_count = static_cast<unsigned int>(std::min<unsigned long long>(chunks_count, workers_count * TASKS_PER_WORKER));
+    if (tasks_count <= 1U)
+    {
+        return kra_imp_index_layer_data(buffer, buffer_size, tiles, tiles_count);
+    }
+
+    memory_vector_t<layer_data_index_task_t> tasks;
+    try
+    {
+        tasks.resize(tasks_count);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    for (unsigned int task_index = 0U; task_index < tasks_count; ++task_index)
+    {
+        layer_data_index_task_t& task = tasks[task_index];
+        task._buffer = buffer;
+        task._buffer_size = buffer_size;
+        task._begin = buffer_size / tasks_count * task_index;
+        task._end = task_index + 1U == tasks_count ? buffer_size : buffer_size / tasks_count * (task_index + 1U);
+        executor->_submit(executor->_context, run_layer_data_index_task, &task);
+    }
+    executor->_wait(executor->_context);
+
+    // Each chunk is trusted only if it started where the previous one left off; otherwise it is walked again from there.
+    unsigned int tile_index = 0U;
+    unsigned long long position = 0ULL;
+    for (layer_data_index_task_t& task : tasks)
+    {
+        if (task._start_position != position)
+        {
+            index_layer_data_range(task, position);
+        }
+
+        const unsigned int chunk_tiles_count = static_cast<unsigned int>(std::min<unsigned long long>(task._tiles.size(), tiles_count - tile_index));
+        std::copy_n(task._tiles.begin(), chunk_tiles_count, tiles + tile_index);
+        tile_index += chunk_tiles_count;
+        if (tile_index == tiles_count)
+        {
+            return KRA_IMP_SUCCESS;
+        }
+
+        if (task._result != KRA_IMP_SUCCESS)
+        {
+            return task._result;
+        }
+        position = task._exit_position;
+    }
+
+    return KRA_IMP_PARSE_ERROR;
+}
+
+void delinearize(const char* input, const unsigned long long input_size, const unsigned int input_width, const unsigned int pixel_size, char* output,
+                 const unsigned int output_width, const unsigned long long output_offset)
+{
+    const delinearize_row_function delinearize_row_kernel = find_delinearize_row_function(pixel_size);
+    const unsigned long long input_rows = input_size / (static_cast<unsigned long long>(pixel_size) * input_width);
+    const unsigned long long pixels_to_delinearize = input_size / pixel_size;
+    unsigned long long output_idx = output_offset;
+    std::array<const char*, KRA_IMP_MAX_PIXEL_SIZE> planes{};
+    for (unsigned long long y = 0UL; y < input_rows; ++y)
+    {
+        const unsigned long long input_idx = y * input_width;
+        for (unsigned int plane_index = 0U; plane_index < pixel_size; ++plane_index)
+        {
+            planes[plane_index] = input + plane_index * pixels_to_delinearize + input_idx;
+        }
+        delinearize_row_kernel(planes.data(), pixel_size, output + output_idx, input_width);
+        output_idx += static_cast<unsigned long long>(output_width) * pixel_size;
+    }
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_to_bgra(const char* input, char* output, const unsigned long long buffer_size, const unsigned int width)
+{
+    return kra_imp_delinearize_to_bgra_with_offset(input, buffer_size, width, output, buffer_size, width, 0ULL);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_to_bgra_with_offset(const char* input, const unsigned long long input_size, const unsigned int input_width, char* output,
+                                                                         const unsigned long long output_size, const unsigned int output_width,
+                                                                         const unsigned long long output_offset)
+{
+    if (input == nullptr || input_size == 0ULL || output == nullptr || output_size == 0ULL || output_width < input_width || (output_size - output_offset) < input_size)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    delinearize(input, input_size, input_width, 4U, output, output_width, output_offset);
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_with_offset(const char* input, const unsigned long long input_size, const unsigned int input_width,
+                                                                 kra_imp_delinerize_output_t* output)
+{
+    if (input == nullptr || input_size == 0ULL || output == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    char* output_buffer = output->_buffer;
+    if (output_buffer == nullptr || output->_buffer_size == 0ULL || output->_width < input_width || (output->_buffer_size - output->_offset) < input_size)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    delinearize(input, input_size, input_width, 4U, output_buffer, output->_width, output->_offset);
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_layer_data(const char* input, const unsigned long long input_size, const unsigned int input_width,
+                                                                const kra_imp_layer_data_header_t* layer_data_header, kra_imp_delinerize_output_t* output)
+{
+    if (input == nullptr || input_size == 0ULL || input_width == 0U || layer_data_header == nullptr || output == nullptr || output->_buffer == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const unsigned int pixel_size = layer_data_header->_layer_data_pixel_size;
+    if (pixel_size == 0U || pixel_size > KRA_IMP_MAX_PIXEL_SIZE || output->_width < input_width)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const unsigned long long row_size = static_cast<unsigned long long>(input_width) * pixel_size;
+    const unsigned long long input_rows = input_size / row_size;
+    if (input_rows == 0ULL || output->_offset > output->_buffer_size ||
+        (output->_buffer_size - output->_offset) / pixel_size < (input_rows - 1ULL) * output->_width + input_width)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    delinearize(input, input_size, input_width, pixel_size, output->_buffer, output->_width, output->_offset);
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_to_format(const char* input, const unsigned long long input_size, const unsigned int input_width,
+                                                               const kra_imp_pixel_format_t* pixel_format, kra_imp_delinerize_output_t* output)
+{
+    if (input == nullptr || input_size == 0ULL || input_width == 0U || pixel_format == nullptr || output == nullptr || output->_buffer == nullptr ||
+        output->_width < input_width)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const delinearize_format_row_function delinearize_format_row = find_delinearize_format_row_function(*pixel_format);
+    if (delinearize_format_row == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    static constexpr unsigned char pixel_size = 4;
+    const unsigned long long output_pixel_size = get_color_format_pixel_size(KRA_IMP_RGBA_COLOR_SPACE_MODEL, pixel_format->_channel_depth);
+    const unsigned long long input_rows = input_size / (static_cast<unsigned long long>(input_width) * pixel_size);
+    if (input_rows == 0ULL || output->_offset > output->_buffer_size ||
+        (output->_buffer_size - output->_offset) / output_pixel_size < (input_rows - 1ULL) * output->_width + input_width)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const unsigned long long pixels_to_delinearize = input_size / pixel_size;
+    unsigned long long output_idx = output->_offset;
+    for (unsigned long long y = 0ULL; y < input_rows; ++y)
+    {
+        const unsigned long long input_idx = y * input_width;
+        const char* const channels[pixel_size]{ input + input_idx, input + pixels_to_delinearize + input_idx, input + 2 * pixels_to_delinearize + input_idx,
+                                                input + 3 * pixels_to_delinearize + input_idx };
+        delinearize_format_row(channels, output->_buffer + output_idx, input_width);
+        output_idx += output->_width * output_pixel_size;
+    }
+    return KRA_IMP_SUCCESS;
+}
+
+bool is_color_conversion_order_supported(const kra_imp_color_conversion_t& color_conversion)
+{
+    return color_conversion._pixel_order == KRA_IMP_BGRA_PIXEL_ORDER || color_conversion._pixel_order == KRA_IMP_RGBA_PIXEL_ORDER;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_convert_pixels(const char* input, const unsigned long long pixels_count, const kra_imp_color_conversion_t* color_conversion,
+                                                        char* output)
+{
+    if (input == nullptr || pixels_count == 0ULL || color_conversion == nullptr || output == nullptr || !is_color_conversion_order_supported(*color_conversion))
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    const convert_pixels_function convert_pixels = find_convert_pixels_function(color_conversion->_color_space_model, color_conversion->_channel_depth);
+    if (convert_pixels == nullptr)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    convert_pixels(input, output, pixels_count, color_conversion->_pixel_order);
+    return KRA_IMP_SUCCESS;
+}
+
+bool is_canvas_valid(const kra_imp_canvas_t& canvas)
+{
+    static constexpr unsigned char pixel_size = 4;
+    return canvas._buffer != nullptr && canvas._width != 0U && canvas._height != 0U &&
+           canvas._buffer_size / pixel_size / canvas._width >= canvas._height;
+}
+
+void delinearize_tile_to_canvas(const char* tile_data, const unsigned int tile_width, const unsigned int tile_height, const int x_offset, const int y_offset,
+                                kra_imp_canvas_t& canvas)
+{
+    static constexpr unsigned char pixel_size = 4;
+    const long long first_x = std::max<long long>(x_offset, 0LL);
+    const long long last_x = std::min<long long>(static_cast<long long>(x_offset) + tile_width, canvas._width);
+    const long long first_y = std::max<long long>(y_offset, 0LL);
+    const long long last_y = std::min<long long>(static_cast<long long>(y_offset) + tile_height, canvas._height);
+    if (first_x >= last_x || first_y >= last_y)
+    {
+        return;
+    }
+
+    const unsigned long long plane_size = static_cast<unsigned long long>(tile_width) * tile_height;
+    for (long long y = first_y; y < last_y; ++y)
+    {
+        const unsigned long long input_idx = static_cast<unsigned long long>(y - y_offset) * tile_width + static_cast<unsigned long long>(first_x - x_offset);
+        const char* const channels[pixel_size]{ tile_data + input_idx, tile_data + plane_size + input_idx, tile_data + 2 * plane_size + input_idx,
+                                                tile_data + 3 * plane_size + input_idx };
+        const unsigned long long output_idx = (static_cast<unsigned long long>(y) * canvas._width + static_cast<unsigned long long>(first_x)) * pixel_size;
+        delinearize_row(channels, canvas._buffer + output_idx, static_cast<unsigned long long>(last_x - first_x));
+    }
+}
+
+static constexpr unsigned int KRA_IMP_MAX_CANVAS_TILE_SIZE{ 64U * 64U * 4U };
+
+// Compressed tiles are decoded into a stack buffer that stays in cache until it is interleaved into a canvas.
+using canvas_tile_buffer_t = std::array<char, KRA_IMP_MAX_CANVAS_TILE_SIZE + KRA_IMP_LZF_OUTPUT_SLACK>;
+
+kra_imp_error_code_e decode_canvas_tile(const kra_imp_layer_data_tile_t& tile, const kra_imp_layer_data_header_t& layer_data_header, canvas_tile_buffer_t& tile_buffer,
+                                        const char*& tile_data)
+{
+    static constexpr unsigned char pixel_size = 4;
+    const unsigned long long tile_size = static_cast<unsigned long long>(layer_data_header._layer_data_width) * layer_data_header._layer_data_height * pixel_size;
+    if (layer_data_header._layer_data_pixel_size != pixel_size || tile_size == 0ULL || tile_size > KRA_IMP_MAX_CANVAS_TILE_SIZE)
     {
-        ++end_position;
+        return KRA_IMP_PARAMS_ERROR;
     }
-    const std::string_view current_hader_value(buffer + buffer_offset, end_position - buffer_offset);
-    buffer_offset = end_position + 1U;
-    return current_hader_value;
+
+    tile_data = tile._data;
+    if (tile._compression != KRA_IMP_UNCOMPRESSED_TILE)
+    {
+        const kra_imp_error_code_e result = decompress_layer_data_tile(tile, tile_buffer.data(), tile_size, tile_buffer.size());
+        if (result != KRA_IMP_SUCCESS)
+        {
+            return result;
+        }
+        tile_data = tile_buffer.data();
+    }
+    else if (tile._data_size < tile_size)
+    {
+        return KRA_IMP_DECOMPRESS_ERROR;
+    }
+    return KRA_IMP_SUCCESS;
 }
 
-bool get_header_element(const char* buffer, const unsigned long long buffer_size, const std::string_view header, unsigned int& buffer_offset, unsigned int& value)
+kra_imp_error_code_e read_layer_data_tile_to_canvas(const kra_imp_layer_data_tile_t& tile, const kra_imp_layer_data_header_t& layer_data_header, kra_imp_canvas_t& canvas)
 {
-    const std::string_view current_hader_value = parse_header_element(buffer, buffer_size, header, buffer_offset);
-    if (current_hader_value.empty())
+    canvas_tile_buffer_t tile_buffer;
+    const char* tile_data = nullptr;
+    const kra_imp_error_code_e result = decode_canvas_tile(tile, layer_data_header, tile_buffer, tile_data);
+    if (result != KRA_IMP_SUCCESS)
     {
-        return false;
+        return result;
     }
 
-    std::size_t position = 0;
-    value = std::stoul(current_hader_value.data(), &position);
-    return position == current_hader_value.size();
+    delinearize_tile_to_canvas(tile_data, layer_data_header._layer_data_width, layer_data_header._layer_data_height, tile._x_offset, tile._y_offset, canvas);
+    return KRA_IMP_SUCCESS;
 }
 
-KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_header(const char* buffer, const unsigned long long buffer_size, kra_imp_layer_data_header_t* layer_data_header)
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_to_canvas(const kra_imp_layer_data_tile_t* tile, const kra_imp_layer_data_header_t* layer_data_header,
+                                                                           kra_imp_canvas_t* canvas)
 {
-    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr)
+    if (tile == nullptr || tile->_data == nullptr || layer_data_header == nullptr || canvas == nullptr || !is_canvas_valid(*canvas))
     {
         return KRA_IMP_PARAMS_ERROR;
     }
 
-    static constexpr const std::array<std::string_view, 5> KRA_IMP_HEADERS{ "VERSION ", "TILEWIDTH ", "TILEHEIGHT ", "PIXELSIZE ", "DATA " };
+    return read_layer_data_tile_to_canvas(*tile, *layer_data_header, *canvas);
+}
 
-    layer_data_header->_header_size = 0U;
-    if (!get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[0], layer_data_header->_header_size, layer_data_header->_version) ||
-        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[1], layer_data_header->_header_size, layer_data_header->_layer_data_width) ||
-        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[2], layer_data_header->_header_size, layer_data_header->_layer_data_height) ||
-        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[3], layer_data_header->_header_size, layer_data_header->_layer_data_pixel_size) ||
-        !get_header_element(buffer, buffer_size, KRA_IMP_HEADERS[4], layer_data_header->_header_size, layer_data_header->_layer_datas_count) ||
-        layer_data_header->_header_size > buffer_size)
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_to_canvas(const char* buffer, const unsigned long long buffer_size,
+                                                                   const kra_imp_layer_data_header_t* layer_data_header, kra_imp_canvas_t* canvas)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || canvas == nullptr || !is_canvas_valid(*canvas))
     {
-        return KRA_IMP_PARSE_ERROR;
+        return KRA_IMP_PARAMS_ERROR;
     }
 
-    return KRA_IMP_SUCCESS;
+    const auto read_tile = [&](const kra_imp_layer_data_tile_t& tile, unsigned int)
+    {
+        return read_layer_data_tile_to_canvas(tile, *layer_data_header, *canvas);
+    };
+    return for_each_layer_data_tile(buffer, buffer_size, layer_data_header->_layer_datas_count, read_tile);
 }
 
-KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_tile(const char* input, const unsigned long long input_size, unsigned int layer_data_tile_index, char* output,
-                                                              const unsigned long long output_size, int* x_offset, int* y_offset)
+struct tile_converter_t
 {
-    if (input == nullptr || input_size == 0ULL || output == nullptr || output_size == 0ULL || x_offset == nullptr || y_offset == nullptr)
+    delinearize_row_function _delinearize_row;
+    convert_pixels_function _convert_pixels;
+    unsigned int _pixel_size;
+    kra_imp_pixel_order_e _pixel_order;
+};
+
+bool find_tile_converter(const kra_imp_layer_data_header_t& layer_data_header, const kra_imp_color_conversion_t& color_conversion, tile_converter_t& tile_converter)
+{
+    const unsigned int pixel_size = get_color_format_pixel_size(color_conversion._color_space_model, color_conversion._channel_depth);
+    if (pixel_size == 0U || !is_color_conversion_order_supported(color_conversion) || layer_data_header._layer_data_pixel_size != pixel_size ||
+        layer_data_header._layer_data_width == 0U || layer_data_header._layer_data_width > 64U || layer_data_header._layer_data_height == 0U ||
+        layer_data_header._layer_data_height > 64U)
     {
-        return KRA_IMP_PARAMS_ERROR;
+        return false;
     }
 
-    unsigned long long start_position = 0UL;
-    unsigned long long end_position = 1UL;
+    tile_converter._delinearize_row = find_delinearize_row_function(pixel_size);
+    tile_converter._convert_pixels = find_convert_pixels_function(color_conversion._color_space_model, color_conversion._channel_depth);
+    tile_converter._pixel_size = pixel_size;
+    tile_converter._pixel_order = color_conversion._pixel_order;
+    return tile_converter._delinearize_row != nullptr && tile_converter._convert_pixels != nullptr;
+}
 
-    auto separator_splitter = [input, input_size](unsigned long long& end_position)
-    {
-        while (input_size > end_position)
-        {
-            if (input[end_position] == KRA_IMP_SEPARATOR || input[end_position] == KRA_IMP_END)
-            {
-                return true;
-            }
-            ++end_position;
-        }
+unsigned long long get_converted_tile_buffer_size(const kra_imp_layer_data_header_t& layer_data_header, const tile_converter_t& tile_converter)
+{
+    return static_cast<unsigned long long>(layer_data_header._layer_data_width) * layer_data_header._layer_data_height * tile_converter._pixel_size +
+           KRA_IMP_LZF_OUTPUT_SLACK;
+}
 
+// Holds a decompressed tile followed by a single interleaved row. It is allocated once per call, from the scratch
+// buffer when one is set, instead of taking tens of kilobytes of stack for every tile.
+bool allocate_tile_conversion_buffer(const kra_imp_layer_data_header_t& layer_data_header, const tile_converter_t& tile_converter,
+                                     memory_vector_t<char>& conversion_buffer)
+{
+    try
+    {
+        conversion_buffer.resize(get_converted_tile_buffer_size(layer_data_header, tile_converter) +
+                                 static_cast<unsigned long long>(layer_data_header._layer_data_width) * tile_converter._pixel_size);
+        return true;
+    }
+    catch (const std::bad_alloc&)
+    {
         return false;
-    };
-    unsigned int current_index = 0U;
-    while (end_position < input_size)
+    }
+}
+
+kra_imp_error_code_e read_layer_data_tile_to_canvas_converted(const kra_imp_layer_data_tile_t& tile, const kra_imp_layer_data_header_t& layer_data_header,
+                                                              const tile_converter_t& tile_converter, memory_vector_t<char>& conversion_buffer,
+                                                              kra_imp_canvas_t& canvas)
+{
+    const unsigned int tile_width = layer_data_header._layer_data_width;
+    const unsigned int tile_height = layer_data_header._layer_data_height;
+    const long long first_x = std::max<long long>(tile._x_offset, 0LL);
+    const long long last_x = std::min<long long>(static_cast<long long>(tile._x_offset) + tile_width, canvas._width);
+    const long long first_y = std::max<long long>(tile._y_offset, 0LL);
+    const long long last_y = std::min<long long>(static_cast<long long>(tile._y_offset) + tile_height, canvas._height);
+    if (first_x >= last_x || first_y >= last_y)
     {
-        if (!separator_splitter(end_position))
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+        return KRA_IMP_SUCCESS;
+    }
 
-        if (std::from_chars(&input[start_position], &input[end_position], *x_offset).ec != std::errc())
+    // The tile and a single interleaved row stay in cache between decompression, interleaving and conversion.
+    const unsigned long long tile_buffer_size = get_converted_tile_buffer_size(layer_data_header, tile_converter);
+    char* tile_buffer = conversion_buffer.data();
+    char* row_buffer = conversion_buffer.data() + tile_buffer_size;
+    const unsigned long long plane_size = static_cast<unsigned long long>(tile_width) * tile_height;
+    const unsigned long long tile_size = plane_size * tile_converter._pixel_size;
+    const char* tile_data = tile._data;
+    if (tile._compression != KRA_IMP_UNCOMPRESSED_TILE)
+    {
+        const kra_imp_error_code_e result = decompress_layer_data_tile(tile, tile_buffer, tile_size, tile_buffer_size);
+        if (result != KRA_IMP_SUCCESS)
         {
-            return KRA_IMP_PARSE_ERROR;
+            return result;
         }
+        tile_data = tile_buffer;
+    }
+    else if (tile._data_size < tile_size)
+    {
+        return KRA_IMP_DECOMPRESS_ERROR;
+    }
 
-        start_position = end_position + 1UL;
-        end_position = start_position + 1UL;
-        if (!separator_splitter(end_position))
+    static constexpr unsigned char output_pixel_size = 4;
+    std::array<const char*, KRA_IMP_MAX_COLOR_PIXEL_SIZE> planes{};
+    const unsigned long long row_pixels_count = static_cast<unsigned long long>(last_x - first_x);
+    for (long long y = first_y; y < last_y; ++y)
+    {
+        const unsigned long long input_idx = static_cast<unsigned long long>(y - tile._y_offset) * tile_width + static_cast<unsigned long long>(first_x - tile._x_offset);
+        for (unsigned int plane_index = 0U; plane_index < tile_converter._pixel_size; ++plane_index)
         {
-            return KRA_IMP_PARSE_ERROR;
+            planes[plane_index] = tile_data + plane_index * plane_size + input_idx;
         }
+        const unsigned long long output_idx = (static_cast<unsigned long long>(y) * canvas._width + static_cast<unsigned long long>(first_x)) * output_pixel_size;
+        tile_converter._delinearize_row(planes.data(), tile_converter._pixel_size, row_buffer, row_pixels_count);
+        tile_converter._convert_pixels(row_buffer, canvas._buffer + output_idx, row_pixels_count, tile_converter._pixel_order);
+    }
+    return KRA_IMP_SUCCESS;
+}
 
-        if (std::from_chars(&input[start_position], &input[end_position], *y_offset).ec != std::errc())
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_to_canvas_converted(const kra_imp_layer_data_tile_t* tile,
+                                                                                     const kra_imp_layer_data_header_t* layer_data_header,
+                                                                                     const kra_imp_color_conversion_t* color_conversion, kra_imp_canvas_t* canvas)
+{
+    tile_converter_t tile_converter{};
+    if (tile == nullptr || tile->_data == nullptr || layer_data_header == nullptr || color_conversion == nullptr || canvas == nullptr || !is_canvas_valid(*canvas) ||
+        !find_tile_converter(*layer_data_header, *color_conversion, tile_converter))
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
 
-        start_position = end_position + 1UL;
-        end_position = start_position + 1UL;
-        if (!separator_splitter(end_position))
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+    const scratch_scope_t scratch_scope;
+    memory_vector_t<char> conversion_buffer;
+    if (!allocate_tile_conversion_buffer(*layer_data_header, tile_converter, conversion_buffer))
+    {
+        return KRA_IMP_FAIL;
+    }
 
-        const std::string_view tile_compression_type(&input[start_position], end_position - start_position);
-        if (tile_compression_type.compare(KRA_IMP_COMPRESSION_TYPE) != 0)
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+    return read_layer_data_tile_to_canvas_converted(*tile, *layer_data_header, tile_converter, conversion_buffer, *canvas);
+}
 
-        start_position = end_position + 1UL;
-        end_position = start_position + 1UL;
-        if (!separator_splitter(end_position))
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_to_canvas_converted(const char* buffer, const unsigned long long buffer_size,
+                                                                             const kra_imp_layer_data_header_t* layer_data_header,
+                                                                             const kra_imp_color_conversion_t* color_conversion, kra_imp_canvas_t* canvas)
+{
+    tile_converter_t tile_converter{};
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || color_conversion == nullptr || canvas == nullptr || !is_canvas_valid(*canvas) ||
+        !find_tile_converter(*layer_data_header, *color_conversion, tile_converter))
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
 
-        unsigned int compressed_size = 0U;
-        if (std::from_chars(&input[start_position], &input[end_position], compressed_size).ec != std::errc())
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+    const scratch_scope_t scratch_scope;
+    memory_vector_t<char> conversion_buffer;
+    if (!allocate_tile_conversion_buffer(*layer_data_header, tile_converter, conversion_buffer))
+    {
+        return KRA_IMP_FAIL;
+    }
 
-        start_position = end_position + 1UL;
-        if (current_index == layer_data_tile_index)
-        {
-            if (KRA_IMP_UNCOMPRESSED_FLAG == input[start_position])
-            {
-                std::memcpy(output, &input[start_position + 1UL], output_size);
-            }
-            else if (KRA_IMP_COMPRESSED_FLAG == input[start_position])
-            {
-                if (lzf_decompress(&input[start_position + 1UL], compressed_size - 1U, output, output_size) != output_size)
-                {
-                    return KRA_IMP_DECOMPRESS_ERROR;
-                }
-            }
-            else
-            {
-                return KRA_IMP_DECOMPRESS_ERROR;
-            }
+    const auto read_converted_tile = [&](const kra_imp_layer_data_tile_t& tile, unsigned int)
+    {
+        return read_layer_data_tile_to_canvas_converted(tile, *layer_data_header, tile_converter, conversion_buffer, *canvas);
+    };
+    return for_each_layer_data_tile(buffer, buffer_size, layer_data_header->_layer_datas_count, read_converted_tile);
+}
 
-            return KRA_IMP_SUCCESS;
-        }
-        start_position += compressed_size;
-        end_position = start_position + 1UL;
-        ++current_index;
+kra_imp_error_code_e read_layer_data_tile_to_region(const kra_imp_layer_data_tile_t& tile, const kra_imp_layer_data_header_t& layer_data_header, const int x_offset,
+                                                    const int y_offset, kra_imp_canvas_t& region)
+{
+    // Tiles outside of the region are skipped before decompression; that is the whole point of reading a region.
+    const long long tile_x = static_cast<long long>(tile._x_offset) - x_offset;
+    const long long tile_y = static_cast<long long>(tile._y_offset) - y_offset;
+    if (tile_x >= region._width || tile_y >= region._height || tile_x + layer_data_header._layer_data_width <= 0LL ||
+        tile_y + layer_data_header._layer_data_height <= 0LL)
+    {
+        return KRA_IMP_SUCCESS;
     }
-    return KRA_IMP_FAIL;
+
+    kra_imp_layer_data_tile_t region_tile = tile;
+    region_tile._x_offset = static_cast<int>(tile_x);
+    region_tile._y_offset = static_cast<int>(tile_y);
+    return read_layer_data_tile_to_canvas(region_tile, layer_data_header, region);
 }
 
-KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data(const char* buffer, const unsigned long long buffer_size, const unsigned int data_index,
-                                                         kra_imp_layer_output_data_t* output)
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_region(const kra_imp_layer_data_tile_t* tiles, const unsigned int tiles_count,
+                                                                        const kra_imp_layer_data_header_t* layer_data_header, const int x_offset, const int y_offset,
+                                                                        kra_imp_canvas_t* region)
 {
-    if (buffer == nullptr || buffer_size == 0ULL || output == nullptr || output->_buffer == nullptr || output->_buffer_size == 0ULL)
+    if (tiles == nullptr || tiles_count == 0U || layer_data_header == nullptr || region == nullptr || !is_canvas_valid(*region))
     {
         return KRA_IMP_PARAMS_ERROR;
     }
 
-    unsigned long long start_position = 0UL;
-    unsigned long long end_position = 1UL;
-
-    auto separator_splitter = [buffer, buffer_size](unsigned long long& end_position)
+    for (unsigned int tile_index = 0U; tile_index < tiles_count; ++tile_index)
     {
-        while (buffer_size > end_position)
+        if (tiles[tile_index]._data == nullptr)
         {
-            if (buffer[end_position] == KRA_IMP_SEPARATOR || buffer[end_position] == KRA_IMP_END)
-            {
-                return true;
-            }
-            ++end_position;
+            return KRA_IMP_PARAMS_ERROR;
         }
 
-        return false;
-    };
-    unsigned int current_index = 0U;
-    while (end_position < buffer_size)
-    {
-        if (!separator_splitter(end_position))
+        const kra_imp_error_code_e result = read_layer_data_tile_to_region(tiles[tile_index], *layer_data_header, x_offset, y_offset, *region);
+        if (result != KRA_IMP_SUCCESS)
         {
-            return KRA_IMP_PARSE_ERROR;
+            return result;
         }
+    }
 
-        if (std::from_chars(&buffer[start_position], &buffer[end_position], output->_x_offset).ec != std::errc())
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+    return KRA_IMP_SUCCESS;
+}
 
-        start_position = end_position + 1UL;
-        end_position = start_position + 1UL;
-        if (!separator_splitter(end_position))
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_region(const char* buffer, const unsigned long long buffer_size, const kra_imp_layer_data_header_t* layer_data_header,
+                                                                const int x_offset, const int y_offset, kra_imp_canvas_t* region)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || region == nullptr || !is_canvas_valid(*region))
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
 
-        if (std::from_chars(&buffer[start_position], &buffer[end_position], output->_y_offset).ec != std::errc())
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+    const auto read_region_tile = [&](const kra_imp_layer_data_tile_t& tile, unsigned int)
+    {
+        return read_layer_data_tile_to_region(tile, *layer_data_header, x_offset, y_offset, *region);
+    };
+    return for_each_layer_data_tile(buffer, buffer_size, layer_data_header->_layer_datas_count, read_region_tile);
+}
 
-        start_position = end_position + 1UL;
-        end_position = start_position + 1UL;
-        if (!separator_splitter(end_position))
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+// Tile slots are pooled in pages, so populating a canvas does not allocate for every painted tile.
+static constexpr unsigned int KRA_IMP_SPARSE_CANVAS_PAGE_TILES_COUNT{ 64U };
 
-        const std::string_view tile_compression_type(&buffer[start_position], end_position - start_position);
-        if (tile_compression_type.compare(KRA_IMP_COMPRESSION_TYPE) != 0)
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+struct kra_imp_sparse_canvas_t
+{
+    unsigned int _tile_width{ 0U };
+    unsigned int _tile_height{ 0U };
+    memory_vector_t<memory_vector_t<char>> _pages;
+    memory_vector_t<kra_imp_tile_offset_t> _tile_offsets;
+    memory_unordered_map_t<unsigned long long, unsigned int> _tile_indices;
+};
 
-        start_position = end_position + 1UL;
-        end_position = start_position + 1UL;
-        if (!separator_splitter(end_position))
-        {
-            return KRA_IMP_PARSE_ERROR;
-        }
+unsigned long long get_sparse_canvas_tile_size(const kra_imp_sparse_canvas_t& sparse_canvas)
+{
+    static constexpr unsigned char pixel_size = 4;
+    return static_cast<unsigned long long>(sparse_canvas._tile_width) * sparse_canvas._tile_height * pixel_size;
+}
+
+char* get_sparse_canvas_tile_data(kra_imp_sparse_canvas_t& sparse_canvas, const unsigned int tile_index)
+{
+    return sparse_canvas._pages[tile_index / KRA_IMP_SPARSE_CANVAS_PAGE_TILES_COUNT].data() +
+           tile_index % KRA_IMP_SPARSE_CANVAS_PAGE_TILES_COUNT * get_sparse_canvas_tile_size(sparse_canvas);
+}
+
+const char* get_sparse_canvas_tile_data(const kra_imp_sparse_canvas_t& sparse_canvas, const unsigned int tile_index)
+{
+    return get_sparse_canvas_tile_data(const_cast<kra_imp_sparse_canvas_t&>(sparse_canvas), tile_index);
+}
+
+// Returns nullptr if the tile could not be allocated, leaving the canvas unchanged.
+char* find_or_add_sparse_canvas_tile(kra_imp_sparse_canvas_t& sparse_canvas, const long long slot_x, const long long slot_y)
+{
+    const unsigned long long slot_key = static_cast<unsigned long long>(static_cast<unsigned int>(slot_x)) << 32U | static_cast<unsigned int>(slot_y);
+    const auto slot = sparse_canvas._tile_indices.find(slot_key);
+    if (slot != sparse_canvas._tile_indices.end())
+    {
+        return get_sparse_canvas_tile_data(sparse_canvas, slot->second);
+    }
 
-        unsigned int compressed_size = 0U;
-        if (std::from_chars(&buffer[start_position], &buffer[end_position], compressed_size).ec != std::errc())
+    const unsigned int tile_index = static_cast<unsigned int>(sparse_canvas._tile_offsets.size());
+    const std::size_t pages_count = sparse_canvas._pages.size();
+    try
+    {
+        if (tile_index % KRA_IMP_SPARSE_CANVAS_PAGE_TILES_COUNT == 0U)
         {
-            return KRA_IMP_PARSE_ERROR;
+            sparse_canvas._pages.emplace_back(KRA_IMP_SPARSE_CANVAS_PAGE_TILES_COUNT * get_sparse_canvas_tile_size(sparse_canvas));
         }
+        sparse_canvas._tile_offsets.push_back(
+            { static_cast<int>(slot_x * sparse_canvas._tile_width), static_cast<int>(slot_y * sparse_canvas._tile_height) });
+        sparse_canvas._tile_indices.emplace(slot_key, tile_index);
+    }
+    catch (const std::bad_alloc&)
+    {
+        sparse_canvas._tile_offsets.resize(tile_index);
+        sparse_canvas._pages.resize(pages_count);
+        return nullptr;
+    }
+    return get_sparse_canvas_tile_data(sparse_canvas, tile_index);
+}
 
-        start_position = end_position + 1UL;
-        if (current_index == data_index)
+kra_imp_error_code_e read_layer_data_tile_to_sparse_canvas(const kra_imp_layer_data_tile_t& tile, const kra_imp_layer_data_header_t& layer_data_header,
+                                                           kra_imp_sparse_canvas_t& sparse_canvas)
+{
+    if (layer_data_header._layer_data_width != sparse_canvas._tile_width || layer_data_header._layer_data_height != sparse_canvas._tile_height)
+    {
+        return KRA_IMP_PARAMS_ERROR;
+    }
+
+    canvas_tile_buffer_t tile_buffer;
+    const char* tile_data = nullptr;
+    const kra_imp_error_code_e result = decode_canvas_tile(tile, layer_data_header, tile_buffer, tile_data);
+    if (result != KRA_IMP_SUCCESS)
+    {
+        return result;
+    }
+
+    // Tiles written by Krita are aligned to the slot grid, but unaligned tiles are split across up to four slots.
+    const unsigned int tile_width = sparse_canvas._tile_width;
+    const unsigned int tile_height = sparse_canvas._tile_height;
+    const long long first_slot_x = floor_divide(tile._x_offset, tile_width);
+    const long long last_slot_x = floor_divide(static_cast<long long>(tile._x_offset) + tile_width - 1LL, tile_width);
+    const long long first_slot_y = floor_divide(tile._y_offset, tile_height);
+    const long long last_slot_y = floor_divide(static_cast<long long>(tile._y_offset) + tile_height - 1LL, tile_height);
+    for (long long slot_y = first_slot_y; slot_y <= last_slot_y; ++slot_y)
+    {
+        for (long long slot_x = first_slot_x; slot_x <= last_slot_x; ++slot_x)
         {
-            if (KRA_IMP_UNCOMPRESSED_FLAG == buffer[start_position])
-            {
-                std::memcpy(output->_buffer, &buffer[start_position + 1UL], output->_buffer_size);
-            }
-            else if (KRA_IMP_COMPRESSED_FLAG == buffer[start_position])
+            // Slots starting past the range of tile offsets cannot be described to the caller, so they are clipped.
+            if (slot_x * tile_width > std::numeric_limits<int>::max() || slot_y * tile_height > std::numeric_limits<int>::max())
             {
-                if (lzf_decompress(&buffer[start_position + 1UL], compressed_size - 1U, output->_buffer, output->_buffer_size) != output->_buffer_size)
-                {
-                    return KRA_IMP_DECOMPRESS_ERROR;
-                }
+                continue;
             }
-            else
+
+            char* slot_data = find_or_add_sparse_canvas_tile(sparse_canvas, slot_x, slot_y);
+            if (slot_data == nullptr)
             {
-                return KRA_IMP_DECOMPRESS_ERROR;
+                return KRA_IMP_FAIL;
             }
 
-            return KRA_IMP_SUCCESS;
+            kra_imp_canvas_t slot_canvas{ slot_data, get_sparse_canvas_tile_size(sparse_canvas), tile_width, tile_height };
+            delinearize_tile_to_canvas(tile_data, tile_width, tile_height, static_cast<int>(tile._x_offset - slot_x * tile_width),
+                                       static_cast<int>(tile._y_offset - slot_y * tile_height), slot_canvas);
         }
-        start_position += compressed_size;
-        end_position = start_position + 1UL;
-        ++current_index;
     }
-    return KRA_IMP_FAIL;
+    return KRA_IMP_SUCCESS;
 }
 
-KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_to_bgra(const char* input, char* output, const unsigned long long buffer_size, const unsigned int width)
+KRA_IMP_API kra_imp_sparse_canvas_t* kra_imp_open_sparse_canvas(const kra_imp_layer_data_header_t* layer_data_header)
 {
-    return kra_imp_delinearize_to_bgra_with_offset(input, buffer_size, width, output, buffer_size, width, 0ULL);
+    static constexpr unsigned char pixel_size = 4;
+    if (layer_data_header == nullptr || layer_data_header->_layer_data_pixel_size != pixel_size || layer_data_header->_layer_data_width == 0U ||
+        layer_data_header->_layer_data_height == 0U ||
+        static_cast<unsigned long long>(layer_data_header->_layer_data_width) * layer_data_header->_layer_data_height * pixel_size > KRA_IMP_MAX_CANVAS_TILE_SIZE)
+    {
+        return nullptr;
+    }
+
+    kra_imp_sparse_canvas_t* sparse_canvas = new_object<kra_imp_sparse_canvas_t>();
+    if (sparse_canvas == nullptr)
+    {
+        return nullptr;
+    }
+
+    sparse_canvas->_tile_width = layer_data_header->_layer_data_width;
+    sparse_canvas->_tile_height = layer_data_header->_layer_data_height;
+    return sparse_canvas;
 }
 
-KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_to_bgra_with_offset(const char* input, const unsigned long long input_size, const unsigned int input_width, char* output,
-                                                                         const unsigned long long output_size, const unsigned int output_width,
-                                                                         const unsigned long long output_offset)
+KRA_IMP_API void kra_imp_close_sparse_canvas(kra_imp_sparse_canvas_t* sparse_canvas)
 {
-    if (input == nullptr || input_size == 0ULL || output == nullptr || output_size == 0ULL || output_width < input_width || (output_size - output_offset) < input_size)
+    delete_object(sparse_canvas);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_indexed_layer_data_to_sparse_canvas(const kra_imp_layer_data_tile_t* tile,
+                                                                                  const kra_imp_layer_data_header_t* layer_data_header,
+                                                                                  kra_imp_sparse_canvas_t* sparse_canvas)
+{
+    if (tile == nullptr || tile->_data == nullptr || layer_data_header == nullptr || sparse_canvas == nullptr)
     {
         return KRA_IMP_PARAMS_ERROR;
     }
 
-    static constexpr unsigned char pixel_size = 4;
-    const unsigned long long input_rows = input_size / (pixel_size * input_width);
-    const unsigned long long pixels_to_delineearize = input_size / pixel_size;
-    unsigned long long output_idx = output_offset;
-    for (unsigned long long y = 0UL; y < input_rows; ++y)
+    return read_layer_data_tile_to_sparse_canvas(*tile, *layer_data_header, *sparse_canvas);
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_read_layer_data_to_sparse_canvas(const char* buffer, const unsigned long long buffer_size,
+                                                                          const kra_imp_layer_data_header_t* layer_data_header, kra_imp_sparse_canvas_t* sparse_canvas)
+{
+    if (buffer == nullptr || buffer_size == 0ULL || layer_data_header == nullptr || sparse_canvas == nullptr)
     {
-        for (unsigned long long x = 0UL; x < input_width; ++x)
-        {
-            unsigned long long input_idx = y * input_width + x;
-            for (unsigned char channel_index = 0; channel_index < pixel_size; ++channel_index)
-            {
-                unsigned long long output_channel_idx = output_idx + (x * pixel_size) + channel_index;
-                unsigned long long input_channel_idx = channel_index * pixels_to_delineearize + input_idx;
-                output[output_channel_idx] = input[input_channel_idx];
-            }
-        }
-        output_idx += output_width * pixel_size;
+        return KRA_IMP_PARAMS_ERROR;
     }
 
-    return KRA_IMP_SUCCESS;
+    const auto read_sparse_canvas_tile = [&](const kra_imp_layer_data_tile_t& tile, unsigned int)
+    {
+        return read_layer_data_tile_to_sparse_canvas(tile, *layer_data_header, *sparse_canvas);
+    };
+    return for_each_layer_data_tile(buffer, buffer_size, layer_data_header->_layer_datas_count, read_sparse_canvas_tile);
 }
 
-KRA_IMP_API kra_imp_error_code_e kra_imp_delinearize_with_offset(const char* input, const unsigned long long input_size, const unsigned int input_width,
-                                                                 kra_imp_delinerize_output_t* output)
+KRA_IMP_API unsigned int kra_imp_get_sparse_canvas_tiles_count(const kra_imp_sparse_canvas_t* sparse_canvas)
 {
-    if (input == nullptr || input_size == 0ULL || output == nullptr)
+    return sparse_canvas == nullptr ? 0U : static_cast<unsigned int>(sparse_canvas->_tile_offsets.size());
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_get_sparse_canvas_tile(const kra_imp_sparse_canvas_t* sparse_canvas, const unsigned int tile_index,
+                                                                kra_imp_sparse_canvas_tile_t* tile)
+{
+    if (sparse_canvas == nullptr || tile == nullptr || tile_index >= sparse_canvas->_tile_offsets.size())
     {
         return KRA_IMP_PARAMS_ERROR;
     }
 
-    char* output_buffer = output->_buffer;
-    if (output_buffer == nullptr || output->_buffer_size == 0ULL || output->_width < input_width || (output->_buffer_size - output->_offset) < input_size)
+    tile->_data = get_sparse_canvas_tile_data(*sparse_canvas, tile_index);
+    tile->_data_size = static_cast<unsigned int>(get_sparse_canvas_tile_size(*sparse_canvas));
+    tile->_x_offset = sparse_canvas->_tile_offsets[tile_index]._x_offset;
+    tile->_y_offset = sparse_canvas->_tile_offsets[tile_index]._y_offset;
+    return KRA_IMP_SUCCESS;
+}
+
+KRA_IMP_API kra_imp_error_code_e kra_imp_export_sparse_canvas(const kra_imp_sparse_canvas_t* sparse_canvas, const int x_offset, const int y_offset,
+                                                              kra_imp_canvas_t* region)
+{
+    static constexpr unsigned char pixel_size = 4;
+    if (sparse_canvas == nullptr || region == nullptr || !is_canvas_valid(*region))
     {
         return KRA_IMP_PARAMS_ERROR;
     }
 
-    static constexpr unsigned char pixel_size = 4;
-    const unsigned long long input_rows = input_size / (pixel_size * input_width);
-    const unsigned long long pixels_to_delineearize = input_size / pixel_size;
-    unsigned long long output_idx = output->_offset;
-    for (unsigned long long y = 0UL; y < input_rows; ++y)
+    const unsigned long long region_row_size = static_cast<unsigned long long>(region->_width) * pixel_size;
+    std::memset(region->_buffer, 0, region_row_size * region->_height);
+    for (unsigned int tile_index = 0U; tile_index < sparse_canvas->_tile_offsets.size(); ++tile_index)
     {
-        for (unsigned long long x = 0UL; x < input_width; ++x)
+        const long long tile_x = static_cast<long long>(sparse_canvas->_tile_offsets[tile_index]._x_offset) - x_offset;
+        const long long tile_y = static_cast<long long>(sparse_canvas->_tile_offsets[tile_index]._y_offset) - y_offset;
+        const long long first_x = std::max<long long>(tile_x, 0LL);
+        const long long last_x = std::min<long long>(tile_x + sparse_canvas->_tile_width, region->_width);
+        const long long first_y = std::max<long long>(tile_y, 0LL);
+        const long long last_y = std::min<long long>(tile_y + sparse_canvas->_tile_height, region->_height);
+        if (first_x >= last_x || first_y >= last_y)
         {
-            unsigned long long input_idx = y * input_width + x;
-            for (unsigned char channel_index = 0; channel_index < pixel_size; ++channel_index)
-            {
-                unsigned long long output_channel_idx = output_idx + (x * pixel_size) + channel_index;
-                unsigned long long input_channel_idx = channel_index * pixels_to_delineearize + input_idx;
-                output_buffer[output_channel_idx] = input[input_channel_idx];
-            }
+            continue;
         }
-        output_idx += output->_width * pixel_size;
-    }
 
+        const char* tile_data = get_sparse_canvas_tile_data(*sparse_canvas, tile_index);
+        for (long long y = first_y; y < last_y; ++y)
+        {
+            const unsigned long long input_idx =
+                (static_cast<unsigned long long>(y - tile_y) * sparse_canvas->_tile_width + static_cast<unsigned long long>(first_x - tile_x)) * pixel_size;
+            const unsigned long long output_idx = static_cast<unsigned long long>(y) * region_row_size + static_cast<unsigned long long>(first_x) * pixel_size;
+            std::memcpy(region->_buffer + output_idx, tile_data + input_idx, static_cast<unsigned long long>(last_x - first_x) * pixel_size);
+        }
+    }
     return KRA_IMP_SUCCESS;
 }
@@ -0,0 +1,154 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "lzf_decoder.hpp"
+#include <cstring>
+
+static constexpr const unsigned int KRA_IMP_LZF_MAX_LITERAL_RUN{ 32U };
+static constexpr const unsigned int KRA_IMP_LZF_SHORT_LENGTH_MASK{ 7U };
+static constexpr const unsigned char KRA_IMP_LZF_LONG_COPY_STEP{ 16 };
+static constexpr const unsigned char KRA_IMP_LZF_SHORT_COPY_STEP{ 8 };
+
+static void copy_literal_run(const unsigned char* input, const unsigned char* input_end, unsigned char* output, unsigned char* output_capacity_end, const unsigned int length)
+{
+    if (input_end - input >= static_cast<long long>(KRA_IMP_LZF_MAX_LITERAL_RUN) && output_capacity_end - output >= static_cast<long long>(KRA_IMP_LZF_MAX_LITERAL_RUN))
+    {
+        std::memcpy(output, input, KRA_IMP_LZF_LONG_COPY_STEP);
+        std::memcpy(output + KRA_IMP_LZF_LONG_COPY_STEP, input + KRA_IMP_LZF_LONG_COPY_STEP, KRA_IMP_LZF_LONG_COPY_STEP);
+        return;
+    }
+
+    std::memcpy(output, input, length);
+}
+
+// Copies in steps of `step` bytes; the reference must lie at least `step` bytes behind the output.
+static void copy_back_reference_wide(const unsigned char* reference, unsigned char* output, const unsigned int length, const unsigned char step)
+{
+    for (unsigned int copied = 0U; copied < length; copied += step)
+    {
+        std::memcpy(output + copied, reference + copied, step);
+    }
+}
+
+static void copy_back_reference(const unsigned char* reference, unsigned char* output, unsigned char* output_capacity_end, const unsigned int length)
+{
+    const unsigned long long distance = static_cast<unsigned long long>(output - reference);
+    const unsigned long long wide_capacity = static_cast<unsigned long long>(output_capacity_end - output);
+    if (distance == 1ULL)
+    {
+        std::memset(output, *reference, length);
+    }
+    else if (distance >= KRA_IMP_LZF_LONG_COPY_STEP && wide_capacity >= length + KRA_IMP_LZF_LONG_COPY_STEP - 1U)
+    {
+        copy_back_reference_wide(reference, output, length, KRA_IMP_LZF_LONG_COPY_STEP);
+    }
+    else if (distance >= KRA_IMP_LZF_SHORT_COPY_STEP && wide_capacity >= length + KRA_IMP_LZF_SHORT_COPY_STEP - 1U)
+    {
+        copy_back_reference_wide(reference, output, length, KRA_IMP_LZF_SHORT_COPY_STEP);
+    }
+    else if (distance < KRA_IMP_LZF_SHORT_COPY_STEP && wide_capacity >= length + KRA_IMP_LZF_SHORT_COPY_STEP - 1U)
+    {
+        // The copied bytes repeat with the period `distance`, so once the first `period_distance - distance` bytes are
+        // in place, every byte equals the one `period_distance` bytes before it, which is far enough for 8-byte steps.
+        const unsigned int period_distance = static_cast<unsigned int>(distance * ((KRA_IMP_LZF_SHORT_COPY_STEP + distance - 1U) / distance));
+        unsigned int copied = 0U;
+        for (; copied < period_distance - distance && copied < length; ++copied)
+        {
+            output[copied] = reference[copied];
+        }
+        if (copied < length)
+        {
+            copy_back_reference_wide(output + copied - period_distance, output + copied, length - copied, KRA_IMP_LZF_SHORT_COPY_STEP);
+        }
+    }
+    else
+    {
+        for (unsigned int copied = 0U; copied < length; ++copied)
+        {
+            output[copied] = reference[copied];
+        }
+    }
+}
+
+bool lzf_validate(const char* input, const unsigned long long input_size, const unsigned long long output_size)
+{
+    const unsigned char* input_position = reinterpret_cast<const unsigned char*>(input);
+    const unsigned char* const input_end = input_position + input_size;
+    unsigned long long output_position = 0ULL;
+    while (input_position < input_end)
+    {
+        const unsigned int control = *input_position++;
+        if (control < KRA_IMP_LZF_MAX_LITERAL_RUN)
+        {
+            const unsigned int length = control + 1U;
+            if (output_size - output_position < length || static_cast<unsigned long long>(input_end - input_position) < length)
+            {
+                return false;
+            }
+
+            input_position += length;
+            output_position += length;
+            continue;
+        }
+
+        unsigned int length = control >> 5U;
+        if (length == KRA_IMP_LZF_SHORT_LENGTH_MASK)
+        {
+            if (input_end - input_position < 2)
+            {
+                return false;
+            }
+            length += *input_position++;
+        }
+        else if (input_position >= input_end)
+        {
+            return false;
+        }
+
+        length += 2U;
+        const unsigned long long distance = (static_cast<unsigned long long>(control & 0x1fU) << 8U) + *input_position++ + 1ULL;
+        if (output_size - output_position < length || output_position < distance)
+        {
+            return false;
+        }
+
+        output_position += length;
+    }
+
+    return input_size != 0ULL && output_position == output_size;
+}
+
+void lzf_decode_validated(const char* input, const unsigned long long input_size, char* output, const unsigned long long output_size,
+                          const unsigned long long output_capacity)
+{
+    const unsigned char* input_position = reinterpret_cast<const unsigned char*>(input);
+    const unsigned char* const input_end = input_position + input_size;
+    unsigned char* output_position = reinterpret_cast<unsigned char*>(output);
+    unsigned char* const output_capacity_end = output_position + (output_capacity < output_size ? output_size : output_capacity);
+    while (input_position < input_end)
+    {
+        const unsigned int control = *input_position++;
+        if (control < KRA_IMP_LZF_MAX_LITERAL_RUN)
+        {
+            const unsigned int length = control + 1U;
+            copy_literal_run(input_position, input_end, output_position, output_capacity_end, length);
+            input_position += length;
+            output_position += length;
+            continue;
+        }
+
+        unsigned int length = control >> 5U;
+        if (length == KRA_IMP_LZF_SHORT_LENGTH_MASK)
+        {
+            length += *input_position++;
+        }
+
+        length += 2U;
+        const unsigned long long distance = (static_cast<unsigned long long>(control & 0x1fU) << 8U) + *input_position++ + 1ULL;
+        copy_back_reference(output_position - distance, output_position, output_capacity_end, length);
+        output_position += length;
+    }
+}
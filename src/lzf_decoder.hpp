@@ -0,0 +1,50 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+
+/**
+ * @brief Number of bytes past the decompressed size which `lzf_decode_validated` may overwrite when the output capacity allows it.
+ *
+ * @details
+ * Output buffers owned by the library are padded by this slack, so every literal run and back-reference is copied
+ * with wide 8 or 16-byte moves. Without the slack, copies close to the end of the buffer fall back to exact ones.
+ */
+static constexpr const unsigned long long KRA_IMP_LZF_OUTPUT_SLACK{ 32ULL };
+
+/**
+ * @brief Checks that LZF data decompresses to exactly `output_size` bytes without reading or writing out of bounds.
+ *
+ * @details
+ * Accepts exactly the data for which the reference `lzf_decompress` returns `output_size`. Walks only the control
+ * bytes of the stream, skipping literal runs, so it is much cheaper than decoding. Data accepted here can be decoded
+ * by `lzf_decode_validated` with no further checks.
+ *
+ * @param[in] input LZF compressed data.
+ * @param[in] input_size Size of the compressed data in bytes.
+ * @param[in] output_size Expected number of decompressed bytes.
+ *
+ * @return true if the data is a valid LZF stream of `output_size` bytes, false otherwise.
+ */
+bool lzf_validate(const char* input, const unsigned long long input_size, const unsigned long long output_size);
+
+/**
+ * @brief Decompresses LZF data already accepted by `lzf_validate`, without per-token bounds checks.
+ *
+ * @details
+ * Produces the same output as the reference `lzf_decompress`. Literal runs are moved 32 bytes at a time and
+ * back-references 16 bytes at a time. Runs repeating a single byte are filled with memset, and other back-references
+ * shorter than 8 bytes are widened to a multiple of their period. Bytes between `output_size` and `output_capacity`
+ * may be overwritten with garbage.
+ *
+ * @param[in] input LZF compressed data accepted by `lzf_validate`.
+ * @param[in] input_size Size of the compressed data in bytes.
+ * @param[out] output Buffer receiving the decompressed data.
+ * @param[in] output_size Number of decompressed bytes, as passed to `lzf_validate`.
+ * @param[in] output_capacity Size of the output buffer, at least `output_size`.
+ */
+void lzf_decode_validated(const char* input, const unsigned long long input_size, char* output, const unsigned long long output_size,
+                          const unsigned long long output_capacity);
@@ -0,0 +1,105 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#ifdef _WIN32
+bool map_file(const char* file_path, mapped_file_t& mapped_file)
+{
+    const HANDLE file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER file_size{};
+    if (GetFileSizeEx(file, &file_size) == 0 || file_size.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The view keeps the mapping object and the file alive, so both handles can be closed right away.
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    mapped_file._data = static_cast<const char*>(data);
+    mapped_file._size = static_cast<unsigned long long>(file_size.QuadPart);
+    return true;
+}
+
+void unmap_file(mapped_file_t& mapped_file)
+{
+    if (mapped_file._data != nullptr)
+    {
+        UnmapViewOfFile(mapped_file._data);
+    }
+    mapped_file = {};
+}
+#else
+bool map_file(const char* file_path, mapped_file_t& mapped_file)
+{
+    const int file = open(file_path, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat file_status{};
+    if (fstat(file, &file_status) != 0 || !S_ISREG(file_status.st_mode) || file_status.st_size <= 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    void* data = mmap(nullptr, static_cast<size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    mapped_file._data = static_cast<const char*>(data);
+    mapped_file._size = static_cast<unsigned long long>(file_status.st_size);
+    return true;
+}
+
+void unmap_file(mapped_file_t& mapped_file)
+{
+    if (mapped_file._data != nullptr)
+    {
+        munmap(const_cast<char*>(mapped_file._data), static_cast<size_t>(mapped_file._size));
+    }
+    mapped_file = {};
+}
+#endif
@@ -0,0 +1,37 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+
+/**
+ * @brief Read-only view of a file mapped into memory.
+ */
+struct mapped_file_t
+{
+    const char* _data{ nullptr };     /**< Start of the mapping, or nullptr if nothing is mapped. */
+    unsigned long long _size{ 0ULL }; /**< Size of the mapping in bytes. */
+};
+
+/**
+ * @brief Maps a whole file into memory for reading.
+ *
+ * @details
+ * Pages of the file are loaded lazily by the operating system on first access, so only the parts
+ * actually read are brought into memory. Empty files cannot be mapped.
+ *
+ * @param[in] file_path Path to the file to map.
+ * @param[out] mapped_file Structure receiving the mapping.
+ *
+ * @return true if the file was mapped, false otherwise.
+ */
+bool map_file(const char* file_path, mapped_file_t& mapped_file);
+
+/**
+ * @brief Releases a mapping created by `map_file`. Does nothing for an empty mapping.
+ *
+ * @param[in,out] mapped_file Mapping to release, reset to empty afterwards.
+ */
+void unmap_file(mapped_file_t& mapped_file);
@@ -0,0 +1,194 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "memory.hpp"
+#include "zip_memory.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+struct memory_functions_t
+{
+    kra_imp_allocation_function _allocation_function{ std::malloc };
+    kra_imp_deallocation_function _deallocation_function{ std::free };
+    kra_imp_context_allocation_function _context_allocation_function{ nullptr };
+    kra_imp_context_deallocation_function _context_deallocation_function{ nullptr };
+    void* _context{ nullptr };
+};
+
+struct scratch_buffer_t
+{
+    char* _buffer{ nullptr };
+    size_t _buffer_size{ 0U };
+    size_t _used_size{ 0U };
+    bool _active{ false };
+};
+
+static memory_functions_t memory_functions;
+static thread_local scratch_buffer_t scratch_buffer;
+
+void set_memory_functions(kra_imp_allocation_function allocation_function, kra_imp_deallocation_function deallocation_function,
+                          kra_imp_context_allocation_function context_allocation_function, kra_imp_context_deallocation_function context_deallocation_function, void* context)
+{
+    memory_functions = {};
+    if (allocation_function != nullptr && deallocation_function != nullptr)
+    {
+        memory_functions._allocation_function = allocation_function;
+        memory_functions._deallocation_function = deallocation_function;
+    }
+    else if (context_allocation_function != nullptr && context_deallocation_function != nullptr)
+    {
+        memory_functions._allocation_function = nullptr;
+        memory_functions._deallocation_function = nullptr;
+        memory_functions._context_allocation_function = context_allocation_function;
+        memory_functions._context_deallocation_function = context_deallocation_function;
+        memory_functions._context = context;
+    }
+}
+
+void set_scratch_buffer(char* buffer, size_t buffer_size)
+{
+    scratch_buffer._buffer = buffer;
+    scratch_buffer._buffer_size = buffer == nullptr ? 0U : buffer_size;
+    scratch_buffer._used_size = 0U;
+}
+
+scratch_scope_t::scratch_scope_t()
+    : _outermost{ !scratch_buffer._active }
+{
+    if (_outermost)
+    {
+        scratch_buffer._active = true;
+        scratch_buffer._used_size = 0U;
+    }
+}
+
+scratch_scope_t::~scratch_scope_t()
+{
+    if (_outermost)
+    {
+        scratch_buffer._active = false;
+    }
+}
+
+void* allocate_scratch_memory(size_t size)
+{
+    static constexpr const uintptr_t ALIGNMENT{ alignof(std::max_align_t) };
+    const uintptr_t free_address = reinterpret_cast<uintptr_t>(scratch_buffer._buffer) + scratch_buffer._used_size;
+    const size_t padding = static_cast<size_t>((ALIGNMENT - free_address % ALIGNMENT) % ALIGNMENT);
+    const size_t free_size = scratch_buffer._buffer_size - scratch_buffer._used_size;
+    if (padding > free_size || size > free_size - padding)
+    {
+        return nullptr;
+    }
+
+    char* memory = scratch_buffer._buffer + scratch_buffer._used_size + padding;
+    scratch_buffer._used_size += padding + size;
+    return memory;
+}
+
+bool is_scratch_memory(const void* memory)
+{
+    const char* address = static_cast<const char*>(memory);
+    return scratch_buffer._buffer != nullptr && std::less_equal<const char*>{}(scratch_buffer._buffer, address) &&
+           std::less<const char*>{}(address, scratch_buffer._buffer + scratch_buffer._buffer_size);
+}
+
+void* allocate_user_memory(size_t size)
+{
+    if (memory_functions._allocation_function != nullptr)
+    {
+        return memory_functions._allocation_function(size);
+    }
+
+    return memory_functions._context_allocation_function(memory_functions._context, size);
+}
+
+void deallocate_user_memory(void* memory)
+{
+    if (memory_functions._deallocation_function != nullptr)
+    {
+        memory_functions._deallocation_function(memory);
+        return;
+    }
+
+    memory_functions._context_deallocation_function(memory_functions._context, memory);
+}
+
+void* allocate_memory(size_t size)
+{
+    if (scratch_buffer._active && scratch_buffer._buffer != nullptr)
+    {
+        void* memory = allocate_scratch_memory(size);
+        if (memory != nullptr)
+        {
+            return memory;
+        }
+    }
+
+    return allocate_user_memory(size);
+}
+
+void deallocate_memory(void* memory)
+{
+    // Scratch memory is reclaimed all at once when the next scope starts.
+    if (memory == nullptr || is_scratch_memory(memory))
+    {
+        return;
+    }
+
+    deallocate_user_memory(memory);
+}
+
+// The user functions have no reallocation, so every block given to miniz starts with its size, keeping the rest aligned.
+static constexpr const size_t KRA_IMP_ZIP_BLOCK_HEADER_SIZE{ alignof(std::max_align_t) };
+
+extern "C" void* kra_imp_zip_malloc(size_t size)
+{
+    if (size > SIZE_MAX - KRA_IMP_ZIP_BLOCK_HEADER_SIZE)
+    {
+        return nullptr;
+    }
+
+    char* block = static_cast<char*>(allocate_user_memory(size + KRA_IMP_ZIP_BLOCK_HEADER_SIZE));
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::memcpy(block, &size, sizeof(size));
+    return block + KRA_IMP_ZIP_BLOCK_HEADER_SIZE;
+}
+
+extern "C" void kra_imp_zip_free(void* memory)
+{
+    if (memory != nullptr)
+    {
+        deallocate_user_memory(static_cast<char*>(memory) - KRA_IMP_ZIP_BLOCK_HEADER_SIZE);
+    }
+}
+
+extern "C" void* kra_imp_zip_realloc(void* memory, size_t size)
+{
+    if (memory == nullptr)
+    {
+        return kra_imp_zip_malloc(size);
+    }
+
+    void* resized_memory = kra_imp_zip_malloc(size);
+    if (resized_memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    size_t memory_size = 0U;
+    std::memcpy(&memory_size, static_cast<char*>(memory) - KRA_IMP_ZIP_BLOCK_HEADER_SIZE, sizeof(memory_size));
+    std::memcpy(resized_memory, memory, std::min(memory_size, size));
+    kra_imp_zip_free(memory);
+    return resized_memory;
+}
@@ -0,0 +1,135 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+#include "kra_imp/types.hpp"
+#include <functional>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Sets the functions used by `allocate_memory` and `deallocate_memory`.
+ *
+ * @details
+ * Plain functions take precedence over context functions if both are given. Passing no functions restores malloc and free.
+ *
+ * @param[in] allocation_function Plain allocation function, or nullptr.
+ * @param[in] deallocation_function Plain deallocation function, or nullptr.
+ * @param[in] context_allocation_function Allocation function receiving `context`, or nullptr.
+ * @param[in] context_deallocation_function Deallocation function receiving `context`, or nullptr.
+ * @param[in] context User pointer passed to the context functions.
+ */
+void set_memory_functions(kra_imp_allocation_function allocation_function, kra_imp_deallocation_function deallocation_function,
+                          kra_imp_context_allocation_function context_allocation_function, kra_imp_context_deallocation_function context_deallocation_function, void* context);
+
+/**
+ * @brief Allocates memory through the functions set by the user.
+ *
+ * @param[in] size Number of bytes to allocate.
+ *
+ * @return Pointer to the allocated memory, or nullptr if allocation failed.
+ */
+void* allocate_memory(size_t size);
+
+/**
+ * @brief Frees memory returned by `allocate_memory`. Does nothing for nullptr.
+ *
+ * @param[in] memory Memory to free.
+ */
+void deallocate_memory(void* memory);
+
+/**
+ * @brief Sets the scratch buffer of the calling thread. Passing nullptr removes it.
+ *
+ * @param[in] buffer Memory used for allocations inside a `scratch_scope_t`.
+ * @param[in] buffer_size Size of the buffer in bytes.
+ */
+void set_scratch_buffer(char* buffer, size_t buffer_size);
+
+/**
+ * @brief Makes `allocate_memory` bump-allocate from the calling thread's scratch buffer for its lifetime.
+ *
+ * @details
+ * The scratch buffer is rewound when the outermost scope starts, so every allocation made inside a scope must be
+ * freed before it ends. Allocations which do not fit fall back to the user memory functions.
+ */
+struct scratch_scope_t
+{
+    scratch_scope_t();
+    ~scratch_scope_t();
+    scratch_scope_t(const scratch_scope_t&) = delete;
+    scratch_scope_t& operator=(const scratch_scope_t&) = delete;
+
+private:
+    bool _outermost{ false };
+};
+
+/**
+ * @brief Constructs an object in memory from `allocate_memory`.
+ *
+ * @return Pointer to the object, or nullptr if allocation failed.
+ */
+template <typename T, typename... Args> T* new_object(Args&&... args)
+{
+    void* memory = allocate_memory(sizeof(T));
+    return memory == nullptr ? nullptr : new (memory) T(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Destroys an object created by `new_object`. Does nothing for nullptr.
+ */
+template <typename T> void delete_object(T* object)
+{
+    if (object == nullptr)
+    {
+        return;
+    }
+
+    object->~T();
+    deallocate_memory(object);
+}
+
+/**
+ * @brief Standard allocator forwarding to `allocate_memory`, for containers owned by the library's handles.
+ */
+template <typename T> struct memory_allocator_t
+{
+    using value_type = T;
+
+    memory_allocator_t() noexcept = default;
+    template <typename U> memory_allocator_t(const memory_allocator_t<U>&) noexcept
+    {
+    }
+
+    T* allocate(const size_t count)
+    {
+        void* memory = count > static_cast<size_t>(-1) / sizeof(T) ? nullptr : allocate_memory(count * sizeof(T));
+        if (memory == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return static_cast<T*>(memory);
+    }
+
+    void deallocate(T* memory, size_t) noexcept
+    {
+        deallocate_memory(memory);
+    }
+
+    template <typename U> bool operator==(const memory_allocator_t<U>&) const noexcept
+    {
+        return true;
+    }
+};
+
+template <typename T> using memory_vector_t = std::vector<T, memory_allocator_t<T>>;
+using memory_string_t = std::basic_string<char, std::char_traits<char>, memory_allocator_t<char>>;
+template <typename Key, typename Value>
+using memory_unordered_map_t = std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>, memory_allocator_t<std::pair<const Key, Value>>>;
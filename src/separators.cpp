@@ -0,0 +1,138 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "separators.hpp"
+#include "cpu_features.hpp"
+#include "kernels.hpp"
+#include <bit>
+#include <cstdint>
+
+static constexpr const char KRA_IMP_FIELD_SEPARATOR{ ',' };
+static constexpr const char KRA_IMP_LINE_SEPARATOR{ '\n' };
+
+static unsigned int find_separators_scalar(const char* buffer, const unsigned long long buffer_size, unsigned long long position, unsigned long long* separator_positions,
+                                           const unsigned int separators_count)
+{
+    unsigned int found_count = 0U;
+    for (; found_count < separators_count && position < buffer_size; ++position)
+    {
+        if (buffer[position] == KRA_IMP_FIELD_SEPARATOR || buffer[position] == KRA_IMP_LINE_SEPARATOR)
+        {
+            separator_positions[found_count++] = position;
+        }
+    }
+    return found_count;
+}
+
+// Each separator sets a single bit of `mask`, at `bits_per_byte` times its offset within the block.
+static void collect_separators(uint64_t mask, const unsigned int bits_per_byte, const unsigned long long block_position, unsigned long long* separator_positions,
+                               unsigned int& found_count, const unsigned int separators_count)
+{
+    while (mask != 0U && found_count < separators_count)
+    {
+        separator_positions[found_count++] = block_position + static_cast<unsigned int>(std::countr_zero(mask)) / bits_per_byte;
+        mask &= mask - 1U;
+    }
+}
+
+#ifdef KRA_IMP_X86
+KRA_IMP_TARGET("sse2")
+static unsigned int find_separators_sse2(const char* buffer, const unsigned long long buffer_size, unsigned long long position, unsigned long long* separator_positions,
+                                         const unsigned int separators_count)
+{
+    static constexpr unsigned long long BYTES_PER_STEP{ 16ULL };
+    const __m128i field_separators = _mm_set1_epi8(KRA_IMP_FIELD_SEPARATOR);
+    const __m128i line_separators = _mm_set1_epi8(KRA_IMP_LINE_SEPARATOR);
+    unsigned int found_count = 0U;
+    for (; found_count < separators_count && position + BYTES_PER_STEP <= buffer_size; position += BYTES_PER_STEP)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + position));
+        const __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(bytes, field_separators), _mm_cmpeq_epi8(bytes, line_separators));
+        collect_separators(static_cast<uint32_t>(_mm_movemask_epi8(separators)), 1U, position, separator_positions, found_count, separators_count);
+    }
+    return found_count + find_separators_scalar(buffer, buffer_size, position, separator_positions + found_count, separators_count - found_count);
+}
+
+KRA_IMP_TARGET("avx2")
+static unsigned int find_separators_avx2(const char* buffer, const unsigned long long buffer_size, unsigned long long position, unsigned long long* separator_positions,
+                                         const unsigned int separators_count)
+{
+    static constexpr unsigned long long BYTES_PER_STEP{ 32ULL };
+    const __m256i field_separators = _mm256_set1_epi8(KRA_IMP_FIELD_SEPARATOR);
+    const __m256i line_separators = _mm256_set1_epi8(KRA_IMP_LINE_SEPARATOR);
+    unsigned int found_count = 0U;
+    for (; found_count < separators_count && position + BYTES_PER_STEP <= buffer_size; position += BYTES_PER_STEP)
+    {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + position));
+        const __m256i separators = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, field_separators), _mm256_cmpeq_epi8(bytes, line_separators));
+        collect_separators(static_cast<uint32_t>(_mm256_movemask_epi8(separators)), 1U, position, separator_positions, found_count, separators_count);
+    }
+    return found_count + find_separators_sse2(buffer, buffer_size, position, separator_positions + found_count, separators_count - found_count);
+}
+#endif
+
+#ifdef KRA_IMP_NEON
+static unsigned int find_separators_neon(const char* buffer, const unsigned long long buffer_size, unsigned long long position, unsigned long long* separator_positions,
+                                         const unsigned int separators_count)
+{
+    static constexpr unsigned long long BYTES_PER_STEP{ 16ULL };
+    const uint8x16_t field_separators = vdupq_n_u8(KRA_IMP_FIELD_SEPARATOR);
+    const uint8x16_t line_separators = vdupq_n_u8(KRA_IMP_LINE_SEPARATOR);
+    unsigned int found_count = 0U;
+    for (; found_count < separators_count && position + BYTES_PER_STEP <= buffer_size; position += BYTES_PER_STEP)
+    {
+        const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(buffer + position));
+        const uint8x16_t separators = vorrq_u8(vceqq_u8(bytes, field_separators), vceqq_u8(bytes, line_separators));
+        // Narrowing each 16-bit lane by 4 bits leaves a 64-bit mask with 4 bits per byte.
+        const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(separators), 4)), 0) & 0x8888888888888888ULL;
+        collect_separators(mask, 4U, position, separator_positions, found_count, separators_count);
+    }
+    return found_count + find_separators_scalar(buffer, buffer_size, position, separator_positions + found_count, separators_count - found_count);
+}
+#endif
+
+static find_separators_function select_find_separators_kernel()
+{
+#if defined(KRA_IMP_X86)
+    if (cpu_supports_avx2())
+    {
+        return find_separators_avx2;
+    }
+    if (cpu_supports_sse2())
+    {
+        return find_separators_sse2;
+    }
+#elif defined(KRA_IMP_NEON)
+    return find_separators_neon;
+#endif
+    return find_separators_scalar;
+}
+
+unsigned int find_separators(const char* buffer, const unsigned long long buffer_size, const unsigned long long position, unsigned long long* separator_positions,
+                             const unsigned int separators_count)
+{
+    static const find_separators_function FIND_SEPARATORS_KERNEL{ select_find_separators_kernel() };
+    return FIND_SEPARATORS_KERNEL(buffer, buffer_size, position, separator_positions, separators_count);
+}
+
+kernels_t<find_separators_function> list_find_separators_functions()
+{
+    kernels_t<find_separators_function> kernels{};
+    kernels._kernels[kernels._kernels_count++] = { "scalar", find_separators_scalar };
+#if defined(KRA_IMP_X86)
+    if (cpu_supports_sse2())
+    {
+        kernels._kernels[kernels._kernels_count++] = { "sse2", find_separators_sse2 };
+    }
+    if (cpu_supports_avx2())
+    {
+        kernels._kernels[kernels._kernels_count++] = { "avx2", find_separators_avx2 };
+    }
+#elif defined(KRA_IMP_NEON)
+    kernels._kernels[kernels._kernels_count++] = { "neon", find_separators_neon };
+#endif
+    return kernels;
+}
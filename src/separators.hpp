@@ -0,0 +1,32 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#pragma once
+
+/**
+ * @brief Kernel finding the positions of the next field separators, with the parameters of `find_separators`.
+ */
+using find_separators_function = unsigned int (*)(const char* buffer, const unsigned long long buffer_size, unsigned long long position,
+                                                  unsigned long long* separator_positions, const unsigned int separators_count);
+
+/**
+ * @brief Finds the positions of the next field separators (',' or '\n') in a buffer.
+ *
+ * @details
+ * Scans 16 or 32 bytes at a time and collects every separator of a block from a single comparison mask,
+ * so a whole tile line is usually tokenized by one or two loads. The kernel (AVX2, SSE2, NEON or scalar) is
+ * selected once, on first use, for the best instruction set supported by the CPU. Never reads past `buffer_size`.
+ *
+ * @param[in] buffer Buffer to scan.
+ * @param[in] buffer_size Size of the buffer in bytes.
+ * @param[in] position Position to start scanning at.
+ * @param[out] separator_positions Positions of the found separators, in increasing order.
+ * @param[in] separators_count Maximum number of separators to find.
+ *
+ * @return Number of separators found, less than `separators_count` only if the end of the buffer was reached.
+ */
+unsigned int find_separators(const char* buffer, const unsigned long long buffer_size, const unsigned long long position, unsigned long long* separator_positions,
+                             const unsigned int separators_count);
@@ -0,0 +1,31 @@
+/**
+ * kra_imp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#ifndef KRA_IMP_ZIP_MEMORY_H
+#define KRA_IMP_ZIP_MEMORY_H
+
+#include <stddef.h>
+
+/*
+ * Memory functions miniz is built with when the zip library is fetched along with kra_imp, through its
+ * MZ_MALLOC, MZ_REALLOC and MZ_FREE macros. They forward to the functions set with `kra_imp_set_memory_functions`,
+ * bypassing the scratch buffer, since the reader state lives as long as its archive. This header is force-included
+ * into the zip sources, so it is plain C.
+ */
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    void* kra_imp_zip_malloc(size_t size);
+    void* kra_imp_zip_realloc(void* memory, size_t size);
+    void kra_imp_zip_free(void* memory);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,6 +6,10 @@
  */
 #include <array>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
 #include <kra_imp/kra_imp.hpp>
 
 constexpr const std::string_view EMPTY_ARCHIVE = "";
@@ -133,3 +137,284 @@ TEST_CASE("kra_imp_load_file proper file", "[archive]")
     REQUIRE(file_content.compare("example") == 0);
     kra_imp_close_archive(archive);
 }
+
+TEST_CASE("kra_imp_get_files_count", "[archive]")
+{
+    REQUIRE(kra_imp_get_files_count(nullptr) == 0ULL);
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_get_files_count(archive) == 2ULL);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_find_file_index null params", "[archive]")
+{
+    unsigned long long file_index{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_find_file_index(nullptr, PROPER_FILE_PATH.data(), &file_index) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_find_file_index(archive, nullptr, &file_index) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_find_file_index(archive, PROPER_FILE_PATH.data(), nullptr) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_find_file_index wrong file", "[archive]")
+{
+    unsigned long long file_index{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_find_file_index(archive, WRONG_FILE_PATH.data(), &file_index) == KRA_IMP_FAIL);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_find_file_index ignores case and normalizes path", "[archive]")
+{
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    unsigned long long expected_file_index{ 0ULL };
+    REQUIRE(kra_imp_find_file_index(archive, PROPER_FILE_PATH.data(), &expected_file_index) == KRA_IMP_SUCCESS);
+    for (const char* file_path : { "Example/EXAMPLE.txt", "./example/example.txt", "/example//./example.txt", "example\\Example.TXT" })
+    {
+        unsigned long long file_index{ 0ULL };
+        REQUIRE(kra_imp_find_file_index(archive, file_path, &file_index) == KRA_IMP_SUCCESS);
+        REQUIRE(file_index == expected_file_index);
+        std::array<char, 7> file_buffer{};
+        const unsigned long long file_size = kra_imp_load_file(archive, file_path, file_buffer.data(), file_buffer.size());
+        REQUIRE(std::string_view(file_buffer.data(), file_size) == "example");
+    }
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_load_file_by_index proper file", "[archive]")
+{
+    unsigned long long file_index{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_find_file_index(archive, PROPER_FILE_PATH.data(), &file_index) == KRA_IMP_SUCCESS);
+    REQUIRE(std::string_view(kra_imp_get_file_name(archive, file_index)) == PROPER_FILE_PATH);
+    REQUIRE(kra_imp_get_file_size_by_index(archive, file_index) == 7ULL);
+    std::array<char, 7> file_buffer{};
+    const unsigned long long file_size = kra_imp_load_file_by_index(archive, file_index, file_buffer.data(), file_buffer.size());
+    REQUIRE(std::string_view(file_buffer.data(), file_size) == "example");
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_load_file_by_index index out of range", "[archive]")
+{
+    std::array<char, 7> file_buffer{};
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    const unsigned long long files_count = kra_imp_get_files_count(archive);
+    REQUIRE(kra_imp_get_file_name(archive, files_count) == nullptr);
+    REQUIRE(kra_imp_get_file_size_by_index(archive, files_count) == 0ULL);
+    REQUIRE(kra_imp_load_file_by_index(archive, files_count, file_buffer.data(), file_buffer.size()) == 0ULL);
+    REQUIRE(kra_imp_load_file_by_index(nullptr, 0ULL, file_buffer.data(), file_buffer.size()) == 0ULL);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_read_file null params", "[archive]")
+{
+    std::array<char, 7> file_buffer{};
+    unsigned long long file_size{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_read_file(nullptr, PROPER_FILE_PATH.data(), file_buffer.data(), file_buffer.size(), &file_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_file(archive, nullptr, file_buffer.data(), file_buffer.size(), &file_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_file(archive, PROPER_FILE_PATH.data(), nullptr, file_buffer.size(), &file_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_file(archive, PROPER_FILE_PATH.data(), file_buffer.data(), file_buffer.size(), nullptr) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_read_file wrong file", "[archive]")
+{
+    std::array<char, 7> file_buffer{};
+    unsigned long long file_size{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_read_file(archive, WRONG_FILE_PATH.data(), file_buffer.data(), file_buffer.size(), &file_size) == KRA_IMP_FAIL);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_read_file too small buffer reports size", "[archive]")
+{
+    unsigned long long file_size{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_read_file(archive, PROPER_FILE_PATH.data(), nullptr, 0ULL, &file_size) == KRA_IMP_FAIL);
+    REQUIRE(file_size == 7ULL);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_read_file proper file", "[archive]")
+{
+    std::array<char, 8> file_buffer{};
+    unsigned long long file_size{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_read_file(archive, PROPER_FILE_PATH.data(), file_buffer.data(), file_buffer.size(), &file_size) == KRA_IMP_SUCCESS);
+    REQUIRE(std::string_view(file_buffer.data(), file_size) == "example");
+    kra_imp_close_archive(archive);
+}
+
+static char* allocate_file_buffer(void* user_data, unsigned long long file_size)
+{
+    std::string& file_content = *static_cast<std::string*>(user_data);
+    file_content.resize(file_size);
+    return file_content.data();
+}
+
+static char* fail_file_buffer_allocation(void*, unsigned long long)
+{
+    return nullptr;
+}
+
+TEST_CASE("kra_imp_read_file_allocated null params", "[archive]")
+{
+    std::string file_content;
+    char* file_buffer{ nullptr };
+    unsigned long long file_size{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_read_file_allocated(nullptr, PROPER_FILE_PATH.data(), allocate_file_buffer, &file_content, &file_buffer, &file_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_file_allocated(archive, PROPER_FILE_PATH.data(), nullptr, &file_content, &file_buffer, &file_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_file_allocated(archive, PROPER_FILE_PATH.data(), allocate_file_buffer, &file_content, nullptr, &file_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_file_allocated(archive, PROPER_FILE_PATH.data(), allocate_file_buffer, &file_content, &file_buffer, nullptr) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_read_file_allocated failed allocation", "[archive]")
+{
+    char* file_buffer{ nullptr };
+    unsigned long long file_size{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_read_file_allocated(archive, PROPER_FILE_PATH.data(), fail_file_buffer_allocation, nullptr, &file_buffer, &file_size) == KRA_IMP_FAIL);
+    REQUIRE(file_buffer == nullptr);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_read_file_allocated proper file", "[archive]")
+{
+    std::string file_content;
+    char* file_buffer{ nullptr };
+    unsigned long long file_size{ 0ULL };
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_read_file_allocated(archive, PROPER_FILE_PATH.data(), allocate_file_buffer, &file_content, &file_buffer, &file_size) == KRA_IMP_SUCCESS);
+    REQUIRE(file_buffer == file_content.data());
+    REQUIRE(file_size == 7ULL);
+    REQUIRE(file_content == "example");
+    kra_imp_close_archive(archive);
+}
+
+static void* count_archive_allocation(void* context, size_t size)
+{
+    ++*static_cast<unsigned int*>(context);
+    return std::malloc(size);
+}
+
+static void count_archive_deallocation(void* context, void* ptr)
+{
+    --*static_cast<unsigned int*>(context);
+    std::free(ptr);
+}
+
+TEST_CASE("kra_imp_open_archive uses memory functions", "[archive]")
+{
+    unsigned int live_allocations_count{ 0U };
+    kra_imp_set_memory_functions_with_context(count_archive_allocation, count_archive_deallocation, &live_allocations_count);
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(archive != nullptr);
+    REQUIRE(live_allocations_count > 0U);
+    kra_imp_close_archive(archive);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(live_allocations_count == 0U);
+}
+
+static kra_imp_error_code_e append_file_chunk(void* user_data, const char* chunk, unsigned long long chunk_size)
+{
+    static_cast<std::string*>(user_data)->append(chunk, chunk_size);
+    return KRA_IMP_SUCCESS;
+}
+
+static kra_imp_error_code_e reject_file_chunk(void*, const char*, unsigned long long)
+{
+    return KRA_IMP_FAIL;
+}
+
+TEST_CASE("kra_imp_stream_file null params", "[archive]")
+{
+    std::string file_content;
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_stream_file(nullptr, PROPER_FILE_PATH.data(), append_file_chunk, &file_content) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_stream_file(archive, nullptr, append_file_chunk, &file_content) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_stream_file(archive, PROPER_FILE_PATH.data(), nullptr, &file_content) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_stream_file wrong file", "[archive]")
+{
+    std::string file_content;
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_stream_file(archive, WRONG_FILE_PATH.data(), append_file_chunk, &file_content) == KRA_IMP_FAIL);
+    REQUIRE(file_content.empty());
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_stream_file proper file", "[archive]")
+{
+    std::string file_content;
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_stream_file(archive, PROPER_FILE_PATH.data(), append_file_chunk, &file_content) == KRA_IMP_SUCCESS);
+    REQUIRE(file_content == "example");
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_stream_file stopped by chunk function", "[archive]")
+{
+    kra_imp_archive_t* archive = kra_imp_open_archive(reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    REQUIRE(kra_imp_stream_file(archive, PROPER_FILE_PATH.data(), reject_file_chunk, nullptr) == KRA_IMP_FAIL);
+    kra_imp_close_archive(archive);
+}
+
+std::filesystem::path write_archive_file(const std::string_view file_name, const char* archive_buffer, const std::size_t archive_buffer_size)
+{
+    const std::filesystem::path archive_file_path = std::filesystem::temp_directory_path() / file_name;
+    std::ofstream archive_file(archive_file_path, std::ios::binary | std::ios::trunc);
+    archive_file.write(archive_buffer, archive_buffer_size);
+    return archive_file_path;
+}
+
+TEST_CASE("kra_imp_open_archive_file null path", "[archive]")
+{
+    kra_imp_archive_t* archive = kra_imp_open_archive_file(nullptr);
+    REQUIRE(archive == nullptr);
+}
+
+TEST_CASE("kra_imp_open_archive_file missing file", "[archive]")
+{
+    const std::filesystem::path archive_file_path = std::filesystem::temp_directory_path() / "kra_imp_missing_archive.kra";
+    std::filesystem::remove(archive_file_path);
+    kra_imp_archive_t* archive = kra_imp_open_archive_file(archive_file_path.string().c_str());
+    REQUIRE(archive == nullptr);
+}
+
+TEST_CASE("kra_imp_open_archive_file empty file", "[archive]")
+{
+    const std::filesystem::path archive_file_path = write_archive_file("kra_imp_empty_archive.kra", EMPTY_ARCHIVE.data(), EMPTY_ARCHIVE.size());
+    kra_imp_archive_t* archive = kra_imp_open_archive_file(archive_file_path.string().c_str());
+    REQUIRE(archive == nullptr);
+    std::filesystem::remove(archive_file_path);
+}
+
+TEST_CASE("kra_imp_open_archive_file invalid archive", "[archive]")
+{
+    const std::filesystem::path archive_file_path =
+        write_archive_file("kra_imp_invalid_archive.kra", reinterpret_cast<const char*>(INVALID_ARCHIVE.data()), INVALID_ARCHIVE.size());
+    kra_imp_archive_t* archive = kra_imp_open_archive_file(archive_file_path.string().c_str());
+    REQUIRE(archive == nullptr);
+    std::filesystem::remove(archive_file_path);
+}
+
+TEST_CASE("kra_imp_open_archive_file proper file", "[archive]")
+{
+    const std::filesystem::path archive_file_path =
+        write_archive_file("kra_imp_proper_archive.kra", reinterpret_cast<const char*>(PROPER_ARCHIVE.data()), PROPER_ARCHIVE.size());
+    kra_imp_archive_t* archive = kra_imp_open_archive_file(archive_file_path.string().c_str());
+    REQUIRE(archive != nullptr);
+    REQUIRE(kra_imp_get_file_size(archive, PROPER_FILE_PATH.data()) == 7ULL);
+    std::array<char, 7> file_buffer{};
+    const unsigned long long file_size = kra_imp_load_file(archive, PROPER_FILE_PATH.data(), file_buffer.data(), file_buffer.size());
+    const std::string_view file_content(file_buffer.data(), file_size);
+    REQUIRE(file_size == file_buffer.size());
+    REQUIRE(file_content.compare("example") == 0);
+    kra_imp_close_archive(archive);
+    std::filesystem::remove(archive_file_path);
+}
@@ -1,6 +1,10 @@
+#include <algorithm>
 #include <array>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
 #include <kra_imp/kra_imp.hpp>
+#include <limits>
+#include <vector>
 
 TEST_CASE("kra_imp_delinearize_to_bgra null input buffer", "[delinearize_to_bgra]")
 {
@@ -144,3 +148,403 @@ TEST_CASE("kra_imp_delinearize_with_offset with offset", "[delinearize_with_offs
     REQUIRE(result == KRA_IMP_SUCCESS);
     REQUIRE(output_buffer == expected_output_buffer);
 }
+
+TEST_CASE("kra_imp_delinearize_with_offset wide rows", "[delinearize_with_offset]")
+{
+    // Width not being a multiple of any vector width covers both the vectorized and the remainder paths.
+    const unsigned int width = 71;
+    const unsigned int height = 3;
+    const unsigned int pixel_size = 4;
+    const unsigned int output_width = width + 5;
+    const unsigned int output_height = height + 1;
+    const unsigned int output_offset = (output_width + 2) * pixel_size;
+    std::array<char, width * height * pixel_size> input_buffer{};
+    for (unsigned int i = 0; i < input_buffer.size(); ++i)
+    {
+        input_buffer[i] = static_cast<char>(i * 7 + i / 251);
+    }
+    std::array<char, output_width * output_height * pixel_size> expected_output_buffer{};
+    for (unsigned int y = 0; y < height; ++y)
+    {
+        for (unsigned int x = 0; x < width; ++x)
+        {
+            for (unsigned int channel = 0; channel < pixel_size; ++channel)
+            {
+                expected_output_buffer[output_offset + (y * output_width + x) * pixel_size + channel] = input_buffer[channel * width * height + y * width + x];
+            }
+        }
+    }
+    std::array<char, output_width * output_height * pixel_size> output_buffer{};
+    kra_imp_delinerize_output_t output{};
+    output._buffer = output_buffer.data();
+    output._buffer_size = output_buffer.size();
+    output._width = output_width;
+    output._offset = output_offset;
+    const kra_imp_error_code_e result = kra_imp_delinearize_with_offset(input_buffer.data(), input_buffer.size(), width, &output);
+    REQUIRE(result == KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == expected_output_buffer);
+}
+
+TEST_CASE("kra_imp_delinearize_layer_data all pixel sizes", "[delinearize_layer_data]")
+{
+    // Pixel sizes with vectorized, unrolled and generic kernels, on rows covering both the vectorized and the remainder paths.
+    const unsigned int width = 71;
+    const unsigned int height = 3;
+    const unsigned int output_width = width + 5;
+    const unsigned int output_height = height + 1;
+    for (const unsigned int pixel_size : { 1U, 2U, 3U, 4U, 5U, 8U, 10U, 16U, 20U, 32U })
+    {
+        const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, pixel_size, width, height, 2U };
+        const unsigned long long output_offset = (output_width + 2ULL) * pixel_size;
+        std::vector<char> input_buffer(width * height * pixel_size);
+        for (unsigned int i = 0; i < input_buffer.size(); ++i)
+        {
+            input_buffer[i] = static_cast<char>(i * 7 + i / 251);
+        }
+        std::vector<char> expected_output_buffer(output_width * output_height * pixel_size);
+        for (unsigned int y = 0; y < height; ++y)
+        {
+            for (unsigned int x = 0; x < width; ++x)
+            {
+                for (unsigned int plane = 0; plane < pixel_size; ++plane)
+                {
+                    expected_output_buffer[output_offset + (y * output_width + x) * pixel_size + plane] = input_buffer[plane * width * height + y * width + x];
+                }
+            }
+        }
+        std::vector<char> output_buffer(expected_output_buffer.size());
+        kra_imp_delinerize_output_t output{ output_buffer.data(), output_buffer.size(), output_offset, output_width };
+        const kra_imp_error_code_e result = kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, &layer_data_header, &output);
+        REQUIRE(result == KRA_IMP_SUCCESS);
+        REQUIRE(output_buffer == expected_output_buffer);
+    }
+}
+
+TEST_CASE("kra_imp_delinearize_layer_data matches kra_imp_delinearize_with_offset", "[delinearize_layer_data]")
+{
+    const unsigned int width = 64;
+    const unsigned int pixel_size = 4;
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, pixel_size, width, width, 2U };
+    std::vector<char> input_buffer(width * width * pixel_size);
+    for (unsigned int i = 0; i < input_buffer.size(); ++i)
+    {
+        input_buffer[i] = static_cast<char>(i * 13 + i / 97);
+    }
+    std::vector<char> expected_output_buffer(input_buffer.size());
+    kra_imp_delinerize_output_t expected_output{ expected_output_buffer.data(), expected_output_buffer.size(), 0ULL, width };
+    REQUIRE(kra_imp_delinearize_with_offset(input_buffer.data(), input_buffer.size(), width, &expected_output) == KRA_IMP_SUCCESS);
+    std::vector<char> output_buffer(input_buffer.size());
+    kra_imp_delinerize_output_t output{ output_buffer.data(), output_buffer.size(), 0ULL, width };
+    REQUIRE(kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, &layer_data_header, &output) == KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == expected_output_buffer);
+}
+
+TEST_CASE("kra_imp_delinearize_layer_data unsupported pixel size", "[delinearize_layer_data]")
+{
+    const unsigned int width = 4;
+    std::array<char, 4 * 4 * 64> input_buffer{ 0 };
+    std::array<char, 4 * 4 * 64> output_buffer{ 0 };
+    kra_imp_delinerize_output_t output{ output_buffer.data(), output_buffer.size(), 0ULL, width };
+    const kra_imp_layer_data_header_t zero_pixel_size_header{ 0U, 1U, 0U, width, width, 2U };
+    const kra_imp_layer_data_header_t too_big_pixel_size_header{ 0U, 1U, 64U, width, width, 2U };
+    REQUIRE(kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, &zero_pixel_size_header, &output) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, &too_big_pixel_size_header, &output) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, nullptr, &output) == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_delinearize_layer_data too small output", "[delinearize_layer_data]")
+{
+    const unsigned int width = 4;
+    const unsigned int pixel_size = 8;
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, pixel_size, width, width, 2U };
+    std::array<char, width * width * pixel_size> input_buffer{ 0 };
+    std::array<char, width * width * pixel_size> output_buffer{ 0 };
+    kra_imp_delinerize_output_t output{ output_buffer.data(), output_buffer.size(), pixel_size, width };
+    REQUIRE(kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, &layer_data_header, &output) == KRA_IMP_PARAMS_ERROR);
+    output._offset = 0ULL;
+    output._width = width + 1U;
+    REQUIRE(kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, &layer_data_header, &output) == KRA_IMP_PARAMS_ERROR);
+    output._width = width;
+    REQUIRE(kra_imp_delinearize_layer_data(input_buffer.data(), input_buffer.size(), width, &layer_data_header, &output) == KRA_IMP_SUCCESS);
+}
+
+TEST_CASE("kra_imp_convert_pixels rgba u8", "[convert_pixels]")
+{
+    const unsigned int pixels_count = 7;
+    std::array<char, pixels_count * 4> input_buffer{};
+    for (unsigned int index = 0; index < input_buffer.size(); ++index)
+    {
+        input_buffer[index] = static_cast<char>(index * 9);
+    }
+    std::array<char, pixels_count * 4> output_buffer{};
+    kra_imp_color_conversion_t color_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), pixels_count, &color_conversion, output_buffer.data()) == KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == input_buffer);
+
+    color_conversion._pixel_order = KRA_IMP_RGBA_PIXEL_ORDER;
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), pixels_count, &color_conversion, output_buffer.data()) == KRA_IMP_SUCCESS);
+    for (unsigned int pixel = 0; pixel < pixels_count; ++pixel)
+    {
+        REQUIRE(output_buffer[pixel * 4] == input_buffer[pixel * 4 + 2]);
+        REQUIRE(output_buffer[pixel * 4 + 1] == input_buffer[pixel * 4 + 1]);
+        REQUIRE(output_buffer[pixel * 4 + 2] == input_buffer[pixel * 4]);
+        REQUIRE(output_buffer[pixel * 4 + 3] == input_buffer[pixel * 4 + 3]);
+    }
+}
+
+TEST_CASE("kra_imp_convert_pixels rgba u16 rounds to nearest", "[convert_pixels]")
+{
+    const unsigned int pixels_count = 5;
+    const std::array<unsigned short, pixels_count * 4> input_buffer{ 0,   65535, 25700, 32896, 128,   129,   65406, 65408, 257, 514,
+                                                                     771, 1028,  0,     0,     65535, 65535, 385,   386,   0,   65535 };
+    const std::array<unsigned char, pixels_count * 4> expected_bgra{ 0, 255, 100, 128, 0, 1, 254, 255, 1, 2, 3, 4, 0, 0, 255, 255, 1, 2, 0, 255 };
+    std::array<unsigned char, pixels_count * 4> output_buffer{};
+    kra_imp_color_conversion_t color_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U16_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(input_buffer.data()), pixels_count, &color_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == expected_bgra);
+
+    color_conversion._pixel_order = KRA_IMP_RGBA_PIXEL_ORDER;
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(input_buffer.data()), pixels_count, &color_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer[0] == expected_bgra[2]);
+    REQUIRE(output_buffer[2] == expected_bgra[0]);
+    REQUIRE(output_buffer[16] == expected_bgra[18]);
+    REQUIRE(output_buffer[18] == expected_bgra[16]);
+}
+
+TEST_CASE("kra_imp_convert_pixels graya", "[convert_pixels]")
+{
+    const unsigned int pixels_count = 9;
+    std::array<unsigned char, pixels_count * 2> input_u8{};
+    std::array<unsigned short, pixels_count * 2> input_u16{};
+    for (unsigned int pixel = 0; pixel < pixels_count; ++pixel)
+    {
+        input_u8[pixel * 2] = static_cast<unsigned char>(pixel * 25);
+        input_u8[pixel * 2 + 1] = static_cast<unsigned char>(255 - pixel);
+        input_u16[pixel * 2] = static_cast<unsigned short>(pixel * 25 * 257);
+        input_u16[pixel * 2 + 1] = static_cast<unsigned short>((255 - pixel) * 257);
+    }
+    std::array<unsigned char, pixels_count * 4> output_u8{};
+    std::array<unsigned char, pixels_count * 4> output_u16{};
+    const kra_imp_color_conversion_t u8_conversion{ KRA_IMP_GRAYA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    const kra_imp_color_conversion_t u16_conversion{ KRA_IMP_GRAYA_COLOR_SPACE_MODEL, KRA_IMP_U16_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(input_u8.data()), pixels_count, &u8_conversion, reinterpret_cast<char*>(output_u8.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(input_u16.data()), pixels_count, &u16_conversion, reinterpret_cast<char*>(output_u16.data())) ==
+            KRA_IMP_SUCCESS);
+    for (unsigned int pixel = 0; pixel < pixels_count; ++pixel)
+    {
+        const std::array<unsigned char, 4> expected{ input_u8[pixel * 2], input_u8[pixel * 2], input_u8[pixel * 2], input_u8[pixel * 2 + 1] };
+        REQUIRE(std::equal(expected.begin(), expected.end(), output_u8.begin() + pixel * 4));
+        REQUIRE(std::equal(expected.begin(), expected.end(), output_u16.begin() + pixel * 4));
+    }
+}
+
+TEST_CASE("kra_imp_convert_pixels cmyk u8", "[convert_pixels]")
+{
+    const std::array<unsigned char, 4 * 5> input_buffer{ 0, 0, 0, 0, 255, 255, 0, 0, 0, 128, 0, 0, 0, 255, 255, 0, 128, 255, 0, 64 };
+    const std::array<unsigned char, 4 * 4> expected_rgba{ 255, 255, 255, 255, 0, 255, 255, 128, 0, 0, 0, 255, 255, 127, 0, 64 };
+    std::array<unsigned char, 4 * 4> output_buffer{};
+    const kra_imp_color_conversion_t color_conversion{ KRA_IMP_CMYK_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(input_buffer.data()), 4, &color_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == expected_rgba);
+}
+
+TEST_CASE("kra_imp_convert_pixels float rgba is encoded to srgb", "[convert_pixels]")
+{
+    const float not_a_number = std::numeric_limits<float>::quiet_NaN();
+    const std::array<float, 2 * 4> input_buffer{ 0.0f, 0.5f, 1.0f, 0.5f, not_a_number, 2.0f, -1.0f, 1.0f };
+    const std::array<unsigned char, 2 * 4> expected_rgba{ 0, 188, 255, 128, 0, 255, 0, 255 };
+    std::array<unsigned char, 2 * 4> output_buffer{};
+    const kra_imp_color_conversion_t color_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_F32_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(input_buffer.data()), 2, &color_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == expected_rgba);
+
+    // Half floats 1.0 and 0.5.
+    const std::array<unsigned short, 2> half_input{ 0x3C00, 0x3800 };
+    const kra_imp_color_conversion_t half_conversion{ KRA_IMP_GRAYA_COLOR_SPACE_MODEL, KRA_IMP_F16_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(half_input.data()), 1, &half_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer[0] == 255);
+    REQUIRE(output_buffer[1] == 255);
+    REQUIRE(output_buffer[2] == 255);
+    REQUIRE(output_buffer[3] == 128);
+}
+
+TEST_CASE("kra_imp_convert_pixels lab, xyz and ycbcr", "[convert_pixels]")
+{
+    std::array<unsigned char, 4> output_buffer{};
+    const std::array<float, 4> lab_white{ 100.0f, 0.0f, 0.0f, 1.0f };
+    const kra_imp_color_conversion_t lab_conversion{ KRA_IMP_CIELAB_COLOR_SPACE_MODEL, KRA_IMP_F32_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(lab_white.data()), 1, &lab_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == std::array<unsigned char, 4>{ 255, 255, 255, 255 });
+
+    const std::array<unsigned short, 4> xyz_black{ 0, 0, 0, 65535 };
+    const kra_imp_color_conversion_t xyz_conversion{ KRA_IMP_XYZA_COLOR_SPACE_MODEL, KRA_IMP_U16_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(xyz_black.data()), 1, &xyz_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == std::array<unsigned char, 4>{ 0, 0, 0, 255 });
+
+    const std::array<unsigned char, 4> ycbcr_gray{ 100, 128, 128, 255 };
+    const kra_imp_color_conversion_t ycbcr_conversion{ KRA_IMP_YCBCR_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(ycbcr_gray.data()), 1, &ycbcr_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == std::array<unsigned char, 4>{ 100, 100, 100, 255 });
+}
+
+TEST_CASE("kra_imp_convert_pixels lab u16 lightness range", "[convert_pixels]")
+{
+    // Krita's 16-bit L reaches 100 at 0xFF00 and 50 at 0x7F80, a and b are neutral at 0x8080.
+    const std::array<unsigned short, 3 * 4> lab_grays{ 0xFF00, 0x8080, 0x8080, 0xFFFF, 0xFFFF, 0x8080, 0x8080, 0xFFFF, 0x7F80, 0x8080, 0x8080, 0xFFFF };
+    const std::array<unsigned char, 3 * 4> expected_rgba{ 255, 255, 255, 255, 255, 255, 255, 255, 119, 119, 119, 255 };
+    std::array<unsigned char, 3 * 4> output_buffer{};
+    const kra_imp_color_conversion_t lab_conversion{ KRA_IMP_CIELAB_COLOR_SPACE_MODEL, KRA_IMP_U16_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(reinterpret_cast<const char*>(lab_grays.data()), 3, &lab_conversion, reinterpret_cast<char*>(output_buffer.data())) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == expected_rgba);
+}
+
+TEST_CASE("kra_imp_convert_pixels invalid params", "[convert_pixels]")
+{
+    const std::array<char, 4> input_buffer{ 0 };
+    std::array<char, 4> output_buffer{ 0 };
+    const kra_imp_color_conversion_t color_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    const kra_imp_color_conversion_t unknown_model{ KRA_IMP_UNKNOWN_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    const kra_imp_color_conversion_t unknown_depth{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_UNKNOWN_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    const kra_imp_color_conversion_t argb_order{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_ARGB_PIXEL_ORDER };
+    REQUIRE(kra_imp_convert_pixels(nullptr, 1, &color_conversion, output_buffer.data()) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), 0, &color_conversion, output_buffer.data()) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), 1, nullptr, output_buffer.data()) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), 1, &color_conversion, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), 1, &unknown_model, output_buffer.data()) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), 1, &unknown_depth, output_buffer.data()) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_convert_pixels(input_buffer.data(), 1, &argb_order, output_buffer.data()) == KRA_IMP_PARAMS_ERROR);
+}
+
+static std::vector<char> make_bgra_planes(const unsigned int width, const unsigned int height)
+{
+    std::vector<char> planes(width * height * 4);
+    for (unsigned int index = 0; index < planes.size(); ++index)
+    {
+        planes[index] = static_cast<char>(index * 37 + index / 7);
+    }
+    return planes;
+}
+
+TEST_CASE("kra_imp_delinearize_to_format straight bgra matches kra_imp_delinearize_with_offset", "[delinearize_to_format]")
+{
+    const unsigned int width = 21;
+    const unsigned int height = 3;
+    const std::vector<char> input_buffer = make_bgra_planes(width, height);
+    std::vector<char> output_buffer(width * height * 4);
+    std::vector<char> expected_buffer(width * height * 4);
+    kra_imp_delinerize_output_t output{ output_buffer.data(), output_buffer.size(), 0ULL, width };
+    kra_imp_delinerize_output_t expected_output{ expected_buffer.data(), expected_buffer.size(), 0ULL, width };
+    const kra_imp_pixel_format_t pixel_format{ KRA_IMP_BGRA_PIXEL_ORDER, KRA_IMP_STRAIGHT_ALPHA, KRA_IMP_U8_CHANNEL_DEPTH };
+    REQUIRE(kra_imp_delinearize_to_format(input_buffer.data(), input_buffer.size(), width, &pixel_format, &output) == KRA_IMP_SUCCESS);
+    REQUIRE(kra_imp_delinearize_with_offset(input_buffer.data(), input_buffer.size(), width, &expected_output) == KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == expected_buffer);
+}
+
+TEST_CASE("kra_imp_delinearize_to_format 8-bit orders and premultiplied alpha", "[delinearize_to_format]")
+{
+    const unsigned int width = 21;
+    const unsigned int height = 3;
+    const unsigned int plane_size = width * height;
+    const std::vector<char> input_buffer = make_bgra_planes(width, height);
+    const std::array<kra_imp_pixel_order_e, 3> pixel_orders{ KRA_IMP_BGRA_PIXEL_ORDER, KRA_IMP_RGBA_PIXEL_ORDER, KRA_IMP_ARGB_PIXEL_ORDER };
+    const std::array<std::array<unsigned int, 4>, 3> channel_positions{ { { 0, 1, 2, 3 }, { 2, 1, 0, 3 }, { 3, 2, 1, 0 } } };
+    for (unsigned int order_index = 0; order_index < pixel_orders.size(); ++order_index)
+    {
+        for (const kra_imp_alpha_mode_e alpha_mode : { KRA_IMP_STRAIGHT_ALPHA, KRA_IMP_PREMULTIPLIED_ALPHA })
+        {
+            const unsigned int output_width = width + 1;
+            std::vector<unsigned char> output_buffer(output_width * height * 4 + 4);
+            kra_imp_delinerize_output_t output{ reinterpret_cast<char*>(output_buffer.data()), output_buffer.size(), 4ULL, output_width };
+            const kra_imp_pixel_format_t pixel_format{ pixel_orders[order_index], alpha_mode, KRA_IMP_U8_CHANNEL_DEPTH };
+            REQUIRE(kra_imp_delinearize_to_format(input_buffer.data(), input_buffer.size(), width, &pixel_format, &output) == KRA_IMP_SUCCESS);
+            for (unsigned int pixel = 0; pixel < plane_size; ++pixel)
+            {
+                const unsigned char* output_pixel = output_buffer.data() + 4 + ((pixel / width) * output_width + pixel % width) * 4;
+                const unsigned int alpha = static_cast<unsigned char>(input_buffer[3 * plane_size + pixel]);
+                for (unsigned int channel_index = 0; channel_index < 4; ++channel_index)
+                {
+                    const unsigned int channel = static_cast<unsigned char>(input_buffer[channel_index * plane_size + pixel]);
+                    const bool premultiply = alpha_mode == KRA_IMP_PREMULTIPLIED_ALPHA && channel_index != 3;
+                    const unsigned int expected = premultiply ? static_cast<unsigned int>(std::lround(channel * alpha / 255.0)) : channel;
+                    REQUIRE(output_pixel[channel_positions[order_index][channel_index]] == expected);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("kra_imp_delinearize_to_format premultiplied rgba around the simd width", "[delinearize_to_format]")
+{
+    // Every pixel is (255, 128, 1, alpha) in BGRA, so the expected premultiplied RGBA values are known exactly.
+    const std::array<unsigned char, 4> alphas{ 0, 1, 128, 255 };
+    const std::array<std::array<unsigned char, 4>, 4> expected_pixels{ { { 0, 0, 0, 0 }, { 0, 1, 1, 1 }, { 1, 64, 128, 128 }, { 1, 128, 255, 255 } } };
+    for (const unsigned int width : { 15U, 16U, 17U })
+    {
+        std::vector<unsigned char> input_buffer(width * 4);
+        for (unsigned int pixel = 0; pixel < width; ++pixel)
+        {
+            input_buffer[pixel] = 255;
+            input_buffer[width + pixel] = 128;
+            input_buffer[2 * width + pixel] = 1;
+            input_buffer[3 * width + pixel] = alphas[pixel % alphas.size()];
+        }
+        // One guard pixel past the row catches writes beyond the scalar tail.
+        std::vector<unsigned char> output_buffer((width + 1) * 4, 0xA5);
+        kra_imp_delinerize_output_t output{ reinterpret_cast<char*>(output_buffer.data()), output_buffer.size(), 0ULL, width };
+        const kra_imp_pixel_format_t pixel_format{ KRA_IMP_RGBA_PIXEL_ORDER, KRA_IMP_PREMULTIPLIED_ALPHA, KRA_IMP_U8_CHANNEL_DEPTH };
+        REQUIRE(kra_imp_delinearize_to_format(reinterpret_cast<const char*>(input_buffer.data()), input_buffer.size(), width, &pixel_format, &output) ==
+                KRA_IMP_SUCCESS);
+        for (unsigned int pixel = 0; pixel < width; ++pixel)
+        {
+            const std::array<unsigned char, 4>& expected = expected_pixels[pixel % expected_pixels.size()];
+            REQUIRE(std::equal(expected.begin(), expected.end(), output_buffer.begin() + pixel * 4));
+        }
+        REQUIRE(std::all_of(output_buffer.end() - 4, output_buffer.end(), [](const unsigned char value) { return value == 0xA5; }));
+    }
+}
+
+TEST_CASE("kra_imp_delinearize_to_format 16-bit and float channels", "[delinearize_to_format]")
+{
+    const unsigned int width = 2;
+    // Two BGRA pixels: (255, 128, 0, 255) and (255, 128, 0, 51).
+    const std::array<unsigned char, width * 4> input_buffer{ 255, 255, 128, 128, 0, 0, 255, 51 };
+    std::array<unsigned short, width * 4> u16_buffer{};
+    kra_imp_delinerize_output_t u16_output{ reinterpret_cast<char*>(u16_buffer.data()), sizeof(u16_buffer), 0ULL, width };
+    const kra_imp_pixel_format_t u16_format{ KRA_IMP_RGBA_PIXEL_ORDER, KRA_IMP_PREMULTIPLIED_ALPHA, KRA_IMP_U16_CHANNEL_DEPTH };
+    REQUIRE(kra_imp_delinearize_to_format(reinterpret_cast<const char*>(input_buffer.data()), input_buffer.size(), width, &u16_format, &u16_output) == KRA_IMP_SUCCESS);
+    REQUIRE(u16_buffer == std::array<unsigned short, width * 4>{ 0, 32896, 65535, 65535, 0, 6579, 13107, 13107 });
+
+    std::array<float, width * 4> float_buffer{};
+    kra_imp_delinerize_output_t float_output{ reinterpret_cast<char*>(float_buffer.data()), sizeof(float_buffer), 0ULL, width };
+    const kra_imp_pixel_format_t float_format{ KRA_IMP_ARGB_PIXEL_ORDER, KRA_IMP_STRAIGHT_ALPHA, KRA_IMP_F32_CHANNEL_DEPTH };
+    REQUIRE(kra_imp_delinearize_to_format(reinterpret_cast<const char*>(input_buffer.data()), input_buffer.size(), width, &float_format, &float_output) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(float_buffer == std::array<float, width * 4>{ 1.0f, 0.0f, 128.0f * (1.0f / 255.0f), 1.0f, 51.0f * (1.0f / 255.0f), 0.0f, 128.0f * (1.0f / 255.0f), 1.0f });
+}
+
+TEST_CASE("kra_imp_delinearize_to_format invalid params", "[delinearize_to_format]")
+{
+    const unsigned int width = 4;
+    const std::array<char, width * width * 4> input_buffer{ 0 };
+    std::array<char, width * width * 8> output_buffer{ 0 };
+    kra_imp_delinerize_output_t output{ output_buffer.data(), output_buffer.size(), 0ULL, width };
+    const kra_imp_pixel_format_t pixel_format{ KRA_IMP_RGBA_PIXEL_ORDER, KRA_IMP_PREMULTIPLIED_ALPHA, KRA_IMP_U8_CHANNEL_DEPTH };
+    const kra_imp_pixel_format_t half_format{ KRA_IMP_RGBA_PIXEL_ORDER, KRA_IMP_STRAIGHT_ALPHA, KRA_IMP_F16_CHANNEL_DEPTH };
+    const kra_imp_pixel_format_t float_format{ KRA_IMP_RGBA_PIXEL_ORDER, KRA_IMP_STRAIGHT_ALPHA, KRA_IMP_F32_CHANNEL_DEPTH };
+    REQUIRE(kra_imp_delinearize_to_format(nullptr, input_buffer.size(), width, &pixel_format, &output) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_delinearize_to_format(input_buffer.data(), input_buffer.size(), width, nullptr, &output) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_delinearize_to_format(input_buffer.data(), input_buffer.size(), width, &pixel_format, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_delinearize_to_format(input_buffer.data(), input_buffer.size(), width, &half_format, &output) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_delinearize_to_format(input_buffer.data(), input_buffer.size(), width, &float_format, &output) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_delinearize_to_format(input_buffer.data(), input_buffer.size(), width, &pixel_format, &output) == KRA_IMP_SUCCESS);
+}
@@ -0,0 +1,220 @@
+/**
+ * kraimp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+#include <kra_imp/kra_imp.hpp>
+
+constexpr const std::string_view EMPTY_XML = "";
+
+constexpr const std::string_view INVALID_MAIN_DOC_XML = R"(
+	<?xml version="1.0" encoding="UTF-8"?
+	<!DOCTYPE DOC PUBLIC '-//KDE//DTD krita 2.0//EN' 'http://www.calligra.org/DTD/krita-2.0.dtd'
+	<DOC xmlns="http://www.calligra.org/DTD/krita" kritaVersion="5.0.0" syntaxVersion="2.0" editor="Krita"
+	</DOC>
+	)";
+
+constexpr const std::string_view NO_IMAGE_MAIN_DOC_XML = R"(
+	<?xml version="1.0" encoding="UTF-8"?>
+	<!DOCTYPE DOC PUBLIC '-//KDE//DTD krita 2.0//EN' 'http://www.calligra.org/DTD/krita-2.0.dtd'>
+	<DOC xmlns="http://www.calligra.org/DTD/krita" kritaVersion="5.0.0" syntaxVersion="2.0" editor="Krita">
+	</DOC>
+	)";
+
+constexpr const std::string_view GROUP_MAIN_DOC_XML = R"(
+	<?xml version="1.0" encoding="UTF-8"?>
+	<!DOCTYPE DOC PUBLIC '-//KDE//DTD krita 2.0//EN' 'http://www.calligra.org/DTD/krita-2.0.dtd'>
+	<DOC xmlns="http://www.calligra.org/DTD/krita" kritaVersion="5.0.0" syntaxVersion="2.0" editor="Krita">
+	 <IMAGE name="Example" colorspacename="RGBA" mime="application/x-kra" width="128" height="64">
+	  <layers>
+	   <layer name="background" nodetype="paintlayer" visible="1" opacity="255" filename="layer1"/>
+	   <layer name="group" nodetype="grouplayer" visible="0" opacity="200" filename="layer2">
+	    <layers>
+	     <layer name="sublayer" nodetype="paintlayer" visible="1" opacity="127" filename="layer3" keyframes="layer3.keyframes.xml"/>
+	     <layer name="subgroup" nodetype="grouplayer" visible="1" opacity="255" filename="layer4">
+	      <layers>
+	       <layer name="mask" nodetype="transparencymask" visible="1" opacity="255" filename="layer5"/>
+	      </layers>
+	     </layer>
+	    </layers>
+	   </layer>
+	   <layer name="top" nodetype="paintlayer" visible="1" opacity="64" filename="layer6"/>
+	  </layers>
+	  <animation>
+	   <framerate type="value" value="24"/>
+	   <range from="0" type="timerange" to="100"/>
+	  </animation>
+	 </IMAGE>
+	</DOC>
+	)";
+
+constexpr const std::string_view KEY_FRAMES_XML = R"(
+	<?xml version="1.0" encoding="UTF-8"?>
+    <!DOCTYPE keyframes PUBLIC '-//KDE//DTD krita-keyframes 1.0//EN' 'http://www.calligra.org/DTD/krita-keyframes-1.0.dtd'>
+    <keyframes xmlns="http://www.calligra.org/DTD/krita-keyframes">
+     <channel name="content">
+      <keyframe color-label="0" time="0" frame="layer3">
+       <offset type="point" x="0" y="0"/>
+      </keyframe>
+      <keyframe color-label="0" time="24" frame="layer3.f1">
+       <offset type="point" x="10" y="-5"/>
+      </keyframe>
+     </channel>
+    </keyframes>
+	)";
+
+TEST_CASE("kra_imp_open_document null buffer", "[document]")
+{
+    REQUIRE(kra_imp_open_document(nullptr, GROUP_MAIN_DOC_XML.size()) == nullptr);
+}
+
+TEST_CASE("kra_imp_open_document xml_buffer_size=0", "[document]")
+{
+    REQUIRE(kra_imp_open_document(GROUP_MAIN_DOC_XML.data(), 0ULL) == nullptr);
+}
+
+TEST_CASE("kra_imp_open_document empty buffer", "[document]")
+{
+    REQUIRE(kra_imp_open_document(EMPTY_XML.data(), EMPTY_XML.size()) == nullptr);
+}
+
+TEST_CASE("kra_imp_open_document invalid xml", "[document]")
+{
+    REQUIRE(kra_imp_open_document(INVALID_MAIN_DOC_XML.data(), INVALID_MAIN_DOC_XML.size()) == nullptr);
+}
+
+TEST_CASE("kra_imp_get_document_* null document", "[document]")
+{
+    kra_imp_main_doc_t main_doc;
+    kra_imp_image_layer_t image_layer;
+    kra_imp_image_key_frame_t key_frame;
+    REQUIRE(kra_imp_get_document_main_doc(nullptr, &main_doc) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_document_layers_count(nullptr) == 0U);
+    REQUIRE(kra_imp_get_document_image_layer(nullptr, 0U, &image_layer) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_document_key_frames_count(nullptr) == 0U);
+    REQUIRE(kra_imp_get_document_image_key_frame(nullptr, 0U, &key_frame) == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_get_document_main_doc no IMAGE node", "[document]")
+{
+    kra_imp_document_t* document = kra_imp_open_document(NO_IMAGE_MAIN_DOC_XML.data(), NO_IMAGE_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    kra_imp_main_doc_t main_doc;
+    REQUIRE(kra_imp_get_document_main_doc(document, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_document_main_doc(document, &main_doc) == KRA_IMP_FAIL);
+    REQUIRE(kra_imp_get_document_layers_count(document) == 0U);
+    kra_imp_close_document(document);
+}
+
+TEST_CASE("kra_imp_get_document_main_doc matches kra_imp_read_main_doc", "[document]")
+{
+    kra_imp_document_t* document = kra_imp_open_document(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    kra_imp_main_doc_t expected;
+    REQUIRE(kra_imp_read_main_doc(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), &expected) == KRA_IMP_SUCCESS);
+    kra_imp_main_doc_t main_doc;
+    REQUIRE(kra_imp_get_document_main_doc(document, &main_doc) == KRA_IMP_SUCCESS);
+    REQUIRE(std::strcmp(main_doc._image_name, expected._image_name) == 0);
+    REQUIRE(main_doc._color_space_model == expected._color_space_model);
+    REQUIRE(main_doc._layers_count == 6U);
+    REQUIRE(main_doc._layers_count == expected._layers_count);
+    REQUIRE(main_doc._width == 128U);
+    REQUIRE(main_doc._height == 64U);
+    REQUIRE(main_doc._animation._frame_rate == 24U);
+    REQUIRE(main_doc._animation._from == 0U);
+    REQUIRE(main_doc._animation._to == 100U);
+    REQUIRE(kra_imp_get_document_layers_count(document) == 6U);
+    REQUIRE(kra_imp_get_document_key_frames_count(document) == 0U);
+    kra_imp_close_document(document);
+}
+
+TEST_CASE("kra_imp_get_document_image_layer matches kra_imp_read_image_layer", "[document]")
+{
+    constexpr long EXPECTED_PARENTS[] = { -1L, -1L, 1L, 1L, 3L, -1L };
+    kra_imp_document_t* document = kra_imp_open_document(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    for (unsigned int layer_index = 0U; layer_index < kra_imp_get_document_layers_count(document); ++layer_index)
+    {
+        kra_imp_image_layer_t expected;
+        REQUIRE(kra_imp_read_image_layer(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), layer_index, &expected) == KRA_IMP_SUCCESS);
+        kra_imp_image_layer_t image_layer;
+        REQUIRE(kra_imp_get_document_image_layer(document, layer_index, &image_layer) == KRA_IMP_SUCCESS);
+        REQUIRE(std::strcmp(image_layer._name, expected._name) == 0);
+        REQUIRE(std::strcmp(image_layer._file_name, expected._file_name) == 0);
+        REQUIRE(std::strcmp(image_layer._frame_file_name, expected._frame_file_name) == 0);
+        REQUIRE(image_layer._opacity == expected._opacity);
+        REQUIRE(image_layer._visibility == expected._visibility);
+        REQUIRE(image_layer._type == expected._type);
+        REQUIRE(image_layer._parent_index == expected._parent_index);
+        REQUIRE(image_layer._parent_index == EXPECTED_PARENTS[layer_index]);
+    }
+    kra_imp_image_layer_t image_layer;
+    REQUIRE(kra_imp_get_document_image_layer(document, 6U, &image_layer) == KRA_IMP_FAIL);
+    REQUIRE(kra_imp_get_document_image_layer(document, 0U, nullptr) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_document(document);
+}
+
+TEST_CASE("kra_imp_get_document_image_layers layer tree", "[document]")
+{
+    constexpr long EXPECTED_FIRST_CHILDREN[] = { -1L, 2L, -1L, 4L, -1L, -1L };
+    constexpr long EXPECTED_NEXT_SIBLINGS[] = { 1L, 5L, 3L, -1L, -1L, -1L };
+    constexpr unsigned int EXPECTED_DEPTHS[] = { 0U, 0U, 1U, 1U, 2U, 0U };
+    kra_imp_document_t* document = kra_imp_open_document(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    kra_imp_image_layer_node_t layer_nodes[7];
+    REQUIRE(kra_imp_get_document_image_layers(document, nullptr, 6U) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_document_image_layers(document, layer_nodes, 0U) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_document_image_layers(document, layer_nodes, 7U) == KRA_IMP_FAIL);
+    REQUIRE(kra_imp_get_document_image_layers(document, layer_nodes, 6U) == KRA_IMP_SUCCESS);
+    for (unsigned int layer_index = 0U; layer_index < 6U; ++layer_index)
+    {
+        kra_imp_image_layer_t image_layer;
+        REQUIRE(kra_imp_get_document_image_layer(document, layer_index, &image_layer) == KRA_IMP_SUCCESS);
+        REQUIRE(std::strcmp(layer_nodes[layer_index]._layer._name, image_layer._name) == 0);
+        REQUIRE(layer_nodes[layer_index]._layer._parent_index == image_layer._parent_index);
+        REQUIRE(layer_nodes[layer_index]._first_child_index == EXPECTED_FIRST_CHILDREN[layer_index]);
+        REQUIRE(layer_nodes[layer_index]._next_sibling_index == EXPECTED_NEXT_SIBLINGS[layer_index]);
+        REQUIRE(layer_nodes[layer_index]._depth == EXPECTED_DEPTHS[layer_index]);
+    }
+
+    kra_imp_image_layer_node_t expected_nodes[6];
+    REQUIRE(kra_imp_read_image_layers(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), expected_nodes, 6U) == KRA_IMP_SUCCESS);
+    for (unsigned int layer_index = 0U; layer_index < 6U; ++layer_index)
+    {
+        REQUIRE(std::strcmp(layer_nodes[layer_index]._layer._name, expected_nodes[layer_index]._layer._name) == 0);
+        REQUIRE(layer_nodes[layer_index]._first_child_index == expected_nodes[layer_index]._first_child_index);
+        REQUIRE(layer_nodes[layer_index]._next_sibling_index == expected_nodes[layer_index]._next_sibling_index);
+        REQUIRE(layer_nodes[layer_index]._depth == expected_nodes[layer_index]._depth);
+    }
+    kra_imp_close_document(document);
+}
+
+TEST_CASE("kra_imp_get_document_image_key_frame matches kra_imp_read_image_key_frame", "[document]")
+{
+    kra_imp_document_t* document = kra_imp_open_document(KEY_FRAMES_XML.data(), KEY_FRAMES_XML.size());
+    REQUIRE(document != nullptr);
+    REQUIRE(kra_imp_get_document_layers_count(document) == 0U);
+    REQUIRE(kra_imp_get_document_key_frames_count(document) == kra_imp_get_image_key_frames_count(KEY_FRAMES_XML.data(), KEY_FRAMES_XML.size()));
+    REQUIRE(kra_imp_get_document_key_frames_count(document) == 2U);
+    for (unsigned int key_frame_index = 0U; key_frame_index < kra_imp_get_document_key_frames_count(document); ++key_frame_index)
+    {
+        kra_imp_image_key_frame_t expected;
+        REQUIRE(kra_imp_read_image_key_frame(KEY_FRAMES_XML.data(), KEY_FRAMES_XML.size(), key_frame_index, &expected) == KRA_IMP_SUCCESS);
+        kra_imp_image_key_frame_t key_frame;
+        REQUIRE(kra_imp_get_document_image_key_frame(document, key_frame_index, &key_frame) == KRA_IMP_SUCCESS);
+        REQUIRE(std::strcmp(key_frame._frame, expected._frame) == 0);
+        REQUIRE(key_frame._time == expected._time);
+        REQUIRE(key_frame._x == expected._x);
+        REQUIRE(key_frame._y == expected._y);
+    }
+    kra_imp_image_key_frame_t key_frame;
+    REQUIRE(kra_imp_get_document_image_key_frame(document, 1U, &key_frame) == KRA_IMP_SUCCESS);
+    REQUIRE(key_frame._x == 10);
+    REQUIRE(key_frame._y == -5);
+    REQUIRE(kra_imp_get_document_image_key_frame(document, 2U, &key_frame) == KRA_IMP_FAIL);
+    REQUIRE(kra_imp_get_document_image_key_frame(document, 0U, nullptr) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_document(document);
+}
@@ -4,8 +4,11 @@
  * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
  * This library is distributed under the MIT License.
  */
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <kra_imp/kra_imp.hpp>
+#include <string>
+#include <vector>
 
 constexpr const std::string_view EMPTY_XML = "";
 
@@ -200,3 +203,126 @@ TEST_CASE("kra_imp_read_image_layer read layer types", "[image_layer]")
     REQUIRE(result == KRA_IMP_SUCCESS);
     REQUIRE(image_layer._type == KRA_IMP_TRANSPARENCYMASK_LAYER_TYPE);
 }
+
+TEST_CASE("kra_imp_read_image_layers null buffer", "[image_layer]")
+{
+    kra_imp_image_layer_node_t layer_nodes[7];
+    kra_imp_error_code_e result = kra_imp_read_image_layers(nullptr, GROUP_MAIN_DOC_XML.size(), layer_nodes, 7U);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+    result = kra_imp_read_image_layers(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), nullptr, 7U);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+    result = kra_imp_read_image_layers(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), layer_nodes, 0U);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_image_layers invalid xml", "[image_layer]")
+{
+    kra_imp_image_layer_node_t layer_nodes[1];
+    kra_imp_error_code_e result = kra_imp_read_image_layers(INVALID_MAIN_DOC_XML.data(), INVALID_MAIN_DOC_XML.size(), layer_nodes, 1U);
+    REQUIRE(result == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_read_image_layers too many layers requested", "[image_layer]")
+{
+    kra_imp_image_layer_node_t layer_nodes[8];
+    kra_imp_error_code_e result = kra_imp_read_image_layers(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), layer_nodes, 8U);
+    REQUIRE(result == KRA_IMP_FAIL);
+}
+
+TEST_CASE("kra_imp_read_image_layers with a grouped layers", "[image_layer]")
+{
+    kra_imp_image_layer_node_t layer_nodes[7];
+    kra_imp_error_code_e result = kra_imp_read_image_layers(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), layer_nodes, 7U);
+    REQUIRE(result == KRA_IMP_SUCCESS);
+    REQUIRE(layer_nodes[0]._layer._type == KRA_IMP_GROUP_LAYER_TYPE);
+    REQUIRE(layer_nodes[0]._layer._parent_index == -1L);
+    REQUIRE(layer_nodes[0]._first_child_index == 1L);
+    REQUIRE(layer_nodes[0]._next_sibling_index == -1L);
+    REQUIRE(layer_nodes[0]._depth == 0U);
+    for (unsigned int layer_index = 1U; layer_index < 7U; ++layer_index)
+    {
+        kra_imp_image_layer_t image_layer;
+        result = kra_imp_read_image_layer(GROUP_MAIN_DOC_XML.data(), GROUP_MAIN_DOC_XML.size(), layer_index, &image_layer);
+        REQUIRE(result == KRA_IMP_SUCCESS);
+        REQUIRE(std::strcmp(layer_nodes[layer_index]._layer._name, image_layer._name) == 0);
+        REQUIRE(layer_nodes[layer_index]._layer._type == image_layer._type);
+        REQUIRE(layer_nodes[layer_index]._layer._parent_index == 0L);
+        REQUIRE(layer_nodes[layer_index]._first_child_index == -1L);
+        REQUIRE(layer_nodes[layer_index]._next_sibling_index == (layer_index < 6U ? static_cast<long>(layer_index) + 1L : -1L));
+        REQUIRE(layer_nodes[layer_index]._depth == 1U);
+    }
+}
+
+std::string make_layer_stack_main_doc_xml(const unsigned int groups_count, const unsigned int group_layers_count)
+{
+    std::string xml = R"(<?xml version="1.0" encoding="UTF-8"?>
+<DOC xmlns="http://www.calligra.org/DTD/krita" kritaVersion="5.0.0" syntaxVersion="2.0" editor="Krita">
+ <IMAGE name="Example" colorspacename="RGBA" width="4096" height="4096">
+  <layers>
+)";
+    for (unsigned int group_index = 0U; group_index < groups_count; ++group_index)
+    {
+        xml += R"(   <layer name="group" nodetype="grouplayer" visible="1" opacity="255" filename="group">)";
+        xml += "\n    <layers>\n";
+        for (unsigned int layer_index = 0U; layer_index < group_layers_count; ++layer_index)
+        {
+            xml += R"(     <layer name="layer" colorspacename="RGBA" nodetype="paintlayer" visible="1" opacity="127" filename="layer" compositeop="normal"/>)";
+            xml += "\n";
+        }
+        xml += "    </layers>\n   </layer>\n";
+    }
+    xml += "  </layers>\n </IMAGE>\n</DOC>\n";
+    return xml;
+}
+
+TEST_CASE("kra_imp_read_image_layer large layer stack", "[image_layer][.benchmark]")
+{
+    const std::string xml = make_layer_stack_main_doc_xml(64U, 7U);
+    kra_imp_main_doc_t main_doc;
+    REQUIRE(kra_imp_read_main_doc(xml.data(), xml.size(), &main_doc) == KRA_IMP_SUCCESS);
+    REQUIRE(main_doc._layers_count == 512U);
+    std::vector<kra_imp_image_layer_node_t> layer_nodes(main_doc._layers_count);
+
+    // Both readers parse the whole document, so only the difference between them is the walk to the layer.
+    BENCHMARK("kra_imp_read_image_layer first layer")
+    {
+        kra_imp_image_layer_t image_layer;
+        kra_imp_read_image_layer(xml.data(), xml.size(), 0U, &image_layer);
+        return image_layer._opacity;
+    };
+
+    BENCHMARK("kra_imp_read_image_layer last layer")
+    {
+        kra_imp_image_layer_t image_layer;
+        kra_imp_read_image_layer(xml.data(), xml.size(), main_doc._layers_count - 1U, &image_layer);
+        return image_layer._opacity;
+    };
+
+    BENCHMARK("kra_imp_read_image_layers")
+    {
+        return kra_imp_read_image_layers(xml.data(), xml.size(), layer_nodes.data(), main_doc._layers_count);
+    };
+
+    BENCHMARK("kra_imp_open_document")
+    {
+        kra_imp_document_t* document = kra_imp_open_document(xml.data(), xml.size());
+        kra_imp_close_document(document);
+        return document != nullptr;
+    };
+
+    // The document is parsed once, outside of the timed code, so only the layer lookups are measured.
+    kra_imp_document_t* document = kra_imp_open_document(xml.data(), xml.size());
+    REQUIRE(document != nullptr);
+    BENCHMARK("kra_imp_get_document_image_layer per index")
+    {
+        kra_imp_image_layer_t image_layer;
+        unsigned int opacity_sum = 0U;
+        for (unsigned int layer_index = 0U; layer_index < main_doc._layers_count; ++layer_index)
+        {
+            kra_imp_get_document_image_layer(document, layer_index, &image_layer);
+            opacity_sum += image_layer._opacity;
+        }
+        return opacity_sum;
+    };
+    kra_imp_close_document(document);
+}
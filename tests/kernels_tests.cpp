@@ -0,0 +1,135 @@
+/**
+ * kraimp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "kernels.hpp"
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+
+// Widths around the 16 and 32-pixel SIMD steps, so every kernel also runs its scalar tail.
+static constexpr std::array<unsigned long long, 10> KERNEL_TEST_WIDTHS{ 1ULL, 7ULL, 15ULL, 16ULL, 17ULL, 31ULL, 33ULL, 63ULL, 64ULL, 97ULL };
+static constexpr char KERNEL_TEST_GUARD{ 0x5A };
+
+static std::vector<char> make_random_bytes(const std::size_t size, const unsigned int seed)
+{
+    std::minstd_rand generator(seed);
+    std::vector<char> bytes(size);
+    for (char& byte : bytes)
+    {
+        byte = static_cast<char>(generator() & 0xFFU);
+    }
+    return bytes;
+}
+
+TEST_CASE("delinearize row kernels match scalar kernel", "[kernels]")
+{
+    for (unsigned int pixel_size = 1U; pixel_size <= KRA_IMP_MAX_PIXEL_SIZE; ++pixel_size)
+    {
+        const kernels_t<delinearize_row_function> kernels = list_delinearize_row_functions(pixel_size);
+        REQUIRE(kernels._kernels_count > 0U);
+        for (const unsigned long long width : KERNEL_TEST_WIDTHS)
+        {
+            const std::vector<char> input = make_random_bytes(width * pixel_size, pixel_size);
+            std::vector<const char*> planes(pixel_size);
+            for (unsigned int plane_index = 0U; plane_index < pixel_size; ++plane_index)
+            {
+                planes[plane_index] = input.data() + plane_index * width;
+            }
+
+            std::vector<char> expected_output(width * pixel_size + 1U, KERNEL_TEST_GUARD);
+            kernels._kernels[0]._function(planes.data(), pixel_size, expected_output.data(), width);
+            for (unsigned int kernel_index = 1U; kernel_index < kernels._kernels_count; ++kernel_index)
+            {
+                INFO(kernels._kernels[kernel_index]._instruction_set << " pixel size " << pixel_size << " width " << width);
+                std::vector<char> output(width * pixel_size + 1U, KERNEL_TEST_GUARD);
+                kernels._kernels[kernel_index]._function(planes.data(), pixel_size, output.data(), width);
+                REQUIRE(output == expected_output);
+            }
+        }
+    }
+}
+
+TEST_CASE("delinearize row kernels unsupported pixel size", "[kernels]")
+{
+    REQUIRE(list_delinearize_row_functions(0U)._kernels_count == 0U);
+    REQUIRE(list_delinearize_row_functions(KRA_IMP_MAX_PIXEL_SIZE + 1U)._kernels_count == 0U);
+}
+
+TEST_CASE("delinearize format row kernels match scalar kernel", "[kernels]")
+{
+    // Every channel and alpha pair, followed by an odd tail, so premultiplication is checked exhaustively.
+    static constexpr unsigned long long PIXELS_COUNT{ 256ULL * 256ULL + 7ULL };
+    std::array<std::vector<char>, 4> channels{};
+    for (std::vector<char>& channel : channels)
+    {
+        channel.resize(PIXELS_COUNT);
+    }
+    for (unsigned long long x = 0ULL; x < PIXELS_COUNT; ++x)
+    {
+        channels[0][x] = static_cast<char>(x & 0xFFU);
+        channels[1][x] = static_cast<char>(~x & 0xFFU);
+        channels[2][x] = static_cast<char>((x * 7U) & 0xFFU);
+        channels[3][x] = static_cast<char>((x >> 8U) & 0xFFU);
+    }
+    const char* const planes[4] = { channels[0].data(), channels[1].data(), channels[2].data(), channels[3].data() };
+
+    for (const kra_imp_pixel_order_e pixel_order : { KRA_IMP_BGRA_PIXEL_ORDER, KRA_IMP_RGBA_PIXEL_ORDER, KRA_IMP_ARGB_PIXEL_ORDER })
+    {
+        for (const kra_imp_alpha_mode_e alpha_mode : { KRA_IMP_STRAIGHT_ALPHA, KRA_IMP_PREMULTIPLIED_ALPHA })
+        {
+            const kra_imp_pixel_format_t pixel_format{ pixel_order, alpha_mode, KRA_IMP_U8_CHANNEL_DEPTH };
+            const kernels_t<delinearize_format_row_function> kernels = list_delinearize_format_row_functions(pixel_format);
+            REQUIRE(kernels._kernels_count > 0U);
+            for (const unsigned long long width : { PIXELS_COUNT, 15ULL, 16ULL, 17ULL })
+            {
+                std::vector<char> expected_output(width * 4U + 1U, KERNEL_TEST_GUARD);
+                kernels._kernels[0]._function(planes, expected_output.data(), width);
+                for (unsigned int kernel_index = 1U; kernel_index < kernels._kernels_count; ++kernel_index)
+                {
+                    INFO(kernels._kernels[kernel_index]._instruction_set << " order " << pixel_order << " alpha " << alpha_mode << " width " << width);
+                    std::vector<char> output(width * 4U + 1U, KERNEL_TEST_GUARD);
+                    kernels._kernels[kernel_index]._function(planes, output.data(), width);
+                    REQUIRE(output == expected_output);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("find separators kernels match scalar kernel", "[kernels]")
+{
+    const kernels_t<find_separators_function> kernels = list_find_separators_functions();
+    REQUIRE(kernels._kernels_count > 0U);
+    std::vector<char> buffer = make_random_bytes(200U, 1U);
+    for (std::size_t index = 0U; index < buffer.size(); ++index)
+    {
+        // Roughly one byte in eight becomes a separator.
+        if ((static_cast<unsigned char>(buffer[index]) & 0x7U) == 0U)
+        {
+            buffer[index] = (index & 1U) == 0U ? ',' : '\n';
+        }
+    }
+
+    for (const unsigned long long buffer_size : { 0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 31ULL, 32ULL, 33ULL, 65ULL, 200ULL })
+    {
+        for (const unsigned long long position : { 0ULL, 1ULL, 3ULL, 17ULL })
+        {
+            for (const unsigned int separators_count : { 1U, 4U, 8U, 64U })
+            {
+                std::vector<unsigned long long> expected_positions(separators_count, 0ULL);
+                const unsigned int expected_count = kernels._kernels[0]._function(buffer.data(), buffer_size, position, expected_positions.data(), separators_count);
+                for (unsigned int kernel_index = 1U; kernel_index < kernels._kernels_count; ++kernel_index)
+                {
+                    INFO(kernels._kernels[kernel_index]._instruction_set << " size " << buffer_size << " position " << position << " count " << separators_count);
+                    std::vector<unsigned long long> positions(separators_count, 0ULL);
+                    REQUIRE(kernels._kernels[kernel_index]._function(buffer.data(), buffer_size, position, positions.data(), separators_count) == expected_count);
+                    REQUIRE(positions == expected_positions);
+                }
+            }
+        }
+    }
+}
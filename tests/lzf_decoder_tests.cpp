@@ -0,0 +1,121 @@
+/**
+ * kraimp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "lzf/lzf.h"
+#include "lzf_decoder.hpp"
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <vector>
+
+// Mixes random literals with repeats of earlier bytes at short and long distances, so every token kind is produced.
+static std::vector<char> make_compressible_bytes(std::minstd_rand& generator, const unsigned int size)
+{
+    std::vector<char> bytes;
+    bytes.reserve(size);
+    while (bytes.size() < size)
+    {
+        const unsigned int remaining_size = size - static_cast<unsigned int>(bytes.size());
+        const unsigned int run_size = std::min(remaining_size, 1U + static_cast<unsigned int>(generator() % 300U));
+        if (bytes.empty() || generator() % 3U == 0U)
+        {
+            for (unsigned int index = 0U; index < run_size; ++index)
+            {
+                bytes.push_back(static_cast<char>(generator() % 16U));
+            }
+        }
+        else
+        {
+            const std::size_t distance = 1U + generator() % std::min<std::size_t>(bytes.size(), 8192U);
+            for (unsigned int index = 0U; index < run_size; ++index)
+            {
+                bytes.push_back(bytes[bytes.size() - distance]);
+            }
+        }
+    }
+    return bytes;
+}
+
+// Checks that `lzf_validate` accepts exactly the data `lzf_decompress` decodes to `output_size` bytes, and that both decode it alike.
+static void require_same_decoding(const std::vector<char>& compressed, const unsigned int output_size)
+{
+    std::vector<char> expected_output(output_size);
+    const unsigned int expected_size = lzf_decompress(compressed.data(), static_cast<unsigned int>(compressed.size()), expected_output.data(), output_size);
+    // A zero return value reports an error, so no data decodes to an empty output.
+    const bool expected_valid = output_size != 0U && expected_size == output_size;
+    REQUIRE(lzf_validate(compressed.data(), compressed.size(), output_size) == expected_valid);
+    if (!expected_valid)
+    {
+        return;
+    }
+
+    for (const unsigned long long output_capacity : { static_cast<unsigned long long>(output_size), output_size + KRA_IMP_LZF_OUTPUT_SLACK })
+    {
+        std::vector<char> output(output_capacity);
+        lzf_decode_validated(compressed.data(), compressed.size(), output.data(), output_size, output_capacity);
+        output.resize(output_size);
+        REQUIRE(output == expected_output);
+    }
+}
+
+static std::vector<char> compress_bytes(const std::vector<char>& bytes)
+{
+    // lzf_compress hashes the first two bytes before checking the input size, so a 1-byte input needs a padding byte.
+    std::vector<char> padded_bytes(bytes);
+    padded_bytes.resize(bytes.size() + 1U);
+    std::vector<char> compressed(bytes.size() + bytes.size() / 16U + 64U);
+    const unsigned int compressed_size =
+        lzf_compress(padded_bytes.data(), static_cast<unsigned int>(bytes.size()), compressed.data(), static_cast<unsigned int>(compressed.size()));
+    compressed.resize(compressed_size);
+    return compressed;
+}
+
+TEST_CASE("lzf_decode_validated matches lzf_decompress", "[lzf_decoder]")
+{
+    std::minstd_rand generator(15U);
+    for (const unsigned int size : { 1U, 2U, 3U, 7U, 31U, 32U, 33U, 100U, 1000U, 4096U, 16384U, 65536U })
+    {
+        const std::vector<char> bytes = make_compressible_bytes(generator, size);
+        const std::vector<char> compressed = compress_bytes(bytes);
+        REQUIRE(!compressed.empty());
+        require_same_decoding(compressed, size);
+        require_same_decoding(compressed, size - 1U);
+        require_same_decoding(compressed, size + 1U);
+    }
+}
+
+TEST_CASE("lzf_validate rejects truncated data like lzf_decompress", "[lzf_decoder]")
+{
+    std::minstd_rand generator(16U);
+    for (const unsigned int size : { 64U, 1000U, 4096U })
+    {
+        const std::vector<char> compressed = compress_bytes(make_compressible_bytes(generator, size));
+        for (std::size_t truncated_size = 1U; truncated_size < compressed.size(); ++truncated_size)
+        {
+            const std::vector<char> truncated(compressed.begin(), compressed.begin() + truncated_size);
+            require_same_decoding(truncated, size);
+        }
+    }
+}
+
+TEST_CASE("lzf_validate rejects corrupted data like lzf_decompress", "[lzf_decoder]")
+{
+    std::minstd_rand generator(17U);
+    for (const unsigned int size : { 64U, 1000U, 4096U, 16384U })
+    {
+        const std::vector<char> compressed = compress_bytes(make_compressible_bytes(generator, size));
+        for (unsigned int corruption_index = 0U; corruption_index < 200U; ++corruption_index)
+        {
+            std::vector<char> corrupted = compressed;
+            const unsigned int corrupted_bytes_count = 1U + static_cast<unsigned int>(generator() % 3U);
+            for (unsigned int byte_index = 0U; byte_index < corrupted_bytes_count; ++byte_index)
+            {
+                corrupted[generator() % corrupted.size()] = static_cast<char>(generator() & 0xFFU);
+            }
+            require_same_decoding(corrupted, size);
+        }
+    }
+}
@@ -141,6 +141,7 @@ TEST_CASE("kra_imp_read_main_doc success", "[main_doc]")
     REQUIRE(main_doc._height == 128U);
     REQUIRE(std::strcmp(main_doc._image_name, "Example") == 0);
     REQUIRE(main_doc._color_space_model == KRA_IMP_RGBA_COLOR_SPACE_MODEL);
+    REQUIRE(main_doc._channel_depth == KRA_IMP_U8_CHANNEL_DEPTH);
     REQUIRE(main_doc._layers_count == 0U);
     const kra_imp_animation_t& animation = main_doc._animation;
     REQUIRE(animation._frame_rate == 0U);
@@ -157,6 +158,7 @@ TEST_CASE("kra_imp_read_main_doc with a layer", "[main_doc]")
     REQUIRE(main_doc._height == 128U);
     REQUIRE(std::strcmp(main_doc._image_name, "Example") == 0);
     REQUIRE(main_doc._color_space_model == KRA_IMP_YCBCR_COLOR_SPACE_MODEL);
+    REQUIRE(main_doc._channel_depth == KRA_IMP_U16_CHANNEL_DEPTH);
     REQUIRE(main_doc._layers_count == 1U);
     const kra_imp_animation_t& animation = main_doc._animation;
     REQUIRE(animation._frame_rate == 0U);
@@ -173,6 +175,7 @@ TEST_CASE("kra_imp_read_main_doc invalid image's space model", "[main_doc]")
     REQUIRE(main_doc._height == 128U);
     REQUIRE(std::strcmp(main_doc._image_name, "Example") == 0);
     REQUIRE(main_doc._color_space_model == KRA_IMP_UNKNOWN_COLOR_SPACE_MODEL);
+    REQUIRE(main_doc._channel_depth == KRA_IMP_UNKNOWN_CHANNEL_DEPTH);
     REQUIRE(main_doc._layers_count == 1U);
     const kra_imp_animation_t& animation = main_doc._animation;
     REQUIRE(animation._frame_rate == 0U);
@@ -189,6 +192,7 @@ TEST_CASE("kra_imp_read_main_doc animation", "[main_doc]")
     REQUIRE(main_doc._height == 64U);
     REQUIRE(std::strcmp(main_doc._image_name, "animation") == 0);
     REQUIRE(main_doc._color_space_model == KRA_IMP_RGBA_COLOR_SPACE_MODEL);
+    REQUIRE(main_doc._channel_depth == KRA_IMP_U8_CHANNEL_DEPTH);
     REQUIRE(main_doc._layers_count == 2U);
     const kra_imp_animation_t& animation = main_doc._animation;
     REQUIRE(animation._frame_rate == 24U);
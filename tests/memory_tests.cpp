@@ -0,0 +1,381 @@
+/**
+ * kraimp - kra file import library
+ * --------------------------------------------------------
+ * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
+ * This library is distributed under the MIT License.
+ */
+#include "zip_memory.h"
+#include <algorithm>
+#include <array>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <kra_imp/kra_imp.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(KRA_IMP_ZIP_MEMORY_FUNCTIONS)
+#    include <zip.h>
+#endif
+
+constexpr const std::string_view MEMORY_MAIN_DOC_XML = R"(
+	<?xml version="1.0" encoding="UTF-8"?>
+	<DOC xmlns="http://www.calligra.org/DTD/krita" kritaVersion="5.0.0" syntaxVersion="2.0" editor="Krita">
+	 <IMAGE name="Example" colorspacename="RGBA" mime="application/x-kra" width="128" height="64">
+	  <layers>
+	   <layer name="background" nodetype="paintlayer" visible="1" opacity="255" filename="layer1"/>
+	   <layer name="top" nodetype="paintlayer" visible="1" opacity="64" filename="layer2"/>
+	  </layers>
+	 </IMAGE>
+	</DOC>
+	)";
+
+struct counting_allocator_t
+{
+    unsigned int _allocations_count{ 0U };
+    unsigned int _deallocations_count{ 0U };
+};
+
+static counting_allocator_t* plain_allocator{ nullptr };
+
+static void* counting_allocate(void* context, size_t size)
+{
+    ++static_cast<counting_allocator_t*>(context)->_allocations_count;
+    return std::malloc(size);
+}
+
+static void counting_deallocate(void* context, void* ptr)
+{
+    ++static_cast<counting_allocator_t*>(context)->_deallocations_count;
+    std::free(ptr);
+}
+
+static void* plain_counting_allocate(size_t size)
+{
+    return counting_allocate(plain_allocator, size);
+}
+
+static void plain_counting_deallocate(void* ptr)
+{
+    counting_deallocate(plain_allocator, ptr);
+}
+
+static kra_imp_error_code_e ignore_tile(void*, const kra_imp_layer_data_header_t*, const kra_imp_layer_data_tile_t*)
+{
+    return KRA_IMP_SUCCESS;
+}
+
+TEST_CASE("kra_imp_set_memory_functions_with_context routes document allocations", "[memory]")
+{
+    counting_allocator_t allocator;
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    kra_imp_document_t* document = kra_imp_open_document(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    REQUIRE(kra_imp_get_document_layers_count(document) == 2U);
+    REQUIRE(allocator._allocations_count > 0U);
+    kra_imp_close_document(document);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(allocator._allocations_count == allocator._deallocations_count);
+}
+
+TEST_CASE("kra_imp_set_memory_functions_with_context routes stream allocations", "[memory]")
+{
+    counting_allocator_t allocator;
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(ignore_tile, nullptr);
+    REQUIRE(stream != nullptr);
+    REQUIRE(allocator._allocations_count == 1U);
+    kra_imp_close_layer_data_stream(stream);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(allocator._deallocations_count == 1U);
+}
+
+TEST_CASE("kra_imp_set_memory_functions routes document allocations", "[memory]")
+{
+    counting_allocator_t allocator;
+    plain_allocator = &allocator;
+    kra_imp_set_memory_functions(plain_counting_allocate, plain_counting_deallocate);
+    kra_imp_document_t* document = kra_imp_open_document(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    kra_imp_close_document(document);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    plain_allocator = nullptr;
+    REQUIRE(allocator._allocations_count > 0U);
+    REQUIRE(allocator._allocations_count == allocator._deallocations_count);
+}
+
+TEST_CASE("kra_imp_set_memory_functions null restores defaults", "[memory]")
+{
+    counting_allocator_t allocator;
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    kra_imp_document_t* document = kra_imp_open_document(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    kra_imp_close_document(document);
+    REQUIRE(allocator._allocations_count == 0U);
+}
+
+TEST_CASE("kra_imp_set_scratch_buffer serves one-shot xml parsing", "[memory]")
+{
+    counting_allocator_t allocator;
+    std::vector<char> scratch_buffer(256 * 1024);
+    std::array<kra_imp_image_layer_node_t, 2> layer_nodes{};
+    kra_imp_main_doc_t main_doc;
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    kra_imp_set_scratch_buffer(scratch_buffer.data(), scratch_buffer.size());
+    for (unsigned int call_index = 0U; call_index < 3U; ++call_index)
+    {
+        REQUIRE(kra_imp_read_main_doc(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size(), &main_doc) == KRA_IMP_SUCCESS);
+        REQUIRE(kra_imp_read_image_layers(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size(), layer_nodes.data(), layer_nodes.size()) == KRA_IMP_SUCCESS);
+    }
+    kra_imp_set_scratch_buffer(nullptr, 0ULL);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(main_doc._layers_count == 2U);
+    REQUIRE(std::strcmp(layer_nodes[1]._layer._name, "top") == 0);
+    REQUIRE(allocator._allocations_count == 0U);
+}
+
+TEST_CASE("kra_imp_set_scratch_buffer falls back when exhausted", "[memory]")
+{
+    counting_allocator_t allocator;
+    std::array<char, 16> scratch_buffer{};
+    std::array<kra_imp_image_layer_node_t, 2> layer_nodes{};
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    kra_imp_set_scratch_buffer(scratch_buffer.data(), scratch_buffer.size());
+    REQUIRE(kra_imp_read_image_layers(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size(), layer_nodes.data(), layer_nodes.size()) == KRA_IMP_SUCCESS);
+    kra_imp_set_scratch_buffer(nullptr, 0ULL);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(std::strcmp(layer_nodes[0]._layer._name, "background") == 0);
+    REQUIRE(allocator._allocations_count == allocator._deallocations_count);
+}
+
+TEST_CASE("kra_imp_set_scratch_buffer is not used by documents", "[memory]")
+{
+    counting_allocator_t allocator;
+    std::vector<char> scratch_buffer(256 * 1024);
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    kra_imp_set_scratch_buffer(scratch_buffer.data(), scratch_buffer.size());
+    kra_imp_document_t* document = kra_imp_open_document(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size());
+    REQUIRE(document != nullptr);
+    REQUIRE(allocator._allocations_count > 0U);
+    kra_imp_close_document(document);
+    kra_imp_set_scratch_buffer(nullptr, 0ULL);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(allocator._allocations_count == allocator._deallocations_count);
+}
+
+struct failing_allocator_t
+{
+    unsigned int _allocations_left{ 0U };
+    unsigned int _allocations_count{ 0U };
+    unsigned int _deallocations_count{ 0U };
+};
+
+static void* failing_allocate(void* context, size_t size)
+{
+    failing_allocator_t& allocator = *static_cast<failing_allocator_t*>(context);
+    if (allocator._allocations_left == 0U)
+    {
+        return nullptr;
+    }
+
+    --allocator._allocations_left;
+    ++allocator._allocations_count;
+    return std::malloc(size);
+}
+
+static void failing_deallocate(void* context, void* ptr)
+{
+    ++static_cast<failing_allocator_t*>(context)->_deallocations_count;
+    std::free(ptr);
+}
+
+static void run_task_inline(void*, kra_imp_task_function task_function, void* task_data)
+{
+    task_function(task_data);
+}
+
+static void wait_inline_tasks(void*)
+{
+}
+
+// Uncompressed 64x64 RGBA tiles laid out in a row, large enough to be indexed by several tasks.
+static std::vector<char> make_uncompressed_layer_data(const unsigned int tiles_count)
+{
+    static constexpr unsigned int TILE_SIZE{ 64U * 64U * 4U };
+    std::vector<char> layer_data;
+    for (unsigned int tile_index = 0U; tile_index < tiles_count; ++tile_index)
+    {
+        const std::string tile_line = std::to_string(tile_index * 64U) + ",0,LZF," + std::to_string(TILE_SIZE + 1U) + "\n";
+        layer_data.insert(layer_data.end(), tile_line.begin(), tile_line.end());
+        layer_data.push_back(static_cast<char>(KRA_IMP_UNCOMPRESSED_TILE));
+        layer_data.insert(layer_data.end(), TILE_SIZE, static_cast<char>(tile_index));
+    }
+    return layer_data;
+}
+
+// Calls `function` with allocations failing after 0, 1, 2... successful ones, until it succeeds.
+template <typename Function> static void run_with_failing_allocations(Function&& function)
+{
+    static constexpr unsigned int MAX_ALLOCATIONS_COUNT{ 512U };
+    bool succeeded = false;
+    for (unsigned int allocations_count = 0U; allocations_count < MAX_ALLOCATIONS_COUNT && !succeeded; ++allocations_count)
+    {
+        failing_allocator_t allocator;
+        allocator._allocations_left = allocations_count;
+        kra_imp_set_memory_functions_with_context(failing_allocate, failing_deallocate, &allocator);
+        succeeded = function();
+        kra_imp_set_memory_functions(nullptr, nullptr);
+        REQUIRE(allocator._allocations_count == allocator._deallocations_count);
+    }
+    REQUIRE(succeeded);
+}
+
+TEST_CASE("kra_imp_open_document failing allocations", "[memory]")
+{
+    run_with_failing_allocations(
+        []()
+        {
+            kra_imp_document_t* document = kra_imp_open_document(MEMORY_MAIN_DOC_XML.data(), MEMORY_MAIN_DOC_XML.size());
+            const bool opened = document != nullptr;
+            kra_imp_close_document(document);
+            return opened;
+        });
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream failing allocations", "[memory]")
+{
+    const std::string_view header = "VERSION 2\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 2\n";
+    std::vector<char> layer_data(header.begin(), header.end());
+    const std::vector<char> tiles_data = make_uncompressed_layer_data(2U);
+    layer_data.insert(layer_data.end(), tiles_data.begin(), tiles_data.end());
+    run_with_failing_allocations(
+        [&layer_data]()
+        {
+            kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(ignore_tile, nullptr);
+            if (stream == nullptr)
+            {
+                return false;
+            }
+
+            // Small chunks split every record, so each of them goes through the pending record buffer.
+            static constexpr unsigned long long CHUNK_SIZE{ 1000ULL };
+            kra_imp_error_code_e result = KRA_IMP_SUCCESS;
+            for (unsigned long long position = 0ULL; position < layer_data.size() && result == KRA_IMP_SUCCESS; position += CHUNK_SIZE)
+            {
+                result = kra_imp_read_layer_data_stream(stream, layer_data.data() + position, std::min<unsigned long long>(CHUNK_SIZE, layer_data.size() - position));
+                REQUIRE((result == KRA_IMP_SUCCESS || result == KRA_IMP_FAIL));
+            }
+            return kra_imp_close_layer_data_stream(stream) == KRA_IMP_SUCCESS && result == KRA_IMP_SUCCESS;
+        });
+}
+
+TEST_CASE("kra_imp_index_layer_data_parallel failing allocations", "[memory]")
+{
+    static constexpr unsigned int TILES_COUNT{ 40U };
+    const std::vector<char> layer_data = make_uncompressed_layer_data(TILES_COUNT);
+    const kra_imp_executor_t executor{ run_task_inline, wait_inline_tasks, nullptr, 4U };
+    run_with_failing_allocations(
+        [&]()
+        {
+            std::vector<kra_imp_layer_data_tile_t> tiles(TILES_COUNT);
+            const kra_imp_error_code_e result = kra_imp_index_layer_data_parallel(layer_data.data(), layer_data.size(), tiles.data(), TILES_COUNT, &executor);
+            REQUIRE((result == KRA_IMP_SUCCESS || result == KRA_IMP_FAIL));
+            return result == KRA_IMP_SUCCESS && tiles[TILES_COUNT - 1U]._x_offset == static_cast<int>((TILES_COUNT - 1U) * 64U);
+        });
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_sparse_canvas failing allocations", "[memory]")
+{
+    // More tiles than fit a single page of the sparse canvas.
+    static constexpr unsigned int TILES_COUNT{ 70U };
+    const std::vector<char> layer_data = make_uncompressed_layer_data(TILES_COUNT);
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, TILES_COUNT, 4U, 64U, 64U, 2U };
+    run_with_failing_allocations(
+        [&]()
+        {
+            kra_imp_sparse_canvas_t* sparse_canvas = kra_imp_open_sparse_canvas(&layer_data_header);
+            if (sparse_canvas == nullptr)
+            {
+                return false;
+            }
+
+            const kra_imp_error_code_e result = kra_imp_read_layer_data_to_sparse_canvas(layer_data.data(), layer_data.size(), &layer_data_header, sparse_canvas);
+            REQUIRE((result == KRA_IMP_SUCCESS || result == KRA_IMP_FAIL));
+            const bool read = result == KRA_IMP_SUCCESS && kra_imp_get_sparse_canvas_tiles_count(sparse_canvas) == TILES_COUNT;
+            kra_imp_close_sparse_canvas(sparse_canvas);
+            return read;
+        });
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_canvas_converted failing allocations", "[memory]")
+{
+    static constexpr unsigned int TILES_COUNT{ 2U };
+    const std::vector<char> layer_data = make_uncompressed_layer_data(TILES_COUNT);
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, TILES_COUNT, 4U, 64U, 64U, 2U };
+    const kra_imp_color_conversion_t color_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    std::vector<char> canvas_buffer(128U * 64U * 4U);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 128U, 64U };
+    run_with_failing_allocations(
+        [&]()
+        {
+            const kra_imp_error_code_e result =
+                kra_imp_read_layer_data_to_canvas_converted(layer_data.data(), layer_data.size(), &layer_data_header, &color_conversion, &canvas);
+            REQUIRE((result == KRA_IMP_SUCCESS || result == KRA_IMP_FAIL));
+            return result == KRA_IMP_SUCCESS;
+        });
+    REQUIRE(canvas_buffer[0] == 0);
+    REQUIRE(canvas_buffer[64U * 4U] == 1);
+}
+
+// An archive without entries: only the end of central directory record.
+constexpr const std::array<char, 22> EMPTY_ZIP_ARCHIVE{ 0x50, 0x4B, 0x05, 0x06 };
+
+TEST_CASE("kra_imp_zip_realloc keeps contents and routes to memory functions", "[memory]")
+{
+    counting_allocator_t allocator;
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    char* memory = static_cast<char*>(kra_imp_zip_malloc(10U));
+    REQUIRE(memory != nullptr);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(memory) % alignof(std::max_align_t) == 0U);
+    std::memcpy(memory, "0123456789", 10U);
+    memory = static_cast<char*>(kra_imp_zip_realloc(memory, 1000U));
+    REQUIRE(memory != nullptr);
+    REQUIRE(std::memcmp(memory, "0123456789", 10U) == 0);
+    memory = static_cast<char*>(kra_imp_zip_realloc(memory, 4U));
+    REQUIRE(memory != nullptr);
+    REQUIRE(std::memcmp(memory, "0123", 4U) == 0);
+    kra_imp_zip_free(memory);
+    kra_imp_zip_free(nullptr);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(allocator._allocations_count == 3U);
+    REQUIRE(allocator._deallocations_count == 3U);
+}
+
+TEST_CASE("kra_imp_open_archive failing allocations", "[memory]")
+{
+    run_with_failing_allocations(
+        []()
+        {
+            kra_imp_archive_t* archive = kra_imp_open_archive(EMPTY_ZIP_ARCHIVE.data(), EMPTY_ZIP_ARCHIVE.size());
+            const bool opened = archive != nullptr;
+            kra_imp_close_archive(archive);
+            return opened;
+        });
+}
+
+#if defined(KRA_IMP_ZIP_MEMORY_FUNCTIONS)
+TEST_CASE("kra_imp_set_memory_functions_with_context routes zip reader allocations", "[memory]")
+{
+    counting_allocator_t allocator;
+    kra_imp_set_memory_functions_with_context(counting_allocate, counting_deallocate, &allocator);
+    zip_t* zip_archive = zip_stream_open(EMPTY_ZIP_ARCHIVE.data(), EMPTY_ZIP_ARCHIVE.size(), 0, 'r');
+    REQUIRE(zip_archive != nullptr);
+    REQUIRE(allocator._allocations_count > 0U);
+    zip_stream_close(zip_archive);
+    kra_imp_set_memory_functions(nullptr, nullptr);
+    REQUIRE(allocator._allocations_count == allocator._deallocations_count);
+}
+#endif
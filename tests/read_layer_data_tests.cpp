@@ -4,9 +4,15 @@
  * Copyright (C) 2024, by Marek Daniluk (@GypsyMagic)
  * This library is distributed under the MIT License.
  */
+#include <algorithm>
 #include <array>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <cstring>
 #include <kra_imp/kra_imp.hpp>
+#include <string>
+#include <utility>
+#include <vector>
 
 constexpr const std::array<unsigned char, 1237> VALID_LAYER_DATA = {
     0x31, 0x32, 0x38, 0x2C, 0x30, 0x2C, 0x4C, 0x5A, 0x46, 0x2C, 0x34, 0x36, 0x38, 0x0A, 0x01, 0x00, 0x00, 0xE0, 0xF9, 0x00, 0xE0, 0xF9, 0x00, 0xE0, 0xF9, 0x00, 0xE0, 0xF9, 0x00,
@@ -189,7 +195,7 @@ TEST_CASE("kra_imp_read_layer_data_tile invalid layer data", "[layer_data_tile]"
     int x_offset, y_offset;
     const kra_imp_error_code_e result = kra_imp_read_layer_data_tile(reinterpret_cast<const char*>(INVALID_COMPRESS_FLAG_DATA.data()), INVALID_COMPRESS_FLAG_DATA.size(), 0U,
                                                                      output_buffer.data(), output_buffer.size(), &x_offset, &y_offset);
-    REQUIRE(result == KRA_IMP_DECOMPRESS_ERROR);
+    REQUIRE(result == KRA_IMP_PARSE_ERROR);
 }
 
 TEST_CASE("kra_imp_read_layer_data_tile invalid layer compressed data", "[layer_data_tile]")
@@ -290,7 +296,7 @@ TEST_CASE("kra_imp_read_layer_data invalid layer data", "[layer_data]")
     output_data._buffer_size = output_buffer.size();
     const kra_imp_error_code_e result =
         kra_imp_read_layer_data(reinterpret_cast<const char*>(INVALID_COMPRESS_FLAG_DATA.data()), INVALID_COMPRESS_FLAG_DATA.size(), 0U, &output_data);
-    REQUIRE(result == KRA_IMP_DECOMPRESS_ERROR);
+    REQUIRE(result == KRA_IMP_PARSE_ERROR);
 }
 
 TEST_CASE("kra_imp_read_layer_data invalid layer compressed data", "[layer_data]")
@@ -303,3 +309,1160 @@ TEST_CASE("kra_imp_read_layer_data invalid layer compressed data", "[layer_data]
         kra_imp_read_layer_data(reinterpret_cast<const char*>(INVALID_COMPRESSED_LAYER_DATA.data()), INVALID_COMPRESSED_LAYER_DATA.size(), 0U, &output_data);
     REQUIRE(result == KRA_IMP_DECOMPRESS_ERROR);
 }
+
+TEST_CASE("kra_imp_index_layer_data success", "[index_layer_data]")
+{
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    const kra_imp_error_code_e result = kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size());
+    REQUIRE(result == KRA_IMP_SUCCESS);
+    REQUIRE(tiles[0]._x_offset == 128);
+    REQUIRE(tiles[0]._y_offset == 0);
+    REQUIRE(tiles[0]._compression == KRA_IMP_LZF_COMPRESSED_TILE);
+    REQUIRE(tiles[0]._data_size == 467U);
+    REQUIRE(tiles[1]._x_offset == 128);
+    REQUIRE(tiles[1]._y_offset == 64);
+    REQUIRE(tiles[1]._compression == KRA_IMP_LZF_COMPRESSED_TILE);
+    REQUIRE(tiles[1]._data_size == 446U);
+}
+
+TEST_CASE("kra_imp_index_layer_data null input buffer", "[index_layer_data]")
+{
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    const kra_imp_error_code_e result = kra_imp_index_layer_data(nullptr, 0ULL, tiles.data(), tiles.size());
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_index_layer_data null tiles", "[index_layer_data]")
+{
+    const kra_imp_error_code_e result = kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), nullptr, 2U);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_index_layer_data too many tiles", "[index_layer_data]")
+{
+    std::array<kra_imp_layer_data_tile_t, 3> tiles{};
+    const kra_imp_error_code_e result = kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size());
+    REQUIRE(result == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data matches kra_imp_read_layer_data", "[index_layer_data]")
+{
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    REQUIRE(kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size()) == KRA_IMP_SUCCESS);
+    for (unsigned int tile_index = 0U; tile_index < tiles.size(); ++tile_index)
+    {
+        std::array<char, 64 * 64 * 4> indexed_buffer{};
+        kra_imp_layer_output_data_t indexed_output{};
+        indexed_output._buffer = indexed_buffer.data();
+        indexed_output._buffer_size = indexed_buffer.size();
+        REQUIRE(kra_imp_read_indexed_layer_data(&tiles[tile_index], &indexed_output) == KRA_IMP_SUCCESS);
+
+        std::array<char, 64 * 64 * 4> expected_buffer{};
+        kra_imp_layer_output_data_t expected_output{};
+        expected_output._buffer = expected_buffer.data();
+        expected_output._buffer_size = expected_buffer.size();
+        REQUIRE(kra_imp_read_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tile_index, &expected_output) == KRA_IMP_SUCCESS);
+        REQUIRE(indexed_output._x_offset == expected_output._x_offset);
+        REQUIRE(indexed_output._y_offset == expected_output._y_offset);
+        REQUIRE(indexed_buffer == expected_buffer);
+    }
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data null tile", "[index_layer_data]")
+{
+    std::array<char, 64 * 64 * 4> output_buffer;
+    kra_imp_layer_output_data_t output_data{};
+    output_data._buffer = output_buffer.data();
+    output_data._buffer_size = output_buffer.size();
+    const kra_imp_error_code_e result = kra_imp_read_indexed_layer_data(nullptr, &output_data);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data invalid compressed data", "[index_layer_data]")
+{
+    std::array<kra_imp_layer_data_tile_t, 1> tiles{};
+    REQUIRE(kra_imp_index_layer_data(reinterpret_cast<const char*>(INVALID_COMPRESSED_LAYER_DATA.data()), INVALID_COMPRESSED_LAYER_DATA.size(), tiles.data(), tiles.size()) ==
+            KRA_IMP_SUCCESS);
+    std::array<char, 64 * 64 * 4> output_buffer;
+    kra_imp_layer_output_data_t output_data{};
+    output_data._buffer = output_buffer.data();
+    output_data._buffer_size = output_buffer.size();
+    const kra_imp_error_code_e result = kra_imp_read_indexed_layer_data(&tiles[0], &output_data);
+    REQUIRE(result == KRA_IMP_DECOMPRESS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas success", "[layer_data_atlas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<char, 2 * 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_atlas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &atlas);
+    REQUIRE(result == KRA_IMP_SUCCESS);
+    REQUIRE(offsets[0]._x_offset == 128);
+    REQUIRE(offsets[0]._y_offset == 0);
+    REQUIRE(offsets[1]._x_offset == 128);
+    REQUIRE(offsets[1]._y_offset == 64);
+
+    std::array<char, 64 * 64 * 4> expected_buffer{};
+    kra_imp_layer_output_data_t expected_output{};
+    expected_output._buffer = expected_buffer.data();
+    expected_output._buffer_size = expected_buffer.size();
+    REQUIRE(kra_imp_read_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), 1U, &expected_output) == KRA_IMP_SUCCESS);
+    REQUIRE(std::memcmp(atlas_buffer.data() + expected_buffer.size(), expected_buffer.data(), expected_buffer.size()) == 0);
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas null header", "[layer_data_atlas]")
+{
+    std::array<char, 2 * 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    const kra_imp_error_code_e result = kra_imp_read_layer_data_atlas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), nullptr, &atlas);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas too small atlas", "[layer_data_atlas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<char, 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_atlas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &atlas);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas invalid layer compressed data", "[layer_data_atlas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, 4U, 64U, 64U, 2U };
+    std::array<char, 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 1> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_atlas(reinterpret_cast<const char*>(INVALID_COMPRESSED_LAYER_DATA.data()), INVALID_COMPRESSED_LAYER_DATA.size(), &layer_data_header, &atlas);
+    REQUIRE(result == KRA_IMP_DECOMPRESS_ERROR);
+}
+
+struct deferred_executor_t
+{
+    std::array<std::pair<kra_imp_task_function, void*>, 256> _tasks{};
+    unsigned int _tasks_count{ 0U };
+};
+
+static void deferred_submit(void* executor_context, kra_imp_task_function task, void* task_data)
+{
+    deferred_executor_t* executor = static_cast<deferred_executor_t*>(executor_context);
+    executor->_tasks[executor->_tasks_count++] = { task, task_data };
+}
+
+static void deferred_wait(void* executor_context)
+{
+    deferred_executor_t* executor = static_cast<deferred_executor_t*>(executor_context);
+    for (unsigned int task_index = executor->_tasks_count; task_index > 0U; --task_index)
+    {
+        executor->_tasks[task_index - 1U].first(executor->_tasks[task_index - 1U].second);
+    }
+    executor->_tasks_count = 0U;
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas_parallel success", "[layer_data_atlas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<char, 2 * 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    deferred_executor_t deferred_executor;
+    const kra_imp_executor_t executor{ deferred_submit, deferred_wait, &deferred_executor, 2U };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_atlas_parallel(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &atlas, &executor);
+    REQUIRE(result == KRA_IMP_SUCCESS);
+    REQUIRE(offsets[0]._x_offset == 128);
+    REQUIRE(offsets[0]._y_offset == 0);
+    REQUIRE(offsets[1]._x_offset == 128);
+    REQUIRE(offsets[1]._y_offset == 64);
+
+    std::array<char, 2 * 64 * 64 * 4> expected_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> expected_offsets{};
+    kra_imp_layer_data_atlas_t expected_atlas{ expected_buffer.data(), expected_buffer.size(), expected_offsets.data(), static_cast<unsigned int>(expected_offsets.size()) };
+    REQUIRE(kra_imp_read_layer_data_atlas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &expected_atlas) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(atlas_buffer == expected_buffer);
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas_parallel huge workers count", "[layer_data_atlas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<char, 2 * 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    deferred_executor_t deferred_executor;
+    // Multiplied by the tasks per worker, this count wraps around to zero in 32 bits.
+    const kra_imp_executor_t executor{ deferred_submit, deferred_wait, &deferred_executor, 0x40000000U };
+    REQUIRE(kra_imp_read_layer_data_atlas_parallel(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &atlas,
+                                                   &executor) == KRA_IMP_SUCCESS);
+
+    std::array<char, 2 * 64 * 64 * 4> expected_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> expected_offsets{};
+    kra_imp_layer_data_atlas_t expected_atlas{ expected_buffer.data(), expected_buffer.size(), expected_offsets.data(), static_cast<unsigned int>(expected_offsets.size()) };
+    REQUIRE(kra_imp_read_layer_data_atlas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &expected_atlas) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(atlas_buffer == expected_buffer);
+    REQUIRE(offsets[1]._y_offset == 64);
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas_parallel null executor", "[layer_data_atlas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<char, 2 * 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 2> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_atlas_parallel(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &atlas, nullptr);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_atlas_parallel invalid layer compressed data", "[layer_data_atlas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, 4U, 64U, 64U, 2U };
+    std::array<char, 64 * 64 * 4> atlas_buffer{};
+    std::array<kra_imp_tile_offset_t, 1> offsets{};
+    kra_imp_layer_data_atlas_t atlas{ atlas_buffer.data(), atlas_buffer.size(), offsets.data(), static_cast<unsigned int>(offsets.size()) };
+    deferred_executor_t deferred_executor;
+    const kra_imp_executor_t executor{ deferred_submit, deferred_wait, &deferred_executor, 4U };
+    const kra_imp_error_code_e result = kra_imp_read_layer_data_atlas_parallel(reinterpret_cast<const char*>(INVALID_COMPRESSED_LAYER_DATA.data()),
+                                                                               INVALID_COMPRESSED_LAYER_DATA.size(), &layer_data_header, &atlas, &executor);
+    REQUIRE(result == KRA_IMP_DECOMPRESS_ERROR);
+}
+
+static std::vector<char> read_expected_canvas(const unsigned int canvas_width, const unsigned int canvas_height)
+{
+    // Reference built from the separate read and delinearize steps on a canvas big enough to hold both tiles.
+    static constexpr unsigned int full_width = 192;
+    static constexpr unsigned int full_height = 128;
+    std::vector<char> full_canvas(full_width * full_height * 4);
+    for (unsigned int tile_index = 0U; tile_index < 2U; ++tile_index)
+    {
+        std::array<char, 64 * 64 * 4> tile_buffer{};
+        kra_imp_layer_output_data_t output_data{ tile_buffer.data(), tile_buffer.size(), 0, 0 };
+        REQUIRE(kra_imp_read_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tile_index, &output_data) == KRA_IMP_SUCCESS);
+        kra_imp_delinerize_output_t output{ full_canvas.data(), full_canvas.size(), (output_data._y_offset * full_width + output_data._x_offset) * 4ULL, full_width };
+        REQUIRE(kra_imp_delinearize_with_offset(tile_buffer.data(), tile_buffer.size(), 64U, &output) == KRA_IMP_SUCCESS);
+    }
+
+    std::vector<char> canvas(canvas_width * canvas_height * 4);
+    for (unsigned int y = 0U; y < canvas_height; ++y)
+    {
+        std::memcpy(canvas.data() + y * canvas_width * 4, full_canvas.data() + y * full_width * 4, canvas_width * 4);
+    }
+    return canvas;
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_canvas success", "[layer_data_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::vector<char> canvas_buffer(192 * 128 * 4);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 192U, 128U };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_to_canvas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &canvas);
+    REQUIRE(result == KRA_IMP_SUCCESS);
+    REQUIRE(canvas_buffer == read_expected_canvas(192U, 128U));
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_canvas clipped", "[layer_data_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::vector<char> canvas_buffer(150 * 100 * 4);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 150U, 100U };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_to_canvas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &canvas);
+    REQUIRE(result == KRA_IMP_SUCCESS);
+    REQUIRE(canvas_buffer == read_expected_canvas(150U, 100U));
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data_to_canvas negative offset", "[layer_data_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    REQUIRE(kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size()) == KRA_IMP_SUCCESS);
+    tiles[1]._x_offset = -10;
+    tiles[1]._y_offset = -20;
+    std::vector<char> canvas_buffer(64 * 64 * 4);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 64U, 64U };
+    REQUIRE(kra_imp_read_indexed_layer_data_to_canvas(&tiles[1], &layer_data_header, &canvas) == KRA_IMP_SUCCESS);
+
+    const std::vector<char> expected_canvas = read_expected_canvas(192U, 128U);
+    for (unsigned int y = 0U; y < 44U; ++y)
+    {
+        REQUIRE(std::memcmp(canvas_buffer.data() + y * 64 * 4, expected_canvas.data() + ((y + 84) * 192 + 138) * 4, 54 * 4) == 0);
+    }
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_canvas too small canvas buffer", "[layer_data_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::vector<char> canvas_buffer(64 * 64 * 4);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 192U, 128U };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_to_canvas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &canvas);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_canvas unsupported pixel size", "[layer_data_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 8U, 64U, 64U, 2U };
+    std::vector<char> canvas_buffer(192 * 128 * 4);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 192U, 128U };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_to_canvas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &canvas);
+    REQUIRE(result == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_canvas_converted matches bgra canvas", "[layer_data_canvas_converted]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::vector<char> canvas_buffer(150 * 100 * 4);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 150U, 100U };
+    kra_imp_color_conversion_t color_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    REQUIRE(kra_imp_read_layer_data_to_canvas_converted(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header,
+                                                        &color_conversion, &canvas) == KRA_IMP_SUCCESS);
+    const std::vector<char> expected_canvas = read_expected_canvas(150U, 100U);
+    REQUIRE(canvas_buffer == expected_canvas);
+
+    color_conversion._pixel_order = KRA_IMP_RGBA_PIXEL_ORDER;
+    REQUIRE(kra_imp_read_layer_data_to_canvas_converted(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header,
+                                                        &color_conversion, &canvas) == KRA_IMP_SUCCESS);
+    for (unsigned long long index = 0; index < canvas_buffer.size(); index += 4)
+    {
+        REQUIRE(canvas_buffer[index] == expected_canvas[index + 2]);
+        REQUIRE(canvas_buffer[index + 2] == expected_canvas[index]);
+    }
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data_to_canvas_converted graya u16 tile", "[layer_data_canvas_converted]")
+{
+    const unsigned int tile_width = 64U;
+    const unsigned int pixel_size = 4U;
+    const unsigned int plane_size = tile_width * tile_width;
+    // Krita linearizes 16-bit channels byte by byte: low bytes of gray, high bytes of gray, low bytes of alpha, high bytes of alpha.
+    std::vector<char> tile_data(plane_size * pixel_size);
+    for (unsigned int pixel = 0U; pixel < plane_size; ++pixel)
+    {
+        tile_data[pixel] = static_cast<char>(pixel % 256U);
+        tile_data[plane_size + pixel] = static_cast<char>(pixel % 256U);
+        tile_data[2U * plane_size + pixel] = static_cast<char>(0xFF);
+        tile_data[3U * plane_size + pixel] = static_cast<char>(0xFF);
+    }
+    const kra_imp_layer_data_tile_t tile{ tile_data.data(), static_cast<unsigned int>(tile_data.size()), -1, 0, KRA_IMP_UNCOMPRESSED_TILE };
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, pixel_size, tile_width, tile_width, 2U };
+    std::vector<unsigned char> canvas_buffer(32 * 32 * 4);
+    kra_imp_canvas_t canvas{ reinterpret_cast<char*>(canvas_buffer.data()), canvas_buffer.size(), 32U, 32U };
+    const kra_imp_color_conversion_t color_conversion{ KRA_IMP_GRAYA_COLOR_SPACE_MODEL, KRA_IMP_U16_CHANNEL_DEPTH, KRA_IMP_RGBA_PIXEL_ORDER };
+    REQUIRE(kra_imp_read_indexed_layer_data_to_canvas_converted(&tile, &layer_data_header, &color_conversion, &canvas) == KRA_IMP_SUCCESS);
+    for (unsigned int y = 0U; y < 32U; ++y)
+    {
+        for (unsigned int x = 0U; x < 32U; ++x)
+        {
+            const unsigned char gray = static_cast<unsigned char>((y * tile_width + x + 1U) % 256U);
+            const unsigned char* pixel = canvas_buffer.data() + (y * 32U + x) * 4U;
+            REQUIRE(pixel[0] == gray);
+            REQUIRE(pixel[1] == gray);
+            REQUIRE(pixel[2] == gray);
+            REQUIRE(pixel[3] == 255);
+        }
+    }
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_canvas_converted invalid params", "[layer_data_canvas_converted]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    const kra_imp_layer_data_header_t too_big_tiles_header{ 0U, 2U, 4U, 128U, 128U, 2U };
+    std::vector<char> canvas_buffer(192 * 128 * 4);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 192U, 128U };
+    const kra_imp_color_conversion_t color_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    const kra_imp_color_conversion_t mismatched_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U16_CHANNEL_DEPTH, KRA_IMP_BGRA_PIXEL_ORDER };
+    const kra_imp_color_conversion_t argb_conversion{ KRA_IMP_RGBA_COLOR_SPACE_MODEL, KRA_IMP_U8_CHANNEL_DEPTH, KRA_IMP_ARGB_PIXEL_ORDER };
+    const char* buffer = reinterpret_cast<const char*>(VALID_LAYER_DATA.data());
+    REQUIRE(kra_imp_read_layer_data_to_canvas_converted(buffer, VALID_LAYER_DATA.size(), &layer_data_header, &argb_conversion, &canvas) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_to_canvas_converted(buffer, VALID_LAYER_DATA.size(), &layer_data_header, &mismatched_conversion, &canvas) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_to_canvas_converted(buffer, VALID_LAYER_DATA.size(), &too_big_tiles_header, &color_conversion, &canvas) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_to_canvas_converted(buffer, VALID_LAYER_DATA.size(), &layer_data_header, nullptr, &canvas) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_to_canvas_converted(nullptr, VALID_LAYER_DATA.size(), &layer_data_header, &color_conversion, &canvas) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_indexed_layer_data_to_canvas_converted(nullptr, &layer_data_header, &color_conversion, &canvas) == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_region success", "[layer_data_region]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::vector<char> region_buffer(80 * 60 * 4);
+    kra_imp_canvas_t region{ region_buffer.data(), region_buffer.size(), 80U, 60U };
+    const kra_imp_error_code_e result =
+        kra_imp_read_layer_data_region(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, 100, 50, &region);
+    REQUIRE(result == KRA_IMP_SUCCESS);
+
+    const std::vector<char> expected_canvas = read_expected_canvas(192U, 128U);
+    for (unsigned int y = 0U; y < 60U; ++y)
+    {
+        REQUIRE(std::memcmp(region_buffer.data() + y * 80 * 4, expected_canvas.data() + ((y + 50) * 192 + 100) * 4, 80 * 4) == 0);
+    }
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data_region skips tiles outside of region", "[layer_data_region]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    REQUIRE(kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size()) == KRA_IMP_SUCCESS);
+    static constexpr std::array<char, 4> INVALID_TILE_DATA{ 1, 2, 3, 4 };
+    tiles[0]._data = INVALID_TILE_DATA.data();
+    tiles[0]._data_size = INVALID_TILE_DATA.size();
+    tiles[0]._compression = KRA_IMP_LZF_COMPRESSED_TILE;
+
+    const std::vector<char> expected_canvas = read_expected_canvas(192U, 128U);
+    std::vector<char> region_buffer(32 * 32 * 4);
+    kra_imp_canvas_t region{ region_buffer.data(), region_buffer.size(), 32U, 32U };
+    REQUIRE(kra_imp_read_indexed_layer_data_region(tiles.data(), tiles.size(), &layer_data_header, tiles[1]._x_offset + 16, tiles[1]._y_offset + 16, &region) ==
+            KRA_IMP_SUCCESS);
+    for (unsigned int y = 0U; y < 32U; ++y)
+    {
+        const unsigned int expected_idx = ((tiles[1]._y_offset + 16U + y) * 192U + tiles[1]._x_offset + 16U) * 4U;
+        REQUIRE(std::memcmp(region_buffer.data() + y * 32 * 4, expected_canvas.data() + expected_idx, 32 * 4) == 0);
+    }
+    REQUIRE(kra_imp_read_indexed_layer_data_region(tiles.data(), tiles.size(), &layer_data_header, tiles[0]._x_offset - 16, tiles[0]._y_offset - 16, &region) ==
+            KRA_IMP_DECOMPRESS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_region far away region", "[layer_data_region]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::vector<char> region_buffer(16 * 16 * 4, 7);
+    kra_imp_canvas_t region{ region_buffer.data(), region_buffer.size(), 16U, 16U };
+    REQUIRE(kra_imp_read_layer_data_region(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, -2147483647 - 1,
+                                           2147483647, &region) == KRA_IMP_SUCCESS);
+    REQUIRE(region_buffer == std::vector<char>(16 * 16 * 4, 7));
+}
+
+TEST_CASE("kra_imp_read_layer_data_region null params", "[layer_data_region]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::vector<char> region_buffer(16 * 16 * 4);
+    kra_imp_canvas_t region{ region_buffer.data(), region_buffer.size(), 16U, 16U };
+    const char* layer_data = reinterpret_cast<const char*>(VALID_LAYER_DATA.data());
+    REQUIRE(kra_imp_read_layer_data_region(nullptr, VALID_LAYER_DATA.size(), &layer_data_header, 0, 0, &region) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_region(layer_data, VALID_LAYER_DATA.size(), nullptr, 0, 0, &region) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_region(layer_data, VALID_LAYER_DATA.size(), &layer_data_header, 0, 0, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_indexed_layer_data_region(nullptr, 2U, &layer_data_header, 0, 0, &region) == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_sparse_canvas success", "[sparse_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    kra_imp_sparse_canvas_t* sparse_canvas = kra_imp_open_sparse_canvas(&layer_data_header);
+    REQUIRE(sparse_canvas != nullptr);
+    REQUIRE(kra_imp_read_layer_data_to_sparse_canvas(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header,
+                                                     sparse_canvas) == KRA_IMP_SUCCESS);
+    REQUIRE(kra_imp_get_sparse_canvas_tiles_count(sparse_canvas) == 2U);
+
+    std::vector<char> canvas_buffer(192 * 128 * 4, 7);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 192U, 128U };
+    REQUIRE(kra_imp_export_sparse_canvas(sparse_canvas, 0, 0, &canvas) == KRA_IMP_SUCCESS);
+    REQUIRE(canvas_buffer == read_expected_canvas(192U, 128U));
+
+    kra_imp_sparse_canvas_tile_t tile{};
+    REQUIRE(kra_imp_get_sparse_canvas_tile(sparse_canvas, 1U, &tile) == KRA_IMP_SUCCESS);
+    REQUIRE(tile._data_size == 64U * 64U * 4U);
+    REQUIRE(std::memcmp(tile._data, canvas_buffer.data() + (tile._y_offset * 192 + tile._x_offset) * 4, 64 * 4) == 0);
+    REQUIRE(kra_imp_get_sparse_canvas_tile(sparse_canvas, 2U, &tile) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_sparse_canvas(sparse_canvas);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data_to_sparse_canvas unaligned tile", "[sparse_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    REQUIRE(kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size()) == KRA_IMP_SUCCESS);
+    tiles[1]._x_offset = -10;
+    tiles[1]._y_offset = -20;
+    kra_imp_sparse_canvas_t* sparse_canvas = kra_imp_open_sparse_canvas(&layer_data_header);
+    REQUIRE(kra_imp_read_indexed_layer_data_to_sparse_canvas(&tiles[1], &layer_data_header, sparse_canvas) == KRA_IMP_SUCCESS);
+    REQUIRE(kra_imp_get_sparse_canvas_tiles_count(sparse_canvas) == 4U);
+
+    std::vector<char> expected_buffer(128 * 128 * 4);
+    kra_imp_canvas_t expected_region{ expected_buffer.data(), expected_buffer.size(), 128U, 128U };
+    REQUIRE(kra_imp_read_indexed_layer_data_region(&tiles[1], 1U, &layer_data_header, -64, -64, &expected_region) == KRA_IMP_SUCCESS);
+    std::vector<char> region_buffer(128 * 128 * 4, 7);
+    kra_imp_canvas_t region{ region_buffer.data(), region_buffer.size(), 128U, 128U };
+    REQUIRE(kra_imp_export_sparse_canvas(sparse_canvas, -64, -64, &region) == KRA_IMP_SUCCESS);
+    REQUIRE(region_buffer == expected_buffer);
+    kra_imp_close_sparse_canvas(sparse_canvas);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data_to_sparse_canvas far apart tiles", "[sparse_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    REQUIRE(kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size()) == KRA_IMP_SUCCESS);
+    tiles[1]._x_offset = 19968;
+    tiles[1]._y_offset = 19968;
+    kra_imp_sparse_canvas_t* sparse_canvas = kra_imp_open_sparse_canvas(&layer_data_header);
+    for (const kra_imp_layer_data_tile_t& tile : tiles)
+    {
+        REQUIRE(kra_imp_read_indexed_layer_data_to_sparse_canvas(&tile, &layer_data_header, sparse_canvas) == KRA_IMP_SUCCESS);
+    }
+    REQUIRE(kra_imp_get_sparse_canvas_tiles_count(sparse_canvas) == 2U);
+
+    kra_imp_sparse_canvas_tile_t tile{};
+    REQUIRE(kra_imp_get_sparse_canvas_tile(sparse_canvas, 1U, &tile) == KRA_IMP_SUCCESS);
+    REQUIRE(tile._x_offset == 19968);
+    REQUIRE(tile._y_offset == 19968);
+    kra_imp_close_sparse_canvas(sparse_canvas);
+}
+
+TEST_CASE("kra_imp_read_layer_data_to_sparse_canvas invalid params", "[sparse_canvas]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    const kra_imp_layer_data_header_t smaller_tiles_header{ 0U, 2U, 4U, 32U, 32U, 2U };
+    const kra_imp_layer_data_header_t unsupported_header{ 0U, 2U, 8U, 64U, 64U, 2U };
+    REQUIRE(kra_imp_open_sparse_canvas(nullptr) == nullptr);
+    REQUIRE(kra_imp_open_sparse_canvas(&unsupported_header) == nullptr);
+
+    kra_imp_sparse_canvas_t* sparse_canvas = kra_imp_open_sparse_canvas(&smaller_tiles_header);
+    REQUIRE(sparse_canvas != nullptr);
+    const char* layer_data = reinterpret_cast<const char*>(VALID_LAYER_DATA.data());
+    REQUIRE(kra_imp_read_layer_data_to_sparse_canvas(layer_data, VALID_LAYER_DATA.size(), &layer_data_header, sparse_canvas) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_to_sparse_canvas(nullptr, VALID_LAYER_DATA.size(), &smaller_tiles_header, sparse_canvas) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_read_layer_data_to_sparse_canvas(layer_data, VALID_LAYER_DATA.size(), &smaller_tiles_header, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_export_sparse_canvas(sparse_canvas, 0, 0, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_sparse_canvas_tiles_count(nullptr) == 0U);
+    kra_imp_close_sparse_canvas(sparse_canvas);
+}
+
+constexpr const std::string_view LAYER_DATA_HEADER = "VERSION 2\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 2\n";
+constexpr const unsigned long long VALID_LAYER_DATA_TILES_SIZE = 944ULL;
+
+struct streamed_tiles_t
+{
+    std::vector<std::vector<char>> _tiles;
+    std::vector<std::pair<int, int>> _offsets;
+    unsigned int _tiles_limit{ 2U };
+};
+
+static kra_imp_error_code_e collect_streamed_tile(void* user_data, const kra_imp_layer_data_header_t* layer_data_header, const kra_imp_layer_data_tile_t* tile)
+{
+    streamed_tiles_t& streamed_tiles = *static_cast<streamed_tiles_t*>(user_data);
+    if (streamed_tiles._tiles.size() >= streamed_tiles._tiles_limit)
+    {
+        return KRA_IMP_FAIL;
+    }
+
+    std::vector<char> tile_buffer(layer_data_header->_layer_data_width * layer_data_header->_layer_data_height * layer_data_header->_layer_data_pixel_size);
+    kra_imp_layer_output_data_t output_data{ tile_buffer.data(), tile_buffer.size(), 0, 0 };
+    const kra_imp_error_code_e result = kra_imp_read_indexed_layer_data(tile, &output_data);
+    streamed_tiles._tiles.push_back(std::move(tile_buffer));
+    streamed_tiles._offsets.emplace_back(output_data._x_offset, output_data._y_offset);
+    return result;
+}
+
+static std::vector<char> make_streamed_layer_data()
+{
+    std::vector<char> layer_data(LAYER_DATA_HEADER.begin(), LAYER_DATA_HEADER.end());
+    layer_data.insert(layer_data.end(), VALID_LAYER_DATA.begin(), VALID_LAYER_DATA.begin() + VALID_LAYER_DATA_TILES_SIZE);
+    return layer_data;
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream success for any chunk size", "[layer_data_stream]")
+{
+    const std::vector<char> layer_data = make_streamed_layer_data();
+    for (const unsigned long long chunk_size : { 1ULL, 7ULL, 60ULL, 500ULL, static_cast<unsigned long long>(layer_data.size()) })
+    {
+        streamed_tiles_t streamed_tiles;
+        kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+        REQUIRE(stream != nullptr);
+        for (unsigned long long position = 0ULL; position < layer_data.size(); position += chunk_size)
+        {
+            const unsigned long long size = std::min<unsigned long long>(chunk_size, layer_data.size() - position);
+            REQUIRE(kra_imp_read_layer_data_stream(stream, layer_data.data() + position, size) == KRA_IMP_SUCCESS);
+        }
+        REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_SUCCESS);
+        REQUIRE(streamed_tiles._tiles.size() == 2U);
+        for (unsigned int tile_index = 0U; tile_index < 2U; ++tile_index)
+        {
+            std::vector<char> expected_buffer(64 * 64 * 4);
+            kra_imp_layer_output_data_t expected_output{ expected_buffer.data(), expected_buffer.size(), 0, 0 };
+            REQUIRE(kra_imp_read_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tile_index, &expected_output) ==
+                    KRA_IMP_SUCCESS);
+            REQUIRE(streamed_tiles._offsets[tile_index] == std::make_pair(expected_output._x_offset, expected_output._y_offset));
+            REQUIRE(streamed_tiles._tiles[tile_index] == expected_buffer);
+        }
+    }
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream ignores trailing data", "[layer_data_stream]")
+{
+    std::vector<char> layer_data(LAYER_DATA_HEADER.begin(), LAYER_DATA_HEADER.end());
+    layer_data.insert(layer_data.end(), VALID_LAYER_DATA.begin(), VALID_LAYER_DATA.end());
+    streamed_tiles_t streamed_tiles;
+    kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+    REQUIRE(kra_imp_read_layer_data_stream(stream, layer_data.data(), layer_data.size()) == KRA_IMP_SUCCESS);
+    REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_SUCCESS);
+    REQUIRE(streamed_tiles._tiles.size() == 2U);
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream truncated data", "[layer_data_stream]")
+{
+    const std::vector<char> layer_data = make_streamed_layer_data();
+    streamed_tiles_t streamed_tiles;
+    kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+    REQUIRE(kra_imp_read_layer_data_stream(stream, layer_data.data(), layer_data.size() - 10ULL) == KRA_IMP_SUCCESS);
+    REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_PARSE_ERROR);
+    REQUIRE(streamed_tiles._tiles.size() == 1U);
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream stopped by tile function", "[layer_data_stream]")
+{
+    const std::vector<char> layer_data = make_streamed_layer_data();
+    streamed_tiles_t streamed_tiles;
+    streamed_tiles._tiles_limit = 1U;
+    kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+    REQUIRE(kra_imp_read_layer_data_stream(stream, layer_data.data(), layer_data.size()) == KRA_IMP_FAIL);
+    REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_PARSE_ERROR);
+    REQUIRE(streamed_tiles._tiles.size() == 1U);
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream header split between chunks", "[layer_data_stream]")
+{
+    const std::vector<char> layer_data = make_streamed_layer_data();
+    for (unsigned long long split_position = 1ULL; split_position < LAYER_DATA_HEADER.size(); ++split_position)
+    {
+        // Each chunk is copied into a buffer of its exact size, so reading past a chunk is caught by sanitizers.
+        const std::vector<char> first_chunk(layer_data.begin(), layer_data.begin() + split_position);
+        const std::vector<char> second_chunk(layer_data.begin() + split_position, layer_data.end());
+        streamed_tiles_t streamed_tiles;
+        kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+        REQUIRE(kra_imp_read_layer_data_stream(stream, first_chunk.data(), first_chunk.size()) == KRA_IMP_SUCCESS);
+        REQUIRE(kra_imp_read_layer_data_stream(stream, second_chunk.data(), second_chunk.size()) == KRA_IMP_SUCCESS);
+        REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_SUCCESS);
+        REQUIRE(streamed_tiles._tiles.size() == 2U);
+    }
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream malformed header", "[layer_data_stream]")
+{
+    for (const std::string_view malformed_header : { std::string_view("VERSION abc\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 2\n"),
+                                                     std::string_view("VERSION 2\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 99999999999999999999\n") })
+    {
+        for (const unsigned long long chunk_size : { 1ULL, 7ULL, static_cast<unsigned long long>(malformed_header.size()) })
+        {
+            streamed_tiles_t streamed_tiles;
+            kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+            kra_imp_error_code_e result = KRA_IMP_SUCCESS;
+            for (unsigned long long position = 0ULL; position < malformed_header.size() && result == KRA_IMP_SUCCESS; position += chunk_size)
+            {
+                const std::vector<char> chunk(malformed_header.begin() + position,
+                                              malformed_header.begin() + std::min<unsigned long long>(position + chunk_size, malformed_header.size()));
+                result = kra_imp_read_layer_data_stream(stream, chunk.data(), chunk.size());
+            }
+            REQUIRE(result == KRA_IMP_PARSE_ERROR);
+            REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_PARSE_ERROR);
+            REQUIRE(streamed_tiles._tiles.empty());
+        }
+    }
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream line without end", "[layer_data_stream]")
+{
+    const std::vector<char> missing_line_end(128, 'x');
+    streamed_tiles_t streamed_tiles;
+    kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+    REQUIRE(kra_imp_read_layer_data_stream(stream, missing_line_end.data(), missing_line_end.size()) == KRA_IMP_PARSE_ERROR);
+    REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_stream null params", "[layer_data_stream]")
+{
+    streamed_tiles_t streamed_tiles;
+    REQUIRE(kra_imp_open_layer_data_stream(nullptr, &streamed_tiles) == nullptr);
+    REQUIRE(kra_imp_read_layer_data_stream(nullptr, LAYER_DATA_HEADER.data(), LAYER_DATA_HEADER.size()) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_close_layer_data_stream(nullptr) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_layer_data_stream_t* stream = kra_imp_open_layer_data_stream(collect_streamed_tile, &streamed_tiles);
+    REQUIRE(kra_imp_read_layer_data_stream(stream, nullptr, 10ULL) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_close_layer_data_stream(stream) == KRA_IMP_PARSE_ERROR);
+}
+
+static void append_little_endian(std::vector<char>& buffer, const std::uint32_t value, const unsigned int bytes_count)
+{
+    for (unsigned int byte_index = 0U; byte_index < bytes_count; ++byte_index)
+    {
+        buffer.push_back(static_cast<char>((value >> (byte_index * 8U)) & 0xFFU));
+    }
+}
+
+static std::uint32_t compute_crc32(const std::vector<char>& data)
+{
+    std::uint32_t crc = 0xFFFFFFFFU;
+    for (const char byte : data)
+    {
+        crc ^= static_cast<unsigned char>(byte);
+        for (unsigned int bit = 0U; bit < 8U; ++bit)
+        {
+            crc = (crc >> 1U) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+// Builds a zip archive holding a single stored (uncompressed) file.
+static std::vector<char> make_stored_archive(const std::string_view file_path, const std::vector<char>& content)
+{
+    const std::uint32_t crc = compute_crc32(content);
+    const std::uint32_t content_size = static_cast<std::uint32_t>(content.size());
+    const std::uint32_t name_size = static_cast<std::uint32_t>(file_path.size());
+    std::vector<char> archive;
+    append_little_endian(archive, 0x04034B50U, 4U);
+    append_little_endian(archive, 20U, 2U);
+    append_little_endian(archive, 0U, 4U);
+    append_little_endian(archive, 0x210000U, 4U);
+    append_little_endian(archive, crc, 4U);
+    append_little_endian(archive, content_size, 4U);
+    append_little_endian(archive, content_size, 4U);
+    append_little_endian(archive, name_size, 2U);
+    append_little_endian(archive, 0U, 2U);
+    archive.insert(archive.end(), file_path.begin(), file_path.end());
+    archive.insert(archive.end(), content.begin(), content.end());
+
+    const std::uint32_t central_directory_offset = static_cast<std::uint32_t>(archive.size());
+    append_little_endian(archive, 0x02014B50U, 4U);
+    append_little_endian(archive, 20U, 2U);
+    append_little_endian(archive, 20U, 2U);
+    append_little_endian(archive, 0U, 4U);
+    append_little_endian(archive, 0x210000U, 4U);
+    append_little_endian(archive, crc, 4U);
+    append_little_endian(archive, content_size, 4U);
+    append_little_endian(archive, content_size, 4U);
+    append_little_endian(archive, name_size, 2U);
+    append_little_endian(archive, 0U, 4U);
+    append_little_endian(archive, 0U, 4U);
+    append_little_endian(archive, 0U, 4U);
+    append_little_endian(archive, 0U, 4U);
+    archive.insert(archive.end(), file_path.begin(), file_path.end());
+
+    const std::uint32_t central_directory_size = static_cast<std::uint32_t>(archive.size()) - central_directory_offset;
+    append_little_endian(archive, 0x06054B50U, 4U);
+    append_little_endian(archive, 0U, 4U);
+    append_little_endian(archive, 1U, 2U);
+    append_little_endian(archive, 1U, 2U);
+    append_little_endian(archive, central_directory_size, 4U);
+    append_little_endian(archive, central_directory_offset, 4U);
+    append_little_endian(archive, 0U, 2U);
+    return archive;
+}
+
+constexpr const std::string_view STREAMED_LAYER_FILE_PATH = "image/layers/layer1";
+
+TEST_CASE("kra_imp_stream_layer_data null params", "[layer_data_stream]")
+{
+    const std::vector<char> archive_buffer = make_stored_archive(STREAMED_LAYER_FILE_PATH, make_streamed_layer_data());
+    kra_imp_archive_t* archive = kra_imp_open_archive(archive_buffer.data(), archive_buffer.size());
+    REQUIRE(archive != nullptr);
+    streamed_tiles_t streamed_tiles;
+    REQUIRE(kra_imp_stream_layer_data(nullptr, STREAMED_LAYER_FILE_PATH.data(), collect_streamed_tile, &streamed_tiles) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_stream_layer_data(archive, nullptr, collect_streamed_tile, &streamed_tiles) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_stream_layer_data(archive, STREAMED_LAYER_FILE_PATH.data(), nullptr, &streamed_tiles) == KRA_IMP_PARAMS_ERROR);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_stream_layer_data all tiles", "[layer_data_stream]")
+{
+    const std::vector<char> archive_buffer = make_stored_archive(STREAMED_LAYER_FILE_PATH, make_streamed_layer_data());
+    kra_imp_archive_t* archive = kra_imp_open_archive(archive_buffer.data(), archive_buffer.size());
+    REQUIRE(archive != nullptr);
+    streamed_tiles_t streamed_tiles;
+    REQUIRE(kra_imp_stream_layer_data(archive, STREAMED_LAYER_FILE_PATH.data(), collect_streamed_tile, &streamed_tiles) == KRA_IMP_SUCCESS);
+    REQUIRE(streamed_tiles._tiles.size() == 2U);
+    for (unsigned int tile_index = 0U; tile_index < 2U; ++tile_index)
+    {
+        std::vector<char> expected_buffer(64 * 64 * 4);
+        kra_imp_layer_output_data_t expected_output{ expected_buffer.data(), expected_buffer.size(), 0, 0 };
+        REQUIRE(kra_imp_read_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tile_index, &expected_output) == KRA_IMP_SUCCESS);
+        REQUIRE(streamed_tiles._offsets[tile_index] == std::make_pair(expected_output._x_offset, expected_output._y_offset));
+        REQUIRE(streamed_tiles._tiles[tile_index] == expected_buffer);
+    }
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_stream_layer_data stopped by tile function", "[layer_data_stream]")
+{
+    const std::vector<char> archive_buffer = make_stored_archive(STREAMED_LAYER_FILE_PATH, make_streamed_layer_data());
+    kra_imp_archive_t* archive = kra_imp_open_archive(archive_buffer.data(), archive_buffer.size());
+    REQUIRE(archive != nullptr);
+    streamed_tiles_t streamed_tiles;
+    streamed_tiles._tiles_limit = 1U;
+    REQUIRE(kra_imp_stream_layer_data(archive, STREAMED_LAYER_FILE_PATH.data(), collect_streamed_tile, &streamed_tiles) == KRA_IMP_FAIL);
+    REQUIRE(streamed_tiles._tiles.size() == 1U);
+    kra_imp_close_archive(archive);
+}
+
+TEST_CASE("kra_imp_stream_layer_data truncated data", "[layer_data_stream]")
+{
+    std::vector<char> layer_data = make_streamed_layer_data();
+    layer_data.resize(layer_data.size() - 10U);
+    const std::vector<char> archive_buffer = make_stored_archive(STREAMED_LAYER_FILE_PATH, layer_data);
+    kra_imp_archive_t* archive = kra_imp_open_archive(archive_buffer.data(), archive_buffer.size());
+    REQUIRE(archive != nullptr);
+    streamed_tiles_t streamed_tiles;
+    REQUIRE(kra_imp_stream_layer_data(archive, STREAMED_LAYER_FILE_PATH.data(), collect_streamed_tile, &streamed_tiles) == KRA_IMP_PARSE_ERROR);
+    REQUIRE(streamed_tiles._tiles.size() == 1U);
+    kra_imp_close_archive(archive);
+}
+
+struct lzf_stream_t
+{
+    std::vector<char> _compressed;
+    std::vector<char> _decompressed;
+};
+
+static void append_lzf_literal_run(lzf_stream_t& stream, const unsigned int length, const unsigned int seed)
+{
+    stream._compressed.push_back(static_cast<char>(length - 1U));
+    for (unsigned int index = 0U; index < length; ++index)
+    {
+        const char value = static_cast<char>((seed * 31U + index * 7U) & 0xFFU);
+        stream._compressed.push_back(value);
+        stream._decompressed.push_back(value);
+    }
+}
+
+static void append_lzf_back_reference(lzf_stream_t& stream, const unsigned int length, const unsigned int distance)
+{
+    const unsigned int encoded_length = length - 2U;
+    const unsigned int encoded_distance = distance - 1U;
+    if (encoded_length < 7U)
+    {
+        stream._compressed.push_back(static_cast<char>((encoded_length << 5U) | (encoded_distance >> 8U)));
+    }
+    else
+    {
+        stream._compressed.push_back(static_cast<char>((7U << 5U) | (encoded_distance >> 8U)));
+        stream._compressed.push_back(static_cast<char>(encoded_length - 7U));
+    }
+    stream._compressed.push_back(static_cast<char>(encoded_distance & 0xFFU));
+    for (unsigned int index = 0U; index < length; ++index)
+    {
+        stream._decompressed.push_back(stream._decompressed[stream._decompressed.size() - distance]);
+    }
+}
+
+static lzf_stream_t make_lzf_tile_stream(const unsigned long long tile_size)
+{
+    static constexpr unsigned int MAX_LENGTH{ 264U };
+    lzf_stream_t stream;
+    append_lzf_literal_run(stream, 32U, 0U);
+    for (unsigned int step = 0U; stream._decompressed.size() < tile_size; ++step)
+    {
+        const unsigned long long left = tile_size - stream._decompressed.size();
+        if (step % 3U == 0U)
+        {
+            append_lzf_literal_run(stream, static_cast<unsigned int>(std::min<unsigned long long>(step % 32U + 1U, left)), step);
+            continue;
+        }
+
+        const unsigned int length = static_cast<unsigned int>(std::min<unsigned long long>(step * 13U % (MAX_LENGTH - 2U) + 3U, left));
+        if (length < 3U)
+        {
+            append_lzf_literal_run(stream, length, step);
+            continue;
+        }
+        const unsigned int distance = static_cast<unsigned int>(std::min<unsigned long long>(step % 40U + 1U, stream._decompressed.size()));
+        append_lzf_back_reference(stream, length, distance);
+    }
+    return stream;
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data lzf literal runs and back-references", "[read_layer_data]")
+{
+    const unsigned long long tile_size = 64ULL * 64ULL * 4ULL;
+    const lzf_stream_t stream = make_lzf_tile_stream(tile_size);
+    REQUIRE(stream._decompressed.size() == tile_size);
+    const kra_imp_layer_data_tile_t tile{ stream._compressed.data(), static_cast<unsigned int>(stream._compressed.size()), 0, 0, KRA_IMP_LZF_COMPRESSED_TILE };
+    std::vector<char> output_buffer(tile_size);
+    kra_imp_layer_output_data_t output_data{ output_buffer.data(), output_buffer.size(), 0, 0 };
+    REQUIRE(kra_imp_read_indexed_layer_data(&tile, &output_data) == KRA_IMP_SUCCESS);
+    REQUIRE(output_buffer == stream._decompressed);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data_to_canvas lzf matches exact decode", "[read_layer_data]")
+{
+    const unsigned long long tile_size = 64ULL * 64ULL * 4ULL;
+    const lzf_stream_t stream = make_lzf_tile_stream(tile_size);
+    const kra_imp_layer_data_tile_t tile{ stream._compressed.data(), static_cast<unsigned int>(stream._compressed.size()), 0, 0, KRA_IMP_LZF_COMPRESSED_TILE };
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, 4U, 64U, 64U, 2U };
+    std::vector<char> canvas_buffer(tile_size);
+    kra_imp_canvas_t canvas{ canvas_buffer.data(), canvas_buffer.size(), 64U, 64U };
+    REQUIRE(kra_imp_read_indexed_layer_data_to_canvas(&tile, &layer_data_header, &canvas) == KRA_IMP_SUCCESS);
+    std::vector<char> expected_buffer(tile_size);
+    REQUIRE(kra_imp_delinearize_to_bgra(stream._decompressed.data(), expected_buffer.data(), expected_buffer.size(), 64U) == KRA_IMP_SUCCESS);
+    REQUIRE(canvas_buffer == expected_buffer);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data lzf back-reference before output", "[read_layer_data]")
+{
+    lzf_stream_t stream;
+    append_lzf_literal_run(stream, 4U, 0U);
+    append_lzf_back_reference(stream, 8U, 4U);
+    stream._compressed.back() = static_cast<char>(9);
+    std::vector<char> output_buffer(12U);
+    const kra_imp_layer_data_tile_t tile{ stream._compressed.data(), static_cast<unsigned int>(stream._compressed.size()), 0, 0, KRA_IMP_LZF_COMPRESSED_TILE };
+    kra_imp_layer_output_data_t output_data{ output_buffer.data(), output_buffer.size(), 0, 0 };
+    REQUIRE(kra_imp_read_indexed_layer_data(&tile, &output_data) == KRA_IMP_DECOMPRESS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data lzf truncated literal run", "[read_layer_data]")
+{
+    lzf_stream_t stream;
+    append_lzf_literal_run(stream, 16U, 0U);
+    stream._compressed.resize(8U);
+    std::vector<char> output_buffer(16U);
+    const kra_imp_layer_data_tile_t tile{ stream._compressed.data(), static_cast<unsigned int>(stream._compressed.size()), 0, 0, KRA_IMP_LZF_COMPRESSED_TILE };
+    kra_imp_layer_output_data_t output_data{ output_buffer.data(), output_buffer.size(), 0, 0 };
+    REQUIRE(kra_imp_read_indexed_layer_data(&tile, &output_data) == KRA_IMP_DECOMPRESS_ERROR);
+}
+
+TEST_CASE("kra_imp_read_indexed_layer_data lzf stream shorter than output", "[read_layer_data]")
+{
+    lzf_stream_t stream;
+    append_lzf_literal_run(stream, 4U, 0U);
+    append_lzf_back_reference(stream, 8U, 4U);
+    std::vector<char> output_buffer(16U);
+    const kra_imp_layer_data_tile_t tile{ stream._compressed.data(), static_cast<unsigned int>(stream._compressed.size()), 0, 0, KRA_IMP_LZF_COMPRESSED_TILE };
+    kra_imp_layer_output_data_t output_data{ output_buffer.data(), output_buffer.size(), 0, 0 };
+    REQUIRE(kra_imp_read_indexed_layer_data(&tile, &output_data) == KRA_IMP_DECOMPRESS_ERROR);
+}
+
+TEST_CASE("kra_imp_get_uncompressed_tile_data points into layer data", "[read_layer_data]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, 4U, 2U, 2U, 2U };
+    const std::string_view tile_line = "64,0,LZF,17\n";
+    std::vector<char> layer_data(tile_line.begin(), tile_line.end());
+    layer_data.push_back(0);
+    for (char pixel = 0; pixel < 16; ++pixel)
+    {
+        layer_data.push_back(pixel);
+    }
+
+    kra_imp_layer_data_tile_t tile{};
+    REQUIRE(kra_imp_index_layer_data(layer_data.data(), layer_data.size(), &tile, 1U) == KRA_IMP_SUCCESS);
+    const char* tile_data{ nullptr };
+    unsigned long long tile_data_size{ 0ULL };
+    REQUIRE(kra_imp_get_uncompressed_tile_data(&tile, &layer_data_header, &tile_data, &tile_data_size) == KRA_IMP_SUCCESS);
+    REQUIRE(tile_data == layer_data.data() + tile_line.size() + 1U);
+    REQUIRE(tile_data_size == 16ULL);
+    REQUIRE(tile._x_offset == 64);
+}
+
+TEST_CASE("kra_imp_get_uncompressed_tile_data compressed tile", "[read_layer_data]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    std::array<kra_imp_layer_data_tile_t, 2> tiles{};
+    REQUIRE(kra_imp_index_layer_data(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), tiles.data(), tiles.size()) == KRA_IMP_SUCCESS);
+    const char* tile_data{ nullptr };
+    unsigned long long tile_data_size{ 0ULL };
+    REQUIRE(kra_imp_get_uncompressed_tile_data(&tiles[0], &layer_data_header, &tile_data, &tile_data_size) == KRA_IMP_FAIL);
+    REQUIRE(tile_data == nullptr);
+}
+
+TEST_CASE("kra_imp_get_uncompressed_tile_data too short payload", "[read_layer_data]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, 4U, 64U, 64U, 2U };
+    const std::array<char, 8> payload{};
+    const kra_imp_layer_data_tile_t tile{ payload.data(), static_cast<unsigned int>(payload.size()), 0, 0, KRA_IMP_UNCOMPRESSED_TILE };
+    const char* tile_data{ nullptr };
+    unsigned long long tile_data_size{ 0ULL };
+    REQUIRE(kra_imp_get_uncompressed_tile_data(&tile, &layer_data_header, &tile_data, &tile_data_size) == KRA_IMP_DECOMPRESS_ERROR);
+    REQUIRE(kra_imp_get_uncompressed_tile_data(nullptr, &layer_data_header, &tile_data, &tile_data_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_uncompressed_tile_data(&tile, nullptr, &tile_data, &tile_data_size) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_uncompressed_tile_data(&tile, &layer_data_header, nullptr, &tile_data_size) == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_index_layer_data tile lines of varying length", "[read_layer_data]")
+{
+    static constexpr std::array<std::pair<int, int>, 4> TILE_OFFSETS{ { { 0, 0 }, { -64, 128 }, { 1234567, -7654321 }, { 64, 2147483584 } } };
+    std::vector<char> layer_data;
+    for (const auto& [x_offset, y_offset] : TILE_OFFSETS)
+    {
+        const std::string tile_line = std::to_string(x_offset) + "," + std::to_string(y_offset) + ",LZF,5\n";
+        layer_data.insert(layer_data.end(), tile_line.begin(), tile_line.end());
+        layer_data.insert(layer_data.end(), { 0, 1, 2, 3, 4 });
+    }
+
+    std::array<kra_imp_layer_data_tile_t, TILE_OFFSETS.size()> tiles{};
+    REQUIRE(kra_imp_index_layer_data(layer_data.data(), layer_data.size(), tiles.data(), tiles.size()) == KRA_IMP_SUCCESS);
+    for (std::size_t tile_index = 0U; tile_index < tiles.size(); ++tile_index)
+    {
+        REQUIRE(tiles[tile_index]._x_offset == TILE_OFFSETS[tile_index].first);
+        REQUIRE(tiles[tile_index]._y_offset == TILE_OFFSETS[tile_index].second);
+        REQUIRE(tiles[tile_index]._compression == KRA_IMP_UNCOMPRESSED_TILE);
+        REQUIRE(tiles[tile_index]._data_size == 4U);
+    }
+}
+
+TEST_CASE("kra_imp_index_layer_data missing tile field", "[read_layer_data]")
+{
+    const std::string_view layer_data = "64,0,5\nabcde";
+    kra_imp_layer_data_tile_t tile{};
+    REQUIRE(kra_imp_index_layer_data(layer_data.data(), layer_data.size(), &tile, 1U) == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_index_layer_data unknown compression flag", "[read_layer_data]")
+{
+    const std::string_view layer_data{ "64,0,LZF,5\n\x02"
+                                       "abcd",
+                                       16 };
+    kra_imp_layer_data_tile_t tile{};
+    REQUIRE(kra_imp_index_layer_data(layer_data.data(), layer_data.size(), &tile, 1U) == KRA_IMP_PARSE_ERROR);
+}
+
+static std::vector<char> make_large_layer_data(const unsigned int tiles_count)
+{
+    // Every payload embeds a chain of fake tile lines, so chunks may resynchronize on a wrong position.
+    static constexpr std::string_view FAKE_TILE_LINES{ "0,0,LZF,2\n\0a1,1,LZF,2\n\0b2,2,LZF,2\n\0c3,3,LZF,2\n\0d", 48 };
+    static constexpr unsigned int TILE_PAYLOAD_SIZE{ 64U * 64U * 4U };
+    std::vector<char> layer_data;
+    for (unsigned int tile_index = 0U; tile_index < tiles_count; ++tile_index)
+    {
+        const std::string tile_line = std::to_string(tile_index * 64U) + "," + std::to_string(tile_index % 7U * 64U) + ",LZF," + std::to_string(TILE_PAYLOAD_SIZE + 1U) + "\n";
+        layer_data.insert(layer_data.end(), tile_line.begin(), tile_line.end());
+        layer_data.push_back(0);
+        for (unsigned int payload_size = 0U; payload_size < TILE_PAYLOAD_SIZE; payload_size += static_cast<unsigned int>(FAKE_TILE_LINES.size()))
+        {
+            const std::size_t copied_size = std::min<std::size_t>(FAKE_TILE_LINES.size(), TILE_PAYLOAD_SIZE - payload_size);
+            layer_data.insert(layer_data.end(), FAKE_TILE_LINES.begin(), FAKE_TILE_LINES.begin() + copied_size);
+        }
+    }
+    return layer_data;
+}
+
+TEST_CASE("kra_imp_index_layer_data_parallel matches kra_imp_index_layer_data", "[index_layer_data]")
+{
+    static constexpr unsigned int TILES_COUNT{ 160U };
+    const std::vector<char> layer_data = make_large_layer_data(TILES_COUNT);
+    std::vector<kra_imp_layer_data_tile_t> expected_tiles(TILES_COUNT);
+    REQUIRE(kra_imp_index_layer_data(layer_data.data(), layer_data.size(), expected_tiles.data(), TILES_COUNT) == KRA_IMP_SUCCESS);
+
+    for (const unsigned int workers_count : { 1U, 2U, 4U, 0x40000001U, 0xFFFFFFFFU })
+    {
+        deferred_executor_t deferred_executor;
+        const kra_imp_executor_t executor{ deferred_submit, deferred_wait, &deferred_executor, workers_count };
+        std::vector<kra_imp_layer_data_tile_t> tiles(TILES_COUNT);
+        REQUIRE(kra_imp_index_layer_data_parallel(layer_data.data(), layer_data.size(), tiles.data(), TILES_COUNT, &executor) == KRA_IMP_SUCCESS);
+        for (unsigned int tile_index = 0U; tile_index < TILES_COUNT; ++tile_index)
+        {
+            REQUIRE(tiles[tile_index]._data == expected_tiles[tile_index]._data);
+            REQUIRE(tiles[tile_index]._data_size == expected_tiles[tile_index]._data_size);
+            REQUIRE(tiles[tile_index]._x_offset == expected_tiles[tile_index]._x_offset);
+            REQUIRE(tiles[tile_index]._y_offset == expected_tiles[tile_index]._y_offset);
+            REQUIRE(tiles[tile_index]._compression == expected_tiles[tile_index]._compression);
+        }
+    }
+}
+
+TEST_CASE("kra_imp_index_layer_data_parallel too many tiles", "[index_layer_data]")
+{
+    static constexpr unsigned int TILES_COUNT{ 160U };
+    const std::vector<char> layer_data = make_large_layer_data(TILES_COUNT);
+    deferred_executor_t deferred_executor;
+    const kra_imp_executor_t executor{ deferred_submit, deferred_wait, &deferred_executor, 4U };
+    std::vector<kra_imp_layer_data_tile_t> tiles(TILES_COUNT + 1U);
+    REQUIRE(kra_imp_index_layer_data_parallel(layer_data.data(), layer_data.size(), tiles.data(), TILES_COUNT + 1U, &executor) == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_index_layer_data_parallel truncated layer data", "[index_layer_data]")
+{
+    static constexpr unsigned int TILES_COUNT{ 160U };
+    const std::vector<char> layer_data = make_large_layer_data(TILES_COUNT);
+    deferred_executor_t deferred_executor;
+    const kra_imp_executor_t executor{ deferred_submit, deferred_wait, &deferred_executor, 4U };
+    std::vector<kra_imp_layer_data_tile_t> tiles(TILES_COUNT);
+    REQUIRE(kra_imp_index_layer_data_parallel(layer_data.data(), layer_data.size() - 1U, tiles.data(), TILES_COUNT, &executor) == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_index_layer_data_parallel null params", "[index_layer_data]")
+{
+    deferred_executor_t deferred_executor;
+    const kra_imp_executor_t executor{ deferred_submit, deferred_wait, &deferred_executor, 4U };
+    kra_imp_layer_data_tile_t tile{};
+    const char* layer_data = reinterpret_cast<const char*>(VALID_LAYER_DATA.data());
+    REQUIRE(kra_imp_index_layer_data_parallel(nullptr, VALID_LAYER_DATA.size(), &tile, 1U, &executor) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_index_layer_data_parallel(layer_data, VALID_LAYER_DATA.size(), nullptr, 1U, &executor) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_index_layer_data_parallel(layer_data, VALID_LAYER_DATA.size(), &tile, 1U, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_index_layer_data_parallel(layer_data, VALID_LAYER_DATA.size(), &tile, 1U, &executor) == KRA_IMP_SUCCESS);
+}
+
+TEST_CASE("kra_imp_get_layer_data_bounds success", "[layer_data_bounds]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    kra_imp_layer_data_bounds_t bounds{};
+    REQUIRE(kra_imp_get_layer_data_bounds(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &bounds) ==
+            KRA_IMP_SUCCESS);
+    REQUIRE(bounds._x_offset == 128);
+    REQUIRE(bounds._y_offset == 0);
+    REQUIRE(bounds._width == 64U);
+    REQUIRE(bounds._height == 128U);
+    REQUIRE(bounds._columns == 1U);
+    REQUIRE(bounds._rows == 2U);
+
+    std::array<unsigned char, 1> occupancy{};
+    REQUIRE(kra_imp_get_layer_data_occupancy(reinterpret_cast<const char*>(VALID_LAYER_DATA.data()), VALID_LAYER_DATA.size(), &layer_data_header, &bounds,
+                                             occupancy.data(), occupancy.size()) == KRA_IMP_SUCCESS);
+    REQUIRE(occupancy[0] == 0x03U);
+}
+
+TEST_CASE("kra_imp_get_layer_data_bounds does not decompress tiles", "[layer_data_bounds]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 1U, 4U, 64U, 64U, 2U };
+    kra_imp_layer_data_bounds_t bounds{};
+    REQUIRE(kra_imp_get_layer_data_bounds(reinterpret_cast<const char*>(INVALID_COMPRESSED_LAYER_DATA.data()), INVALID_COMPRESSED_LAYER_DATA.size(), &layer_data_header,
+                                          &bounds) == KRA_IMP_SUCCESS);
+    REQUIRE(bounds._x_offset == 128);
+    REQUIRE(bounds._columns * bounds._rows == 1U);
+}
+
+TEST_CASE("kra_imp_get_layer_data_occupancy unaligned and negative tiles", "[layer_data_bounds]")
+{
+    static constexpr std::array<std::pair<int, int>, 3> TILE_OFFSETS{ { { -64, 128 }, { 0, 0 }, { 96, 0 } } };
+    std::vector<char> layer_data;
+    for (const auto& [x_offset, y_offset] : TILE_OFFSETS)
+    {
+        const std::string tile_line = std::to_string(x_offset) + "," + std::to_string(y_offset) + ",LZF,5\n";
+        layer_data.insert(layer_data.end(), tile_line.begin(), tile_line.end());
+        layer_data.insert(layer_data.end(), { 1, 2, 3, 4, 5 });
+    }
+
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, TILE_OFFSETS.size(), 4U, 64U, 64U, 2U };
+    kra_imp_layer_data_bounds_t bounds{};
+    REQUIRE(kra_imp_get_layer_data_bounds(layer_data.data(), layer_data.size(), &layer_data_header, &bounds) == KRA_IMP_SUCCESS);
+    REQUIRE(bounds._x_offset == -64);
+    REQUIRE(bounds._y_offset == 0);
+    REQUIRE(bounds._width == 224U);
+    REQUIRE(bounds._height == 192U);
+    REQUIRE(bounds._columns == 4U);
+    REQUIRE(bounds._rows == 3U);
+
+    // Rows of 4 cells: the tile at x 96 covers cells 2 and 3 of row 0, the tile at y 128 covers cell 0 of row 2.
+    std::array<unsigned char, 2> occupancy{ 0xFFU, 0xFFU };
+    REQUIRE(kra_imp_get_layer_data_occupancy(layer_data.data(), layer_data.size(), &layer_data_header, &bounds, occupancy.data(), occupancy.size()) == KRA_IMP_SUCCESS);
+    REQUIRE(occupancy[0] == 0x0EU);
+    REQUIRE(occupancy[1] == 0x01U);
+    REQUIRE(kra_imp_get_layer_data_occupancy(layer_data.data(), layer_data.size(), &layer_data_header, &bounds, occupancy.data(), 1U) == KRA_IMP_PARAMS_ERROR);
+}
+
+TEST_CASE("kra_imp_get_layer_data_bounds invalid params", "[layer_data_bounds]")
+{
+    const kra_imp_layer_data_header_t layer_data_header{ 0U, 2U, 4U, 64U, 64U, 2U };
+    const kra_imp_layer_data_header_t too_many_tiles_header{ 0U, 3U, 4U, 64U, 64U, 2U };
+    const char* layer_data = reinterpret_cast<const char*>(VALID_LAYER_DATA.data());
+    kra_imp_layer_data_bounds_t bounds{};
+    REQUIRE(kra_imp_get_layer_data_bounds(nullptr, VALID_LAYER_DATA.size(), &layer_data_header, &bounds) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_layer_data_bounds(layer_data, VALID_LAYER_DATA.size(), nullptr, &bounds) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_layer_data_bounds(layer_data, VALID_LAYER_DATA.size(), &layer_data_header, nullptr) == KRA_IMP_PARAMS_ERROR);
+    REQUIRE(kra_imp_get_layer_data_bounds(layer_data, VALID_LAYER_DATA.size(), &too_many_tiles_header, &bounds) == KRA_IMP_PARSE_ERROR);
+    REQUIRE(kra_imp_get_layer_data_occupancy(layer_data, VALID_LAYER_DATA.size(), &layer_data_header, nullptr, nullptr, 0ULL) == KRA_IMP_PARAMS_ERROR);
+}
@@ -7,6 +7,7 @@
 #include <array>
 #include <catch2/catch_test_macros.hpp>
 #include <kra_imp/kra_imp.hpp>
+#include <vector>
 
 constexpr const std::string_view EMPTY_LAYER_DATA = "";
 constexpr const std::string_view ONLY_HEADER_LAYER_DATA = "VERSION 2\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 0\n";
@@ -16,6 +17,8 @@ constexpr const std::string_view MISSPELLED_LAYER_DATA = "VERSION 2\nTILEWIDTH 6
 constexpr const std::string_view LOWERCASE_LAYER_DATA = "version 2\ntilewidth 64\ntileheight 64\npiexlsize 4\ndata 0\n";
 constexpr const std::string_view MISSING_VERSION_HEADER_LAYER_DATA = "TILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 0\n";
 constexpr const std::string_view INVALID_VALUE_LAYER_DATA = "VERSION 2.2\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 0\n";
+constexpr const std::string_view NOT_A_NUMBER_LAYER_DATA = "VERSION abc\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 0\n";
+constexpr const std::string_view OVERFLOWING_VALUE_LAYER_DATA = "VERSION 2\nTILEWIDTH 64\nTILEHEIGHT 64\nPIXELSIZE 4\nDATA 99999999999999999999\n";
 
 TEST_CASE("kra_imp_read_layer_data_header success", "[layer_data_header]")
 {
@@ -98,3 +101,30 @@ TEST_CASE("kra_imp_read_layer_data_header invalid buffer (invalid value)", "[lay
     const kra_imp_error_code_e result = kra_imp_read_layer_data_header(INVALID_VALUE_LAYER_DATA.data(), INVALID_VALUE_LAYER_DATA.size(), &layer_data_header);
     REQUIRE(result == KRA_IMP_PARSE_ERROR);
 }
+
+TEST_CASE("kra_imp_read_layer_data_header invalid buffer (not a number)", "[layer_data_header]")
+{
+    kra_imp_layer_data_header_t layer_data_header;
+    const kra_imp_error_code_e result = kra_imp_read_layer_data_header(NOT_A_NUMBER_LAYER_DATA.data(), NOT_A_NUMBER_LAYER_DATA.size(), &layer_data_header);
+    REQUIRE(result == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_header invalid buffer (overflowing value)", "[layer_data_header]")
+{
+    kra_imp_layer_data_header_t layer_data_header;
+    const kra_imp_error_code_e result = kra_imp_read_layer_data_header(OVERFLOWING_VALUE_LAYER_DATA.data(), OVERFLOWING_VALUE_LAYER_DATA.size(), &layer_data_header);
+    REQUIRE(result == KRA_IMP_PARSE_ERROR);
+}
+
+TEST_CASE("kra_imp_read_layer_data_header buffer without null terminator", "[layer_data_header]")
+{
+    // Values are parsed within the buffer, so a header ending right at the end of an allocation is not over-read.
+    const std::vector<char> buffer(ONLY_HEADER_LAYER_DATA.begin(), ONLY_HEADER_LAYER_DATA.end());
+    kra_imp_layer_data_header_t layer_data_header;
+    REQUIRE(kra_imp_read_layer_data_header(buffer.data(), buffer.size(), &layer_data_header) == KRA_IMP_SUCCESS);
+    REQUIRE(layer_data_header._layer_data_pixel_size == 4U);
+    REQUIRE(layer_data_header._layer_datas_count == 0U);
+
+    const std::vector<char> missing_eol_buffer(MISSING_EOL_LAYER_DATA.begin(), MISSING_EOL_LAYER_DATA.end());
+    REQUIRE(kra_imp_read_layer_data_header(missing_eol_buffer.data(), missing_eol_buffer.size(), &layer_data_header) == KRA_IMP_PARSE_ERROR);
+}